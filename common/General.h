@@ -150,6 +150,19 @@ namespace HostSys
 	extern void* MapSharedMemory(void* handle, size_t offset, void* baseaddr, size_t size, const PageProtectionMode& mode);
 	extern void UnmapSharedMemory(void* baseaddr, size_t size);
 
+	/// Maps a whole file into memory, read-only. Returns NULL on failure, or if the file is empty.
+	/// The mapping doesn't keep the file open, and must be released with UnmapFile().
+	extern void* MapFile(const char* path, size_t* size);
+	extern void UnmapFile(void* baseaddr, size_t size);
+
+	/// Asks for the region to be backed by huge pages as it's faulted in, to cut down on TLB misses.
+	/// Returns false if the OS doesn't support this. Regions which are later protected or remapped
+	/// in 4KB pieces get split back up, so it's only worth using for ones which aren't.
+	extern bool AdviseHugePages(void* baseaddr, size_t size);
+
+	/// Returns how many bytes of the region are currently mapped with huge pages, or 0 if unknown.
+	extern size_t GetHugePageMappedSize(const void* baseaddr, size_t size);
+
 	/// Installs the specified page fault handler. Only one handler can be active at once.
 	bool InstallPageFaultHandler(PageFaultHandler handler);
 
@@ -21,6 +21,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <mutex>
 
 #include "fmt/core.h"
@@ -40,6 +41,7 @@
 #include <cerrno>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #ifndef __APPLE__
@@ -278,6 +280,77 @@ void HostSys::UnmapSharedMemory(void* baseaddr, size_t size)
 		pxFailRel("Failed to unmap shared memory");
 }
 
+void* HostSys::MapFile(const char* path, size_t* size)
+{
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	void* ret = nullptr;
+	struct stat sd;
+	if (fstat(fd, &sd) == 0 && sd.st_size > 0)
+	{
+		ret = mmap(nullptr, static_cast<size_t>(sd.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ret == MAP_FAILED)
+			ret = nullptr;
+		else
+			*size = static_cast<size_t>(sd.st_size);
+	}
+
+	close(fd);
+	return ret;
+}
+
+void HostSys::UnmapFile(void* baseaddr, size_t size)
+{
+	if (!baseaddr)
+		return;
+
+	munmap(baseaddr, size);
+}
+
+bool HostSys::AdviseHugePages(void* baseaddr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+	// This only affects anonymous memory by default. Shared memory (e.g. main memory) is on tmpfs, which ignores
+	// the advice unless it's mounted with huge=within_size/advise, or shmem_enabled is forced in sysfs.
+	return (madvise(baseaddr, size, MADV_HUGEPAGE) == 0);
+#else
+	return false;
+#endif
+}
+
+size_t HostSys::GetHugePageMappedSize(const void* baseaddr, size_t size)
+{
+#ifdef __linux__
+	std::FILE* fp = std::fopen("/proc/self/smaps", "r");
+	if (!fp)
+		return 0;
+
+	const uptr start = reinterpret_cast<uptr>(baseaddr);
+	const uptr end = start + size;
+	bool in_range = false;
+	size_t total = 0;
+
+	char line[512];
+	while (std::fgets(line, sizeof(line), fp))
+	{
+		// Each mapping starts with its address range, followed by its fields.
+		unsigned long long map_start, map_end, kb;
+		if (std::sscanf(line, "%llx-%llx ", &map_start, &map_end) == 2)
+			in_range = (map_start < end && map_end > start);
+		else if (in_range && (std::sscanf(line, "AnonHugePages: %llu kB", &kb) == 1 ||
+								 std::sscanf(line, "ShmemPmdMapped: %llu kB", &kb) == 1))
+			total += static_cast<size_t>(kb) * 1024;
+	}
+
+	std::fclose(fp);
+	return std::min(total, size);
+#else
+	return 0;
+#endif
+}
+
 SharedMemoryMappingArea::SharedMemoryMappingArea(u8* base_ptr, size_t size, size_t num_pages)
 	: m_base_ptr(base_ptr)
 	, m_size(size)
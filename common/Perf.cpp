@@ -18,13 +18,21 @@
 #ifdef __unix__
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <atomic>
+#include <ctime>
+#include <elf.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
 #ifdef ENABLE_VTUNE
 #include "jitprofiling.h"
+#endif
 
 #include <string> // std::string
 #include <cstring> // strncpy
-#include <algorithm> // std::remove_if
-#endif
+#include <algorithm> // std::remove_if, std::find_if
 
 //#define ProfileWithPerf
 #define MERGE_BLOCK_RESULT
@@ -37,15 +45,171 @@
 
 namespace Perf
 {
-	// Warning object aren't thread safe
+	// Each vector guards its own entries, the jitdump file has its own lock.
 	InfoVector any("");
 	InfoVector ee("EE");
 	InfoVector iop("IOP");
-	InfoVector vu("VU");
+	InfoVector vu0("VU0");
+	InfoVector vu1("VU1");
 	InfoVector vif("VIF");
+	InfoVector gs("GS");
 
 // Perf is only supported on linux
-#if defined(__linux__) && (defined(ProfileWithPerf) || defined(ENABLE_VTUNE))
+#ifdef __linux__
+
+	static InfoVector* const s_all_vectors[] = {&any, &ee, &iop, &vu0, &vu1, &vif, &gs};
+
+	////////////////////////////////////////////////////////////////////////////////
+	// jitdump writer, see tools/perf/Documentation/jitdump-specification.txt
+	////////////////////////////////////////////////////////////////////////////////
+
+	enum : u32
+	{
+		JITDUMP_MAGIC = 0x4A695444,
+		JITDUMP_VERSION = 1,
+		JIT_CODE_LOAD = 0,
+	};
+
+	struct JitDumpHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 total_size;
+		u32 elf_mach;
+		u32 pad1;
+		u32 pid;
+		u64 timestamp;
+		u64 flags;
+	};
+
+	struct JitDumpCodeLoad
+	{
+		u32 id;
+		u32 total_size;
+		u64 timestamp;
+		u32 pid;
+		u32 tid;
+		u64 vma;
+		u64 code_addr;
+		u64 code_size;
+		u64 code_index;
+		// Followed by the null terminated name, then the code itself.
+	};
+
+	// Blocks are compiled on the EE, VU and GS threads, so writes are serialized.
+	static std::mutex s_jitdump_mutex;
+	static std::atomic_bool s_jitdump_open{false};
+	static FILE* s_jitdump_fp = nullptr;
+	static void* s_jitdump_marker = nullptr;
+	static u64 s_jitdump_index = 0;
+
+	// Must be the same clock as perf record -k1 (CLOCK_MONOTONIC).
+	static u64 JitDumpTimestamp()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<u64>(ts.tv_sec) * 1000000000ULL + static_cast<u64>(ts.tv_nsec);
+	}
+
+	static void JitDumpCodeLoadLocked(uptr x86, u32 size, const char* name)
+	{
+		const u32 name_size = static_cast<u32>(std::strlen(name) + 1);
+
+		JitDumpCodeLoad rec;
+		rec.id = JIT_CODE_LOAD;
+		rec.total_size = sizeof(rec) + name_size + size;
+		rec.timestamp = JitDumpTimestamp();
+		rec.pid = static_cast<u32>(getpid());
+		rec.tid = static_cast<u32>(syscall(SYS_gettid));
+		rec.vma = x86;
+		rec.code_addr = x86;
+		rec.code_size = size;
+		rec.code_index = s_jitdump_index++;
+
+		std::fwrite(&rec, sizeof(rec), 1, s_jitdump_fp);
+		std::fwrite(name, name_size, 1, s_jitdump_fp);
+		std::fwrite(reinterpret_cast<const void*>(x86), size, 1, s_jitdump_fp);
+
+		// Keep the file usable if we crash, perf inject only runs afterwards anyway.
+		std::fflush(s_jitdump_fp);
+	}
+
+	static void JitDumpCodeLoad(uptr x86, u32 size, const char* name)
+	{
+		if (!s_jitdump_open.load(std::memory_order_relaxed) || size == 0)
+			return;
+
+		std::unique_lock lock(s_jitdump_mutex);
+		if (s_jitdump_fp)
+			JitDumpCodeLoadLocked(x86, size, name);
+	}
+
+	bool OpenJitDump()
+	{
+		std::unique_lock lock(s_jitdump_mutex);
+		if (s_jitdump_fp)
+			return true;
+
+		const char* dir = std::getenv("JITDUMPDIR");
+		char file[256];
+		snprintf(file, sizeof(file), "%s/jit-%d.dump", (dir && dir[0]) ? dir : "/tmp", getpid());
+
+		FILE* fp = std::fopen(file, "w+b");
+		if (!fp)
+			return false;
+
+		JitDumpHeader header = {};
+		header.magic = JITDUMP_MAGIC;
+		header.version = JITDUMP_VERSION;
+		header.total_size = sizeof(header);
+		header.elf_mach = EM_X86_64;
+		header.pid = static_cast<u32>(getpid());
+		header.timestamp = JitDumpTimestamp();
+		if (std::fwrite(&header, sizeof(header), 1, fp) != 1 || std::fflush(fp) != 0)
+		{
+			std::fclose(fp);
+			return false;
+		}
+
+		// perf finds the dump through this mapping, it has to be executable.
+		void* marker = mmap(nullptr, sizeof(header), PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(fp), 0);
+		if (marker == MAP_FAILED)
+		{
+			std::fclose(fp);
+			return false;
+		}
+
+		s_jitdump_fp = fp;
+		s_jitdump_marker = marker;
+		s_jitdump_index = 0;
+
+		// Dispatchers are generated once at startup, so they'd never show up otherwise.
+		for (InfoVector* vec : s_all_vectors)
+			vec->replay();
+
+		s_jitdump_open.store(true, std::memory_order_release);
+		return true;
+	}
+
+	void CloseJitDump()
+	{
+		std::unique_lock lock(s_jitdump_mutex);
+		if (!s_jitdump_fp)
+			return;
+
+		s_jitdump_open.store(false, std::memory_order_release);
+
+		munmap(s_jitdump_marker, sizeof(JitDumpHeader));
+		s_jitdump_marker = nullptr;
+
+		std::fclose(s_jitdump_fp);
+		s_jitdump_fp = nullptr;
+	}
+
+	bool IsJitDumpOpen()
+	{
+		return s_jitdump_open.load(std::memory_order_acquire);
+	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	// Implementation of the Info object
@@ -56,7 +220,7 @@ namespace Perf
 		, m_size(size)
 		, m_dynamic(false)
 	{
-		strncpy(m_symbol, symbol, sizeof(m_symbol));
+		snprintf(m_symbol, sizeof(m_symbol), "%s", symbol);
 	}
 
 	Info::Info(uptr x86, u32 size, const char* symbol, u32 pc)
@@ -67,15 +231,27 @@ namespace Perf
 		snprintf(m_symbol, sizeof(m_symbol), "%s_0x%08x", symbol, pc);
 	}
 
+	Info::Info(uptr x86, u32 size, const char* symbol, u64 key)
+		: m_x86(x86)
+		, m_size(size)
+		, m_dynamic(true)
+	{
+		snprintf(m_symbol, sizeof(m_symbol), "%s_%016llx", symbol, static_cast<unsigned long long>(key));
+	}
+
 	void Info::Print(FILE* fp)
 	{
-		fprintf(fp, "%x %x %s\n", m_x86, m_size, m_symbol);
+		fprintf(fp, "%zx %x %s\n", static_cast<size_t>(m_x86), m_size, m_symbol);
 	}
 
 	////////////////////////////////////////////////////////////////////////////////
 	// Implementation of the InfoVector object
 	////////////////////////////////////////////////////////////////////////////////
 
+	// Static zones bigger than this are whole code reserves, which would hide the blocks
+	// inside them from perf inject.
+	static constexpr u32 JITDUMP_MAX_STATIC_SIZE = 16 * _1kb;
+
 	InfoVector::InfoVector(const char* prefix)
 	{
 		strncpy(m_prefix, prefix, sizeof(m_prefix));
@@ -88,6 +264,7 @@ namespace Perf
 
 	void InfoVector::print(FILE* fp)
 	{
+		std::unique_lock lock(m_mutex);
 		for (auto&& it : m_v)
 			it.Print(fp);
 	}
@@ -104,9 +281,20 @@ namespace Perf
 		u32 max_code_size = _1gb;
 #endif
 
+		if (size < JITDUMP_MAX_STATIC_SIZE)
+			JitDumpCodeLoad(x86, size, symbol);
+
 		if (size < max_code_size)
 		{
-			m_v.emplace_back(x86, size, symbol);
+			{
+				// Dispatchers are regenerated at the same address on every reset (e.g. mVU), replace them rather than growing.
+				std::unique_lock lock(m_mutex);
+				auto it = std::find_if(m_v.begin(), m_v.end(), [x86](const Info& i) { return !i.m_dynamic && i.m_x86 == x86; });
+				if (it != m_v.end())
+					*it = Info(x86, size, symbol);
+				else
+					m_v.emplace_back(x86, size, symbol);
+			}
 
 #ifdef ENABLE_VTUNE
 			std::string name = std::string(symbol);
@@ -129,8 +317,18 @@ namespace Perf
 
 	void InfoVector::map(uptr x86, u32 size, u32 pc)
 	{
+		if (IsJitDumpOpen())
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "%s_0x%08x", m_prefix, pc);
+			JitDumpCodeLoad(x86, size, name);
+		}
+
 #ifndef MERGE_BLOCK_RESULT
-		m_v.emplace_back(x86, size, m_prefix, pc);
+		{
+			std::unique_lock lock(m_mutex);
+			m_v.emplace_back(x86, size, m_prefix, pc);
+		}
 #endif
 
 #ifdef ENABLE_VTUNE
@@ -155,41 +353,74 @@ namespace Perf
 #endif
 	}
 
+	void InfoVector::map(uptr x86, u32 size, const char* symbol, u64 key)
+	{
+		if (IsJitDumpOpen())
+		{
+			char name[96];
+			snprintf(name, sizeof(name), "%s_%s_%016llx", m_prefix, symbol, static_cast<unsigned long long>(key));
+			JitDumpCodeLoad(x86, size, name);
+		}
+
+#ifndef MERGE_BLOCK_RESULT
+		std::unique_lock lock(m_mutex);
+		m_v.emplace_back(x86, size, symbol, key);
+#endif
+	}
+
 	void InfoVector::reset()
 	{
+		std::unique_lock lock(m_mutex);
 		auto dynamic = std::remove_if(m_v.begin(), m_v.end(), [](Info i) { return i.m_dynamic; });
 		m_v.erase(dynamic, m_v.end());
 	}
 
+	void InfoVector::replay()
+	{
+		// Called with s_jitdump_mutex held, map() never holds m_mutex while taking that one.
+		std::unique_lock lock(m_mutex);
+		for (const Info& it : m_v)
+		{
+			if (!it.m_dynamic && it.m_size < JITDUMP_MAX_STATIC_SIZE)
+				JitDumpCodeLoadLocked(it.m_x86, it.m_size, it.m_symbol);
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////////
 	// Global function
 	////////////////////////////////////////////////////////////////////////////////
 
+#if defined(ProfileWithPerf) || defined(ENABLE_VTUNE)
+
 	void dump()
 	{
 		char file[256];
 		snprintf(file, 250, "/tmp/perf-%d.map", getpid());
 		FILE* fp = fopen(file, "w");
+		if (!fp)
+			return;
 
-		any.print(fp);
-		ee.print(fp);
-		iop.print(fp);
-		vu.print(fp);
+		for (InfoVector* vec : s_all_vectors)
+			vec->print(fp);
 
-		if (fp)
-			fclose(fp);
+		fclose(fp);
 	}
 
 	void dump_and_reset()
 	{
 		dump();
 
-		any.reset();
-		ee.reset();
-		iop.reset();
-		vu.reset();
+		for (InfoVector* vec : s_all_vectors)
+			vec->reset();
 	}
 
+#else
+
+	void dump() {}
+	void dump_and_reset() {}
+
+#endif
+
 #else
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -202,10 +433,16 @@ namespace Perf
 	}
 	void InfoVector::map(uptr x86, u32 size, const char* symbol) {}
 	void InfoVector::map(uptr x86, u32 size, u32 pc) {}
+	void InfoVector::map(uptr x86, u32 size, const char* symbol, u64 key) {}
 	void InfoVector::reset() {}
+	void InfoVector::replay() {}
 
 	void dump() {}
 	void dump_and_reset() {}
 
+	bool OpenJitDump() { return false; }
+	void CloseJitDump() {}
+	bool IsJitDumpOpen() { return false; }
+
 #endif
 } // namespace Perf
@@ -17,6 +17,7 @@
 
 #include <vector>
 #include <cstdio>
+#include <mutex>
 #include "common/Pcsx2Types.h"
 
 namespace Perf
@@ -33,11 +34,14 @@ namespace Perf
 
 		Info(uptr x86, u32 size, const char* symbol);
 		Info(uptr x86, u32 size, const char* symbol, u32 pc);
+		Info(uptr x86, u32 size, const char* symbol, u64 key);
 		void Print(FILE* fp);
 	};
 
 	class InfoVector
 	{
+		// map() is called from the recompiler threads (EE/IOP, MTVU) while replay() runs on the caller of OpenJitDump().
+		std::mutex m_mutex;
 		std::vector<Info> m_v;
 		char m_prefix[20];
 		unsigned int m_vtune_id;
@@ -48,15 +52,27 @@ namespace Perf
 		void print(FILE* fp);
 		void map(uptr x86, u32 size, const char* symbol);
 		void map(uptr x86, u32 size, u32 pc);
+		void map(uptr x86, u32 size, const char* symbol, u64 key);
 		void reset();
+
+		void replay();
 	};
 
 	void dump();
 	void dump_and_reset();
 
+	/// Streams a jitdump file (jit-<pid>.dump, in $JITDUMPDIR or /tmp) with every block
+	/// mapped from now on, for use with perf record -k1 and perf inject --jit.
+	/// Static code which was already mapped (dispatchers) is written out straight away.
+	bool OpenJitDump();
+	void CloseJitDump();
+	bool IsJitDumpOpen();
+
 	extern InfoVector any;
 	extern InfoVector ee;
 	extern InfoVector iop;
-	extern InfoVector vu;
+	extern InfoVector vu0;
+	extern InfoVector vu1;
 	extern InfoVector vif;
+	extern InfoVector gs;
 } // namespace Perf
@@ -20,6 +20,7 @@
 #include "common/RedtapeWindows.h"
 #endif
 
+#include <algorithm>
 #include <limits>
 
 // --------------------------------------------------------------------------------------
@@ -148,6 +149,19 @@ void Threading::WorkSema::Reset()
 	m_state = STATE_RUNNING_0;
 }
 
+void Threading::AdaptiveWaiter::Record(u64 start_ticks)
+{
+	const u64 ns = static_cast<u64>(static_cast<double>(GetCPUTicks() - start_ticks) * 1e9 / static_cast<double>(GetTickFrequency()));
+
+	// Moving average over roughly the last eight waits, so the choice follows the game
+	// between scenes without flipping on a single outlier.
+	const u32 clamped = static_cast<u32>(std::min<u64>(ns, std::numeric_limits<u32>::max()));
+	m_average_ns = static_cast<u32>((static_cast<u64>(m_average_ns) * 7 + clamped) / 8);
+
+	m_wait_count.fetch_add(1, std::memory_order_relaxed);
+	m_wait_time_ns.fetch_add(ns, std::memory_order_relaxed);
+}
+
 #if !defined(__APPLE__) // macOS implementations are in DarwinSemaphore
 
 Threading::KernelSemaphore::KernelSemaphore()
@@ -214,6 +214,13 @@ namespace Threading
 				m_sema.Post();
 		}
 
+		/// Checks if the worker thread has finished everything in its queue, without waiting
+		bool IsEmpty() const
+		{
+			const s32 state = m_state.load(std::memory_order_acquire);
+			return (state == STATE_SPINNING || state == STATE_SLEEPING);
+		}
+
 		/// Checks if there's any work in the queue
 		bool CheckForWork();
 		/// Wait for work to be added to the queue
@@ -264,4 +271,58 @@ namespace Threading
 			return counter > 0;
 		}
 	};
+
+	/// Waits at a sync point between threads, choosing between spinning, yielding and sleeping
+	/// from how long recent waits at the same point took. Short waits are spun on, medium ones
+	/// yield the timeslice, and long ones go straight to sleep, so a handoff neither burns a
+	/// core on an oversubscribed host nor pays for a wake up on a dedicated one.
+	/// Only one thread should wait on a given waiter.
+	class AdaptiveWaiter
+	{
+	public:
+		/// Waits until ready() returns true, or sleep() returns. sleep() should block until
+		/// whatever ready() checks for has happened, and is skipped if spinning got there first.
+		template <typename Ready, typename Sleep>
+		void Wait(const Ready& ready, const Sleep& sleep)
+		{
+			const u64 start = GetCPUTicks();
+			const u32 average = m_average_ns;
+
+			bool done = false;
+			if (average < YIELD_TIME_NS)
+			{
+				// Allow a bit longer than usual, so a slightly late handoff doesn't end up sleeping.
+				const u64 limit = start + (static_cast<u64>(average * 2 + MIN_SPIN_NS) * GetTickFrequency()) / 1000000000;
+				const bool yield = (average >= SPIN_TIME_NS);
+				while (!(done = ready()) && GetCPUTicks() < limit)
+				{
+					if (yield)
+						Timeslice();
+					else
+						ShortSpin();
+				}
+			}
+
+			if (!done)
+				sleep();
+
+			Record(start);
+		}
+
+		/// Number of waits so far, and the time spent in them.
+		u32 GetWaitCount() const { return m_wait_count.load(std::memory_order_relaxed); }
+		u64 GetWaitTimeNS() const { return m_wait_time_ns.load(std::memory_order_relaxed); }
+
+	private:
+		/// Waits which usually take longer than this go straight to sleep.
+		static constexpr u32 YIELD_TIME_NS = 1000 * 1000;
+		/// Shortest spin, so the first waits get a chance to find out they're short.
+		static constexpr u32 MIN_SPIN_NS = 2 * 1000;
+
+		void Record(u64 start_ticks);
+
+		u32 m_average_ns = 0;
+		std::atomic<u32> m_wait_count{0};
+		std::atomic<u64> m_wait_time_ns{0};
+	};
 } // namespace Threading
@@ -174,6 +174,53 @@ void HostSys::UnmapSharedMemory(void* baseaddr, size_t size)
 		pxFail("Failed to unmap shared memory");
 }
 
+void* HostSys::MapFile(const char* path, size_t* size)
+{
+	const HANDLE file = CreateFileW(StringUtil::UTF8StringToWideString(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	void* ret = nullptr;
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+	{
+		// The view keeps the mapping alive, so both handles can be closed straight away.
+		const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+
+		if (ret)
+			*size = static_cast<size_t>(file_size.QuadPart);
+	}
+
+	CloseHandle(file);
+	return ret;
+}
+
+void HostSys::UnmapFile(void* baseaddr, size_t size)
+{
+	if (!baseaddr)
+		return;
+
+	UnmapViewOfFile(baseaddr);
+}
+
+bool HostSys::AdviseHugePages(void* baseaddr, size_t size)
+{
+	// Large pages have to be requested when the memory is allocated, need SeLockMemoryPrivilege,
+	// and can't be used with placeholders. Not worth it for now.
+	return false;
+}
+
+size_t HostSys::GetHugePageMappedSize(const void* baseaddr, size_t size)
+{
+	return 0;
+}
+
 SharedMemoryMappingArea::SharedMemoryMappingArea(u8* base_ptr, size_t size, size_t num_pages)
 	: m_base_ptr(base_ptr)
 	, m_size(size)
@@ -296,6 +296,8 @@ void x86capabilities::Identify()
 		hasAVX = (Flags2 >> 28) & 1; //avx
 		hasFMA = (Flags2 >> 12) & 1; //fma
 		hasAVX2 = (SEFlag >> 5) & 1; //avx2
+		hasAVX512 = ((SEFlag >> 16) & 1) && ((SEFlag >> 17) & 1) && ((SEFlag >> 28) & 1) &&
+					((SEFlag >> 30) & 1) && ((SEFlag >> 31) & 1); //avx512f, dq, cd, bw, vl
 	}
 
 	hasBMI1 = (SEFlag >> 3) & 1;
@@ -93,6 +93,7 @@ public:
 			u32 hasStreamingSIMD4Extensions2 : 1;
 			u32 hasAVX : 1;
 			u32 hasAVX2 : 1;
+			u32 hasAVX512 : 1; // F, BW, VL, DQ and CD
 			u32 hasBMI1 : 1;
 			u32 hasBMI2 : 1;
 			u32 hasFMA : 1;
@@ -34,6 +34,7 @@
 #include "common/Path.h"
 #include "common/SettingsWrapper.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
 
 #include "pcsx2/PrecompiledHeader.h"
 
@@ -49,6 +50,8 @@
 #include "pcsx2/HostSettings.h"
 #include "pcsx2/INISettingsInterface.h"
 #include "pcsx2/PerformanceMetrics.h"
+#include "pcsx2/Recording/InputRecording.h"
+#include "pcsx2/SubsystemProfiler.h"
 #include "pcsx2/VMManager.h"
 
 #ifdef ENABLE_ACHIEVEMENTS
@@ -60,6 +63,7 @@
 namespace GSRunner
 {
 	static bool InitializeConfig();
+	static bool RunInputRecording();
 
 	static bool CreatePlatformWindow();
 	static void DestroyPlatformWindow();
@@ -76,9 +80,12 @@ alignas(16) static SysMtgsThread s_mtgs_thread;
 static std::string s_output_prefix;
 static s32 s_loop_count = 1;
 static std::optional<bool> s_use_window;
+static std::string s_input_recording_path;
+static std::string s_hash_trace_path;
 
 // Owned by the GS thread.
 static u32 s_dump_frame_number = 0;
+static std::FILE* s_hash_trace_file = nullptr;
 
 bool GSRunner::InitializeConfig()
 {
@@ -273,12 +280,15 @@ void Host::ReleaseHostDisplay(bool clear_state)
 
 bool Host::BeginPresentFrame(bool frame_skip)
 {
-	// when we wrap around, don't race other files
-	GSJoinSnapshotThreads();
+	if (!s_output_prefix.empty())
+	{
+		// when we wrap around, don't race other files
+		GSJoinSnapshotThreads();
 
-	// queue dumping of this frame
-	std::string dump_path(fmt::format("{}_frame{}.png", s_output_prefix, s_dump_frame_number));
-	GSQueueSnapshot(dump_path);
+		// queue dumping of this frame
+		std::string dump_path(fmt::format("{}_frame{}.png", s_output_prefix, s_dump_frame_number));
+		GSQueueSnapshot(dump_path);
+	}
 
 	if (g_host_display->BeginPresent(frame_skip))
 		return true;
@@ -427,6 +437,7 @@ static void PrintCommandLineHelp(const char* progname)
 {
 	PrintCommandLineVersion();
 	std::fprintf(stderr, "Usage: %s [parameters] [--] [filename]\n", progname);
+	std::fprintf(stderr, "  filename is a GS dump, or a disc image/ELF when -input is used.\n");
 	std::fprintf(stderr, "\n");
 	std::fprintf(stderr, "  -help: Displays this information and exits.\n");
 	std::fprintf(stderr, "  -version: Displays version information and exits.\n");
@@ -437,6 +448,10 @@ static void PrintCommandLineHelp(const char* progname)
 	std::fprintf(stderr, "  -surfaceless: Disables showing a window.\n");
 	std::fprintf(stderr, "  -logfile <filename>: Writes emu log to filename.\n");
 	std::fprintf(stderr, "  -noshadercache: Disables the shader cache (useful for parallel runs).\n");
+	std::fprintf(stderr, "  -input <file>: Boots filename and replays the input recording as fast as possible,\n"
+						 "    then prints the time spent in each component.\n");
+	std::fprintf(stderr, "  -hashtrace <file>: With -input, writes a hash of GS memory for every frame to file.\n"
+						 "    Use the sw or null renderer, hardware renderers don't keep GS memory up to date.\n");
 	std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
 						 "    parameters make up the filename. Use when the filename contains\n"
 						 "    spaces or starts with a dash.\n");
@@ -513,6 +528,8 @@ static bool ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& param
 #endif
 				else if (StringUtil::Strcasecmp(rname, "sw") == 0)
 					type = GSRendererType::SW;
+				else if (StringUtil::Strcasecmp(rname, "null") == 0)
+					type = GSRendererType::Null;
 				else
 				{
 					Console.Error("Unknown renderer '%s'", rname);
@@ -543,6 +560,18 @@ static bool ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& param
 				s_settings_interface.SetBoolValue("EmuCore/GS", "disable_shader_cache", false);
 				continue;
 			}
+			else if (CHECK_ARG_PARAM("-input"))
+			{
+				s_input_recording_path = argv[++i];
+				Console.WriteLn("Replaying input recording %s", s_input_recording_path.c_str());
+				s_settings_interface.SetBoolValue("EmuCore", "EnableRecordingTools", true);
+				continue;
+			}
+			else if (CHECK_ARG_PARAM("-hashtrace"))
+			{
+				s_hash_trace_path = argv[++i];
+				continue;
+			}
 			else if (CHECK_ARG("-window"))
 			{
 				Console.WriteLn("Creating window");
@@ -581,11 +610,24 @@ static bool ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& param
 		return false;
 	}
 
-	if (!VMManager::IsGSDumpFileName(params.filename))
+	if (!s_input_recording_path.empty())
+	{
+		if (VMManager::IsGSDumpFileName(params.filename))
+		{
+			Console.Error("Input recordings can't be replayed with a GS dump.");
+			return false;
+		}
+	}
+	else if (!VMManager::IsGSDumpFileName(params.filename))
 	{
 		Console.Error("Provided filename is not a GS dump.");
 		return false;
 	}
+	else if (!s_hash_trace_path.empty())
+	{
+		Console.Error("-hashtrace requires -input.");
+		return false;
+	}
 
 	// set up the frame dump directory
 	if (!s_output_prefix.empty())
@@ -632,15 +674,28 @@ int main(int argc, char* argv[])
 	// apply new settings (e.g. pick up renderer change)
 	VMManager::ApplySettings();
 
+	bool result = true;
 	if (VMManager::Initialize(params))
 	{
-		// run until end
-		GSDumpReplayer::SetLoopCount(s_loop_count);
-		VMManager::SetState(VMState::Running);
-		while (VMManager::GetState() == VMState::Running)
-			VMManager::Execute();
+		if (!s_input_recording_path.empty())
+		{
+			result = GSRunner::RunInputRecording();
+		}
+		else
+		{
+			// run until end
+			GSDumpReplayer::SetLoopCount(s_loop_count);
+			VMManager::SetState(VMState::Running);
+			while (VMManager::GetState() == VMState::Running)
+				VMManager::Execute();
+		}
+
 		VMManager::Shutdown(false);
 	}
+	else
+	{
+		result = false;
+	}
 
 	InputManager::CloseSources();
 	VMManager::Internal::ReleaseMemory();
@@ -648,7 +703,59 @@ int main(int argc, char* argv[])
 	PerformanceMetrics::SetCPUThread(Threading::ThreadHandle());
 	GSRunner::DestroyPlatformWindow();
 
-	return EXIT_SUCCESS;
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool GSRunner::RunInputRecording()
+{
+	if (!s_hash_trace_path.empty())
+	{
+		s_hash_trace_file = FileSystem::OpenCFile(s_hash_trace_path.c_str(), "wb");
+		if (!s_hash_trace_file)
+		{
+			Console.Error("Failed to open hash trace '%s'", s_hash_trace_path.c_str());
+			return false;
+		}
+	}
+
+	// Boots or loads the recording's state, so nothing runs before the timing starts.
+	if (!g_InputRecording.play(s_input_recording_path))
+	{
+		Console.Error("Failed to play input recording '%s'", s_input_recording_path.c_str());
+		return false;
+	}
+
+	SubsystemProfiler::SetEnabled(true);
+	Common::Timer timer;
+
+	// pauses itself at the end of the recording
+	VMManager::SetState(VMState::Running);
+	while (VMManager::GetState() == VMState::Running)
+		VMManager::Execute();
+
+	// make sure the GS thread has caught up, and isn't writing the trace any more
+	GetMTGS().WaitGS(false, false, false);
+	const double elapsed = timer.GetTimeSeconds();
+	SubsystemProfiler::SetEnabled(false);
+
+	if (s_hash_trace_file)
+	{
+		std::fclose(s_hash_trace_file);
+		s_hash_trace_file = nullptr;
+	}
+
+	const u64 frames = g_InputRecording.getFrameCounter();
+	Console.WriteLn(Color_StrongGreen, "Replayed %llu frames in %.3f seconds (%.2f FPS)", static_cast<unsigned long long>(frames), elapsed,
+		(elapsed > 0.0) ? (frames / elapsed) : 0.0);
+	for (u32 i = 0; i < static_cast<u32>(SubsystemProfiler::Subsystem::Count); i++)
+	{
+		const SubsystemProfiler::Subsystem sub = static_cast<SubsystemProfiler::Subsystem>(i);
+		const double time = SubsystemProfiler::GetTime(sub);
+		Console.WriteLn(Color_StrongGreen, "  %-5s %9.3f s  %6.2f ms/frame", SubsystemProfiler::GetName(sub), time,
+			frames ? (time * 1000.0 / frames) : 0.0);
+	}
+
+	return true;
 }
 
 void Host::CPUThreadVSync()
@@ -656,6 +763,16 @@ void Host::CPUThreadVSync()
 	// update GS thread copy of frame number
 	GetMTGS().RunOnGSThread([frame_number = GSDumpReplayer::GetFrameNumber()]() { s_dump_frame_number = frame_number; });
 
+	// queued behind this frame's packets, so the GS has finished with it
+	if (!s_hash_trace_path.empty())
+	{
+		GetMTGS().RunOnGSThread([frame_number = g_InputRecording.getFrameCounter()]() {
+			if (s_hash_trace_file)
+				std::fprintf(s_hash_trace_file, "%llu %016llx\n", static_cast<unsigned long long>(frame_number),
+					static_cast<unsigned long long>(GSGetLocalMemoryHash()));
+		});
+	}
+
 	// process any window messages (but we shouldn't really have any)
 	GSRunner::PumpPlatformMessages();
 }
@@ -45,6 +45,9 @@
 // this string will be empty.
 std::string DiscSerial;
 
+// The VER entry from the disc's SYSTEM.CNF (e.g. 1.00), empty if there wasn't one.
+std::string DiscVersion;
+
 cdvdStruct cdvd;
 
 s64 PSXCLK = 36864000;
@@ -522,7 +525,8 @@ void cdvdReloadElfInfo(std::string elfoverride)
 	try
 	{
 		std::string elfpath;
-		u32 discType = GetPS2ElfName(elfpath);
+		DiscVersion.clear();
+		u32 discType = GetPS2ElfName(elfpath, &DiscVersion);
 		DiscSerial = ExecutablePathToSerial(elfpath);
 
 		// Use the serial from the disc (if any), and the ELF CRC of the override.
@@ -552,6 +556,7 @@ void cdvdReloadElfInfo(std::string elfoverride)
 		Console.Error("Failed to load ELF info");
 		LastELF.clear();
 		DiscSerial.clear();
+		DiscVersion.clear();
 		ElfCRC = 0;
 		ElfEntry = 0;
 		ElfTextRange = {};
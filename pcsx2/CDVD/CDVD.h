@@ -181,3 +181,4 @@ extern s32 cdvdCtrlTrayOpen();
 extern s32 cdvdCtrlTrayClose();
 
 extern std::string DiscSerial;
+extern std::string DiscVersion;
@@ -19,6 +19,7 @@
 #include "CDVD/IsoFileFormats.h"
 #include "Config.h"
 #include "Host.h"
+#include "TimelineTracer.h"
 
 #include "common/Assertions.h"
 #include "common/Exceptions.h"
@@ -54,6 +55,7 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 		return -1;
 	}
 
+	TimelineTracer::ScopedZone zone("CDVD Read", lsn);
 	return m_reader->ReadSync(dst + m_blockofs, lsn, 1);
 }
 
@@ -100,6 +102,7 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 
 	if (m_read_inprogress)
 	{
+		TimelineTracer::ScopedZone zone("CDVD Read", m_read_lsn);
 		const int ret = m_reader->FinishRead();
 		m_read_inprogress = false;
 
@@ -15,6 +15,7 @@
 
 #include "PrecompiledHeader.h"
 #include "ThreadedFileReader.h"
+#include "TimelineTracer.h"
 
 #include "common/Threading.h"
 
@@ -61,6 +62,7 @@ size_t ThreadedFileReader::CopyBlocks(void* dst, const void* src, size_t size) c
 void ThreadedFileReader::Loop()
 {
 	Threading::SetNameOfCurrentThread("ISO Decompress");
+	TimelineTracer::SetCurrentThreadName("ISO Decompress");
 
 	std::unique_lock<std::mutex> lock(m_mtx);
 
@@ -86,7 +88,10 @@ void ThreadedFileReader::Loop()
 			lock.unlock();
 
 			if (ptr)
+			{
+				TimelineTracer::ScopedZone zone("ISO Decompress", static_cast<s64>(requestOffset));
 				ok = Decompress(ptr, requestOffset, requestSize);
+			}
 
 			// There's a potential for a race here when doing synchronous reads. Basically, another request can come in,
 			// after we release the lock, but before we store null to indicate we're finished. So, we do a compare-exchange
@@ -17,6 +17,7 @@
 #include "PrecompiledHeader.h"
 #include "Common.h"
 #include "COP0.h"
+#include "Cache.h"
 
 // Updates the CPU's mode of operation (either, Kernel, Supervisor, or User modes).
 // Currently the different modes are not implemented.
@@ -463,6 +464,7 @@ void WriteTLB(int i)
 	tlb[i].PFN1 = (((cpuRegs.CP0.n.EntryLo1 >> 6) & 0xFFFFF) & (~tlb[i].Mask)) << 12;
 	tlb[i].S = cpuRegs.CP0.n.EntryLo0&0x80000000;
 
+	updateCachePageModes();
 	MapTLB(tlb[i], i);
 }
 
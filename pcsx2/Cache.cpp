@@ -19,6 +19,8 @@
 #include "Cache.h"
 #include "vtlb.h"
 
+#include <vector>
+
 using namespace R5900;
 using namespace vtlb_private;
 
@@ -161,11 +163,73 @@ namespace
 
 	static Cache cache;
 
+	static_assert(sizeof(CacheTag) == sizeof(uptr));
+	static_assert(sizeof(CacheSet) == CACHE_SET_SIZE);
+	static_assert(offsetof(CacheSet, data) == CACHE_SET_DATA_OFFSET);
+	static_assert(sizeof(CacheData) == CACHE_LINE_SIZE);
+	static_assert(CacheTag::ALL_FLAGS == CACHE_TAG_FLAGS);
+	static_assert(CacheTag::VALID_FLAG == CACHE_TAG_VALID);
+	static_assert(CacheTag::DIRTY_FLAG == CACHE_TAG_DIRTY);
+
+	// Page ranges currently marked in cachePageModes, so they can be cleared on the next update.
+	static std::vector<std::pair<u32, u32>> s_cached_page_ranges;
+
+}
+
+alignas(64) u8 cachePageModes[VTLB_VMAP_ITEMS];
+
+void* getCacheSets()
+{
+	return cache.sets;
 }
 
 void resetCache()
 {
 	memzero(cache);
+	updateCachePageModes();
+}
+
+// Rebuilds the per-page summary of CheckCache(), so callers only need to do the full TLB scan
+// for pages which are partially covered by a cached mapping.
+void updateCachePageModes()
+{
+	for (const auto& [start, end] : s_cached_page_ranges)
+		std::memset(&cachePageModes[start], CACHE_PAGE_UNCACHED, end - start + 1);
+	s_cached_page_ranges.clear();
+
+	for (int i = 1; i < 48; i++)
+	{
+		auto mark = [i](u32 entry_lo, u32 pfn) {
+			if (((entry_lo & 0x38) >> 3) != 0x3)
+				return;
+
+			// CheckCache() never matches a range that wraps around.
+			const u32 start = pfn;
+			const u32 end = pfn + tlb[i].PageMask;
+			if (end < start)
+				return;
+
+			const u32 start_page = start >> VTLB_PAGE_BITS;
+			const u32 end_page = end >> VTLB_PAGE_BITS;
+			for (u32 page = start_page; page <= end_page; page++)
+			{
+				const bool whole_page = (page != start_page || (start & VTLB_PAGE_MASK) == 0) &&
+										(page != end_page || (end & VTLB_PAGE_MASK) == VTLB_PAGE_MASK);
+				if (whole_page)
+					cachePageModes[page] = CACHE_PAGE_CACHED;
+				else if (cachePageModes[page] != CACHE_PAGE_CACHED)
+					cachePageModes[page] = CACHE_PAGE_PARTIAL;
+			}
+
+			s_cached_page_ranges.emplace_back(start_page, end_page);
+		};
+
+		mark(tlb[i].EntryLo1, tlb[i].PFN1);
+		mark(tlb[i].EntryLo0, tlb[i].PFN0);
+	}
+
+	// fastmem can't see the cache, so these pages have to be hidden from it
+	vtlb_SetFastmemCacheRanges(s_cached_page_ranges);
 }
 
 static bool findInCache(const CacheSet& set, uptr ppf, int* way)
@@ -182,13 +246,18 @@ static bool findInCache(const CacheSet& set, uptr ppf, int* way)
 	return check(0) || check(1);
 }
 
-static int getFreeCache(u32 mem, int* way)
+static uptr getCachePPF(u32 mem)
 {
-	const int setIdx = cache.setIdxFor(mem);
-	CacheSet& set = cache.sets[setIdx];
 	VTLBVirtual vmv = vtlbdata.vmap[mem >> VTLB_PAGE_BITS];
 	pxAssertMsg(!vmv.isHandler(mem), "Cache currently only supports non-handler addresses!");
-	uptr ppf = vmv.assumePtr(mem);
+	return vmv.assumePtr(mem);
+}
+
+// The host address has the same low 12 bits as the guest address, so it gives the same set.
+static int getFreeCache(uptr ppf, int* way)
+{
+	const int setIdx = cache.setIdxFor(static_cast<u32>(ppf));
+	CacheSet& set = cache.sets[setIdx];
 
 	if((cpuRegs.CP0.n.Config & 0x10000) == 0)
 		CACHE_LOG("Cache off!");
@@ -213,27 +282,33 @@ static int getFreeCache(u32 mem, int* way)
 }
 
 template <bool Write, int Bytes>
-void* prepareCacheAccess(u32 mem, int* way, int* idx)
+void* prepareCacheAccess(uptr ppf, int* way, int* idx)
 {
 	*way = 0;
-	*idx = getFreeCache(mem, way);
+	*idx = getFreeCache(ppf, way);
 	CacheLine line = cache.lineAt(*idx, *way);
 	if (Write)
 		line.tag.setDirty();
-	u32 aligned = mem & ~(Bytes - 1);
+	uptr aligned = ppf & ~(Bytes - 1);
 	return &line.data.bytes[aligned & 0x3f];
 }
 
 template <typename Int>
-void writeCache(u32 mem, Int value)
+void writeCacheHost(uptr ppf, Int value)
 {
 	int way, idx;
-	void* addr = prepareCacheAccess<true, sizeof(Int)>(mem, &way, &idx);
+	void* addr = prepareCacheAccess<true, sizeof(Int)>(ppf, &way, &idx);
 
-	CACHE_LOG("writeCache%d %8.8x adding to %d, way %d, value %llx", 8 * sizeof(value), mem, idx, way, value);
+	CACHE_LOG("writeCache%d %zx adding to %d, way %d, value %llx", 8 * sizeof(value), ppf, idx, way, value);
 	*reinterpret_cast<Int*>(addr) = value;
 }
 
+template <typename Int>
+void writeCache(u32 mem, Int value)
+{
+	writeCacheHost<Int>(getCachePPF(mem), value);
+}
+
 void writeCache8(u32 mem, u8 value)
 {
 	writeCache<u8>(mem, value);
@@ -257,23 +332,29 @@ void writeCache64(u32 mem, const u64 value)
 void writeCache128(u32 mem, const mem128_t* value)
 {
 	int way, idx;
-	void* addr = prepareCacheAccess<true, sizeof(mem128_t)>(mem, &way, &idx);
+	void* addr = prepareCacheAccess<true, sizeof(mem128_t)>(getCachePPF(mem), &way, &idx);
 
 	CACHE_LOG("writeCache128 %8.8x adding to %d, way %x, lo %llx, hi %llx", mem, idx, way, value->lo, value->hi);
 	*reinterpret_cast<mem128_t*>(addr) = *value;
 }
 
 template <typename Int>
-Int readCache(u32 mem)
+Int readCacheHost(uptr ppf)
 {
 	int way, idx;
-	void* addr = prepareCacheAccess<false, sizeof(Int)>(mem, &way, &idx);
+	void* addr = prepareCacheAccess<false, sizeof(Int)>(ppf, &way, &idx);
 
 	Int value = *reinterpret_cast<Int*>(addr);
-	CACHE_LOG("readCache%d %8.8x from %d, way %d, value %llx", 8 * sizeof(value), mem, idx, way, value);
+	CACHE_LOG("readCache%d %zx from %d, way %d, value %llx", 8 * sizeof(value), ppf, idx, way, value);
 	return value;
 }
 
+template <typename Int>
+Int readCache(u32 mem)
+{
+	return readCacheHost<Int>(getCachePPF(mem));
+}
+
 
 u8 readCache8(u32 mem)
 {
@@ -296,15 +377,69 @@ u64 readCache64(u32 mem)
 }
 
 RETURNS_R128 readCache128(u32 mem)
+{
+	return readCacheHost128(getCachePPF(mem));
+}
+
+u8 readCacheHost8(uptr ppf)
+{
+	return readCacheHost<u8>(ppf);
+}
+
+u16 readCacheHost16(uptr ppf)
+{
+	return readCacheHost<u16>(ppf);
+}
+
+u32 readCacheHost32(uptr ppf)
+{
+	return readCacheHost<u32>(ppf);
+}
+
+u64 readCacheHost64(uptr ppf)
+{
+	return readCacheHost<u64>(ppf);
+}
+
+RETURNS_R128 readCacheHost128(uptr ppf)
 {
 	int way, idx;
-	void* addr = prepareCacheAccess<false, sizeof(mem128_t)>(mem, &way, &idx);
+	void* addr = prepareCacheAccess<false, sizeof(mem128_t)>(ppf, &way, &idx);
 	r128 value = r128_load(addr);
 	u64* vptr = reinterpret_cast<u64*>(&value);
-	CACHE_LOG("readCache128 %8.8x from %d, way %d, lo %llx, hi %llx", mem, idx, way, vptr[0], vptr[1]);
+	CACHE_LOG("readCache128 %zx from %d, way %d, lo %llx, hi %llx", ppf, idx, way, vptr[0], vptr[1]);
 	return value;
 }
 
+void writeCacheHost8(uptr ppf, u8 value)
+{
+	writeCacheHost<u8>(ppf, value);
+}
+
+void writeCacheHost16(uptr ppf, u16 value)
+{
+	writeCacheHost<u16>(ppf, value);
+}
+
+void writeCacheHost32(uptr ppf, u32 value)
+{
+	writeCacheHost<u32>(ppf, value);
+}
+
+void writeCacheHost64(uptr ppf, u64 value)
+{
+	writeCacheHost<u64>(ppf, value);
+}
+
+void TAKES_R128 writeCacheHost128(uptr ppf, r128 value)
+{
+	int way, idx;
+	void* addr = prepareCacheAccess<true, sizeof(mem128_t)>(ppf, &way, &idx);
+
+	CACHE_LOG("writeCache128 %zx adding to %d, way %x", ppf, idx, way);
+	r128_store(addr, value);
+}
+
 template <typename Op>
 void doCacheHitOp(u32 addr, const char* name, Op op)
 {
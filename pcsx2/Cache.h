@@ -18,7 +18,27 @@
 #include "Common.h"
 #include "SingleRegisterTypes.h"
 
+// Whether CheckCache() is true for all, some, or none of a 4KB page of the EE address space.
+enum CachePageMode : u8
+{
+	CACHE_PAGE_UNCACHED = 0,
+	CACHE_PAGE_CACHED = 1,
+	CACHE_PAGE_PARTIAL = 2,
+};
+extern u8 cachePageModes[0x100000];
+
+// Layout of the cache sets, for the EE recompiler's inline hit check. Each set is two tags
+// (host address of the line | flags) followed by the data for both ways.
+static constexpr u32 CACHE_SET_SIZE = 192;
+static constexpr u32 CACHE_SET_DATA_OFFSET = 64;
+static constexpr u32 CACHE_LINE_SIZE = 64;
+static constexpr uptr CACHE_TAG_FLAGS = 0xFFF;
+static constexpr uptr CACHE_TAG_VALID = 0x20;
+static constexpr uptr CACHE_TAG_DIRTY = 0x40;
+void* getCacheSets();
+
 void resetCache();
+void updateCachePageModes();
 void writeCache8(u32 mem, u8 value);
 void writeCache16(u32 mem, u16 value);
 void writeCache32(u32 mem, u32 value);
@@ -29,3 +49,15 @@ u16 readCache16(u32 mem);
 u32 readCache32(u32 mem);
 u64 readCache64(u32 mem);
 RETURNS_R128 readCache128(u32 mem);
+
+// Same as the above, but take the host address the access maps to.
+u8 readCacheHost8(uptr ppf);
+u16 readCacheHost16(uptr ppf);
+u32 readCacheHost32(uptr ppf);
+u64 readCacheHost64(uptr ppf);
+RETURNS_R128 readCacheHost128(uptr ppf);
+void writeCacheHost8(uptr ppf, u8 value);
+void writeCacheHost16(uptr ppf, u16 value);
+void writeCacheHost32(uptr ppf, u32 value);
+void writeCacheHost64(uptr ppf, u64 value);
+void TAKES_R128 writeCacheHost128(uptr ppf, r128 value);
@@ -485,24 +485,31 @@ struct Pcsx2Config
 			RecBlocks_EE : 1, // Enables per-block profiling for the EE recompiler [unimplemented]
 			RecBlocks_IOP : 1, // Enables per-block profiling for the IOP recompiler [unimplemented]
 			RecBlocks_VU0 : 1, // Enables per-block profiling for the VU0 recompiler [unimplemented]
-			RecBlocks_VU1 : 1; // Enables per-block profiling for the VU1 recompiler [unimplemented]
+			RecBlocks_VU1 : 1, // Enables per-block profiling for the VU1 recompiler [unimplemented]
+			PerfJitDump : 1, // Streams a jitdump of all recompiled code for perf inject --jit (Linux only)
+			TimelineTracer : 1; // Records per-thread zones which can be saved as a Chrome/Perfetto trace
 		BITFIELD_END
 
+		u32 TraceFrames = 10; // Number of frames written out when a timeline trace is saved
+		float TraceSpikeThreshold = 0.0f; // Frame time in ms which saves a timeline trace automatically, 0 to disable
+
 		// Default is Disabled, with all recs enabled underneath.
 		ProfilerOptions()
 			: bitset(0xfffffffe)
 		{
+			PerfJitDump = false;
+			TimelineTracer = false;
 		}
 		void LoadSave(SettingsWrapper& wrap);
 
 		bool operator==(const ProfilerOptions& right) const
 		{
-			return OpEqu(bitset);
+			return OpEqu(bitset) && OpEqu(TraceFrames) && OpEqu(TraceSpikeThreshold);
 		}
 
 		bool operator!=(const ProfilerOptions& right) const
 		{
-			return !OpEqu(bitset);
+			return !this->operator==(right);
 		}
 	};
 
@@ -541,6 +548,10 @@ struct Pcsx2Config
 			EnableFullTLB : 1;
 		bool
 			PauseOnTLBMiss : 1;
+		bool
+			EnableWarmStart : 1;
+		bool
+			EnableEESuperblocks : 1;
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -697,6 +708,11 @@ struct Pcsx2Config
 
 		int VsyncQueueSize{2};
 
+		// Size of the MTGS ringbuffer in megabytes, rounded up to a power of 2.
+		int MTGSRingBufferSize{8};
+		// Doubles the ringbuffer when the EE spends too long waiting for room in it.
+		bool MTGSGrowRingBuffer{false};
+
 		// forces the MTGS to execute tags/tasks in fully blocking/synchronous
 		// style. Useful for debugging potential bugs in the MTGS pipeline.
 		bool SynchronousMTGS{false};
@@ -1054,7 +1070,8 @@ struct Pcsx2Config
 			WaitLoop : 1, // enables constant loop detection and fast-forwarding
 			vuFlagHack : 1, // microVU specific flag hack
 			vuThread : 1, // Enable Threaded VU1
-			vu1Instant : 1; // Enable Instant VU1 (Without MTVU only)
+			vu1Instant : 1, // Enable Instant VU1 (Without MTVU only)
+			ipuThread : 1; // Decode IPU slices on a separate thread
 		BITFIELD_END
 
 		s8 EECycleRate; // EE cycle rate selector (1.0, 1.5, 2.0)
@@ -1247,6 +1264,9 @@ struct Pcsx2Config
 		ConsoleToStdio : 1,
 		HostFs : 1,
 
+		// advises the code caches, GS local memory and main memory besides EE RAM to use huge pages
+		HugePages : 1,
+
 		WarnAboutUnsafeSettings : 1;
 
 	// uses automatic ntfs compression when creating new memory cards (Win32 only)
@@ -1351,6 +1371,7 @@ namespace EmuFolders
 #define CHECK_IOPREC (EmuConfig.Cpu.Recompiler.EnableIOP)
 #define CHECK_FASTMEM (EmuConfig.Cpu.Recompiler.EnableEE && EmuConfig.Cpu.Recompiler.EnableFastmem)
 #define CHECK_FULLTLB (EmuConfig.Cpu.Recompiler.EnableFullTLB)
+#define CHECK_EESUPERBLOCKS (EmuConfig.Cpu.Recompiler.EnableEE && EmuConfig.Cpu.Recompiler.EnableEESuperblocks)
 
 //------------ SPECIAL GAME FIXES!!! ---------------
 #define CHECK_VUADDSUBHACK (EmuConfig.Gamefixes.VuAddSubHack) // Special Fix for Tri-ace games, they use an encryption algorithm that requires VU addi opcode to be bit-accurate.
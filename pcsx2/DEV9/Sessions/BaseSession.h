@@ -18,6 +18,9 @@
 #include "DEV9/PacketReader/IP/IP_Packet.h"
 #include <functional>
 #include <vector>
+#ifdef _WIN32
+#include <winsock2.h>
+#endif
 
 namespace Sessions
 {
@@ -58,6 +61,14 @@ namespace Sessions
 		virtual bool Send(PacketReader::IP::IP_Payload* payload) = 0;
 		virtual void Reset() = 0;
 
+		//Returns true if Recv() has nothing to do until the returned socket is readable (or errored)
+		//Returns false if Recv() needs to be called anyway, such as when packets are queued
+#ifdef _WIN32
+		virtual bool GetRecvSocket(SOCKET* socket) { return false; }
+#elif defined(__POSIX__)
+		virtual bool GetRecvSocket(int* socket) { return false; }
+#endif
+
 		virtual ~BaseSession() {}
 
 	protected:
@@ -91,6 +91,11 @@ namespace Sessions
 		virtual PacketReader::IP::IP_Payload* Recv();
 		virtual bool Send(PacketReader::IP::IP_Payload* payload);
 		virtual void Reset();
+#ifdef _WIN32
+		virtual bool GetRecvSocket(SOCKET* socket);
+#elif defined(__POSIX__)
+		virtual bool GetRecvSocket(int* socket);
+#endif
 
 		virtual ~TCP_Session();
 
@@ -188,6 +188,29 @@ namespace Sessions
 		return nullptr;
 	}
 
+#ifdef _WIN32
+	bool TCP_Session::GetRecvSocket(SOCKET* socket)
+#elif defined(__POSIX__)
+	bool TCP_Session::GetRecvSocket(int* socket)
+#endif
+	{
+		//Packets queued by Send() need to be returned regardless
+		if (!_recvBuff.IsQueueEmpty())
+			return false;
+
+		switch (state)
+		{
+			case TCP_State::Connected:
+			case TCP_State::Closing_ClosedByPS2:
+				*socket = client;
+				return true;
+			default:
+				//Other states either don't read the socket, or
+				//check the connection status themselves (SendingSYN_ACK)
+				return false;
+		}
+	}
+
 	TCP_Packet* TCP_Session::ConnectTCPComplete(bool success)
 	{
 		if (success)
@@ -206,6 +206,19 @@ namespace Sessions
 		return nullptr;
 	}
 
+#ifdef _WIN32
+	bool UDP_FixedPort::GetRecvSocket(SOCKET* socket)
+#elif defined(__POSIX__)
+	bool UDP_FixedPort::GetRecvSocket(int* socket)
+#endif
+	{
+		if (!open.load())
+			return false;
+
+		*socket = client;
+		return true;
+	}
+
 	bool UDP_FixedPort::Send(PacketReader::IP::IP_Payload* payload)
 	{
 		pxAssert(false);
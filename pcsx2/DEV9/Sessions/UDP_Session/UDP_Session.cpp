@@ -190,6 +190,20 @@ namespace Sessions
 		return nullptr;
 	}
 
+#ifdef _WIN32
+	bool UDP_Session::GetRecvSocket(SOCKET* socket)
+#elif defined(__POSIX__)
+	bool UDP_Session::GetRecvSocket(int* socket)
+#endif
+	{
+		//FixedPort sessions only check their idle timeout, the socket is read by UDP_FixedPort
+		if (!open || isFixedPort)
+			return false;
+
+		*socket = client;
+		return true;
+	}
+
 	bool UDP_Session::WillRecive(IP_Address parDestIP)
 	{
 		if (!open)
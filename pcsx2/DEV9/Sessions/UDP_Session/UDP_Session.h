@@ -63,6 +63,11 @@ namespace Sessions
 		virtual bool WillRecive(PacketReader::IP::IP_Address parDestIP);
 		virtual bool Send(PacketReader::IP::IP_Payload* payload);
 		virtual void Reset();
+#ifdef _WIN32
+		virtual bool GetRecvSocket(SOCKET* socket);
+#elif defined(__POSIX__)
+		virtual bool GetRecvSocket(int* socket);
+#endif
 
 		virtual ~UDP_Session();
 
@@ -62,6 +62,14 @@ public:
 	}
 
 	std::vector<Key> GetKeys()
+	{
+		std::vector<Key> keys;
+		GetKeys(&keys);
+		return keys;
+	}
+
+	//Reuses the storage of keys, for callers which fetch keys repeatedly
+	void GetKeys(std::vector<Key>* keys)
 	{
 #ifdef NO_SHARED_MUTEX
 		std::unique_lock readLock(accessMutex);
@@ -69,13 +77,11 @@ public:
 		std::shared_lock readLock(accessMutex);
 #endif
 
-		std::vector<Key> keys;
-		keys.reserve(map.size());
+		keys->clear();
+		keys->reserve(map.size());
 
 		for (auto iter = map.begin(); iter != map.end(); ++iter)
-			keys.push_back(iter->first);
-
-		return keys;
+			keys->push_back(iter->first);
 	}
 
 	//Does not error or insert if no key is found
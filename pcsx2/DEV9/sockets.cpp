@@ -304,43 +304,103 @@ bool SocketAdapter::recv(NetPacket* pkt)
 	EthernetFrame* bFrame;
 	if (!vRecBuffer.Dequeue(&bFrame))
 	{
-		std::vector<ConnectionKey> keys = connections.GetKeys();
-		for (size_t i = 0; i < keys.size(); i++)
-		{
-			const ConnectionKey key = keys[i];
+		PollSessions();
+		if (!vRecBuffer.Dequeue(&bFrame))
+			return false;
+	}
 
-			BaseSession* session;
-			if (!connections.TryGetValue(key, &session))
-				continue;
+	bFrame->WritePacket(pkt);
+	InspectRecv(pkt);
 
-			IP_Payload* pl = session->Recv();
+	delete bFrame;
+	return true;
+}
 
-			if (pl != nullptr)
-			{
-				IP_Packet* ipPkt = new IP_Packet(pl);
-				ipPkt->destinationIP = session->sourceIP;
-				ipPkt->sourceIP = session->destIP;
-
-				EthernetFrame frame(ipPkt);
-				frame.sourceMAC = internalMAC;
-				frame.destinationMAC = ps2MAC;
-				frame.protocol = (u16)EtherType::IPv4;
-
-				frame.WritePacket(pkt);
-				InspectRecv(pkt);
-				return true;
-			}
+void SocketAdapter::PollSessions()
+{
+	using namespace std::chrono_literals;
+
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const bool pollIdle = now - lastIdleSessionPoll >= 100ms;
+	if (pollIdle)
+		lastIdleSessionPoll = now;
+
+	connections.GetKeys(&pollKeys);
+	pollFdKeys.clear();
+	pollFds.clear();
+
+	for (size_t i = 0; i < pollKeys.size(); i++)
+	{
+		const ConnectionKey key = pollKeys[i];
+
+		BaseSession* session;
+		if (!connections.TryGetValue(key, &session))
+			continue;
+
+#ifdef _WIN32
+		SOCKET socket;
+#elif defined(__POSIX__)
+		int socket;
+#endif
+		if (!pollIdle && session->GetRecvSocket(&socket))
+		{
+			pollFdKeys.push_back(key);
+			pollFds.push_back({socket, POLLIN, 0});
 		}
+		else
+			RecvFromSession(session);
 	}
-	else
+
+	if (pollFds.empty())
+		return;
+
+#ifdef _WIN32
+	const int ret = WSAPoll(pollFds.data(), static_cast<ULONG>(pollFds.size()), 0);
+#elif defined(__POSIX__)
+	const int ret = poll(pollFds.data(), static_cast<nfds_t>(pollFds.size()), 0);
+#endif
+	if (ret <= 0)
 	{
-		bFrame->WritePacket(pkt);
-		InspectRecv(pkt);
+		if (ret < 0)
+			Console.Error("DEV9: Socket: Poll Failed. Error Code: %d",
+#ifdef _WIN32
+				WSAGetLastError());
+#elif defined(__POSIX__)
+				errno);
+#endif
+		return;
+	}
 
-		delete bFrame;
-		return true;
+	for (size_t i = 0; i < pollFds.size(); i++)
+	{
+		//Errors are also reported via revents, Recv() handles them
+		if (pollFds[i].revents == 0)
+			continue;
+
+		BaseSession* session;
+		if (!connections.TryGetValue(pollFdKeys[i], &session))
+			continue;
+
+		RecvFromSession(session);
 	}
-	return false;
+}
+
+void SocketAdapter::RecvFromSession(BaseSession* session)
+{
+	IP_Payload* pl = session->Recv();
+	if (pl == nullptr)
+		return;
+
+	IP_Packet* ipPkt = new IP_Packet(pl);
+	ipPkt->destinationIP = session->sourceIP;
+	ipPkt->sourceIP = session->destIP;
+
+	EthernetFrame* frame = new EthernetFrame(ipPkt);
+	frame->sourceMAC = internalMAC;
+	frame->destinationMAC = ps2MAC;
+	frame->protocol = (u16)EtherType::IPv4;
+
+	vRecBuffer.Enqueue(frame);
 }
 
 bool SocketAdapter::send(NetPacket* pkt)
@@ -14,7 +14,11 @@
  */
 
 #pragma once
+#include <chrono>
 #include <vector>
+#ifdef __POSIX__
+#include <poll.h>
+#endif
 
 #include "net.h"
 
@@ -40,6 +44,18 @@ class SocketAdapter : public NetAdapter
 	ThreadSafeMap<Sessions::ConnectionKey, Sessions::BaseSession*> connections;
 	ThreadSafeMap<u16, Sessions::BaseSession*> fixedUDPPorts;
 
+	//Sessions waiting on their socket are checked with a single poll() call
+	//Kept between calls to avoid reallocating, only accessed by the recv thread
+	std::vector<Sessions::ConnectionKey> pollKeys;
+	std::vector<Sessions::ConnectionKey> pollFdKeys;
+#ifdef _WIN32
+	std::vector<WSAPOLLFD> pollFds;
+#elif defined(__POSIX__)
+	std::vector<pollfd> pollFds;
+#endif
+	//Sessions waiting on their socket still need Recv() called now and then to handle timeouts
+	std::chrono::steady_clock::time_point lastIdleSessionPoll;
+
 public:
 	SocketAdapter();
 	virtual bool blocks();
@@ -64,6 +80,10 @@ private:
 
 	int SendFromConnection(Sessions::ConnectionKey Key, PacketReader::IP::IP_Packet* ipPkt);
 
+	//Calls Recv() on sessions with something to do and queues the returned packets into vRecBuffer
+	void PollSessions();
+	void RecvFromSession(Sessions::BaseSession* session);
+
 	//Event must only be raised once per connection
 	void HandleConnectionClosed(Sessions::BaseSession* sender);
 	void HandleFixedPortClosed(Sessions::BaseSession* sender);
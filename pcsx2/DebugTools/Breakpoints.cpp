@@ -21,6 +21,7 @@
 #include "R5900.h"
 #include "R3000A.h"
 #include "System.h"
+#include "vtlb.h"
 
 std::vector<BreakPoint> CBreakPoints::breakPoints_;
 u32 CBreakPoints::breakSkipFirstAtEE_ = 0;
@@ -435,6 +436,15 @@ void CBreakPoints::Update(BreakPointCpu cpu, u32 addr)
 
 	if (cpu & BREAKPOINT_EE)
 	{
+		// Unmap watched memory from fastmem, so only the accesses which fault on it need checks.
+		std::vector<std::pair<u32, u32>> ranges;
+		for (const MemCheck& check : memChecks_)
+		{
+			if (check.cpu == BREAKPOINT_EE)
+				ranges.emplace_back(check.start, check.end);
+		}
+		vtlb_SetFastmemWatchRanges(std::move(ranges));
+
 		Cpu->Reset();
 	}
 
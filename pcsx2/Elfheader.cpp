@@ -317,7 +317,7 @@ void ElfObject::loadHeaders()
 //   0 - Invalid or unknown disc.
 //   1 - PS1 CD
 //   2 - PS2 CD
-int GetPS2ElfName( std::string& name )
+int GetPS2ElfName( std::string& name, std::string* version )
 {
 	int retype = 0;
 
@@ -365,6 +365,8 @@ int GetPS2ElfName( std::string& name )
 			{
 				Console.WriteLn( Color_Blue, "(SYSTEM.CNF) Software version = %.*s",
 					static_cast<int>(value.size()), value.data());
+				if (version)
+					*version = value;
 			}
 		}
 
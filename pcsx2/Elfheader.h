@@ -155,7 +155,7 @@ class ElfObject
 
 //-------------------
 extern void loadElfFile(const std::string& filename);
-extern int  GetPS2ElfName( std::string& dest );
+extern int  GetPS2ElfName( std::string& dest, std::string* version = nullptr );
 
 
 extern u32 ElfCRC;
@@ -26,6 +26,7 @@
 #include "IconsFontAwesome5.h"
 #include "Recording/InputRecording.h"
 #include "SPU2/spu2.h"
+#include "TimelineTracer.h"
 #include "VMManager.h"
 
 #ifdef ENABLE_ACHIEVEMENTS
@@ -236,6 +237,21 @@ DEFINE_HOTKEY("InputRecToggleMode", "System", "Toggle Input Recording Mode", [](
 	if (!pressed && VMManager::HasValidVM())
 		g_InputRecording.getControls().toggleRecordMode();
 })
+DEFINE_HOTKEY("SaveTimelineTrace", "System", "Save Timeline Trace", [](s32 pressed) {
+	if (pressed || !VMManager::HasValidVM())
+		return;
+
+	if (!TimelineTracer::IsEnabled())
+	{
+		Host::AddIconOSDMessage("SaveTimelineTrace", ICON_FA_EXCLAMATION_TRIANGLE,
+			"Timeline tracer is not enabled (EmuCore/Profiler/TimelineTracer).", Host::OSD_INFO_DURATION);
+		return;
+	}
+
+	const std::string filename(TimelineTracer::SaveTrace());
+	Host::AddIconOSDMessage("SaveTimelineTrace", ICON_FA_STOPWATCH,
+		fmt::format("Saving timeline trace to '{}'.", Path::GetFileName(filename)), Host::OSD_QUICK_DURATION);
+})
 
 DEFINE_HOTKEY("PreviousSaveStateSlot", "Save States", "Select Previous Save Slot", [](s32 pressed) {
 	if (!pressed && VMManager::HasValidVM())
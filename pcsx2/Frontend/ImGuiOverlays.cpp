@@ -235,6 +235,18 @@ void ImGuiManager::DrawPerformanceOverlay()
 				DRAW_LINE(fixed_font, text.c_str(), IM_COL32(255, 255, 255, 255));
 			}
 
+			text = "WAIT:";
+			for (u32 i = 0; i < static_cast<u32>(PerformanceMetrics::StallReason::Count); i++)
+			{
+				const PerformanceMetrics::StallReason reason = static_cast<PerformanceMetrics::StallReason>(i);
+				if (!THREAD_VU1 && (reason == PerformanceMetrics::StallReason::VUXGKick || reason == PerformanceMetrics::StallReason::VUSync))
+					continue;
+
+				fmt::format_to(std::back_inserter(text), " {} {:.1f}/{:.2f}ms", PerformanceMetrics::GetStallReasonName(reason),
+					PerformanceMetrics::GetStallsPerFrame(reason), PerformanceMetrics::GetStallTimePerFrame(reason));
+			}
+			DRAW_LINE(fixed_font, text.c_str(), IM_COL32(255, 255, 255, 255));
+
 			if (GSCapture::IsCapturing())
 			{
 				text = "CAP: ";
@@ -356,6 +368,8 @@ void ImGuiManager::DrawSettingsOverlay()
 		APPEND("IVU ");
 	if (EmuConfig.Speedhacks.vuThread)
 		APPEND("MTVU ");
+	if (EmuConfig.Speedhacks.ipuThread)
+		APPEND("MTIPU ");
 
 	APPEND("EER={} EEC={} VUR={} VUC={} VQS={} ", static_cast<unsigned>(EmuConfig.Cpu.sseMXCSR.GetRoundMode()),
 		EmuConfig.Cpu.Recompiler.GetEEClampMode(), static_cast<unsigned>(EmuConfig.Cpu.sseVU0MXCSR.GetRoundMode()),
@@ -344,6 +344,14 @@ public:
 	Threading::UserspaceSemaphore m_sem_OnRingReset;
 	Threading::UserspaceSemaphore m_sem_Vsync;
 
+	Threading::AdaptiveWaiter m_ring_waiter; // EE waiting for room in the ringbuffer
+	Threading::AdaptiveWaiter m_sync_waiter; // EE waiting for the ringbuffer to empty
+	Threading::AdaptiveWaiter m_xgkick_waiter; // MTGS waiting for MTVU to finish a path1 packet
+
+	// Ringbuffer-full wait time as of the last growth check, see CheckRingBufferGrowth().
+	u64 m_ring_grow_wait_ns = 0;
+	u32 m_ring_grow_frames = 0;
+
 	// used to keep multiple threads from sending packets to the ringbuffer concurrently.
 	// (currently not used or implemented -- is a planned feature for a future threaded VU1)
 	//MutexLockRecursive m_PacketLocker;
@@ -430,6 +438,10 @@ protected:
 
 	void GenericStall(uint size);
 
+	// Reallocates the ringbuffer, which must be empty. EE thread only.
+	void ResizeRingBuffer(uint size_factor);
+	void CheckRingBufferGrowth();
+
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
 };
@@ -472,28 +484,33 @@ void gsIrq();
 extern tGS_CSR CSRr;
 
 // Size of the ringbuffer as a power of 2 -- size is a multiple of simd128s.
-// (actual size is 1<<m_RingBufferSizeFactor simd vectors [128-bit values])
+// (actual size is 1<<SizeFactor simd vectors [128-bit values])
 // A value of 19 is a 8meg ring buffer.  18 would be 4 megs, and 20 would be 16 megs.
 // Default was 2mb, but some games with lots of MTGS activity want 8mb to run fast (rama)
-static const uint RingBufferSizeFactor = 19;
-
-// size of the ringbuffer in simd128's.
-static const uint RingBufferSize = 1 << RingBufferSizeFactor;
-
-// Mask to apply to ring buffer indices to wrap the pointer from end to
-// start (the wrapping is what makes it a ringbuffer, yo!)
-static const uint RingBufferMask = RingBufferSize - 1;
+// The size is picked from EmuConfig.GS.MTGSRingBufferSize when the GS opens, and can grow
+// from there if the EE keeps stalling on a full ring.
+static constexpr uint RingBufferSizeFactorMin = 17;
+static constexpr uint RingBufferSizeFactorDefault = 19;
+static constexpr uint RingBufferSizeFactorMax = 22;
 
 struct MTGS_BufferedData
 {
-	u128 m_Ring[RingBufferSize];
+	u128* m_Ring = nullptr;
+
+	// size of the ringbuffer in simd128's.
+	uint m_Size = 0;
+
+	// Mask to apply to ring buffer indices to wrap the pointer from end to
+	// start (the wrapping is what makes it a ringbuffer, yo!)
+	uint m_Mask = 0;
+
 	u8 Regs[Ps2MemSize::GSregs];
 
 	MTGS_BufferedData() {}
 
 	u128& operator[](uint idx)
 	{
-		pxAssert(idx < RingBufferSize);
+		pxAssert(idx < m_Size);
 		return m_Ring[idx];
 	}
 };
@@ -25,6 +25,7 @@
 #include "Renderers/HW/GSRendererHW.h"
 #include "Renderers/HW/GSTextureReplacements.h"
 #include "GSLzma.h"
+#include "GSXXH.h"
 #include "MultiISA.h"
 
 #include "common/Console.h"
@@ -565,6 +566,14 @@ void GSsetGameCRC(u32 crc)
 	g_gs_renderer->SetGameCRC(crc);
 }
 
+u64 GSGetLocalMemoryHash()
+{
+	// Only meaningful for the software renderer, hardware renderers don't write back to local memory.
+	// The rasterizer threads may still be drawing this frame, so wait for them first.
+	g_gs_renderer->SyncLocalMem();
+	return GSXXH3_64bits(g_gs_renderer->m_mem.m_vm8, GSLocalMemory::m_vmsize);
+}
+
 GSVideoMode GSgetDisplayMode()
 {
 	GSRenderer* gs = g_gs_renderer.get();
@@ -75,6 +75,7 @@ void GSEndCapture();
 void GSPresentCurrentFrame();
 void GSThrottlePresentation();
 void GSsetGameCRC(u32 crc);
+u64 GSGetLocalMemoryHash();
 
 GSVideoMode GSgetDisplayMode();
 void GSgetInternalResolution(int* width, int* height);
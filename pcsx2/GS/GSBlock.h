@@ -56,6 +56,14 @@ class GSBlock
 	}
 #endif
 
+#if _M_SSE >= 0x600
+	// Looks up both sets of 8 indices with a single 16 wide VPGATHERDD
+	static __m512i Gather32_32x16(const GSVector8i& lo, const GSVector8i& hi, const u32* RESTRICT pal)
+	{
+		return _mm512_i32gather_epi32(_mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1), pal, 4);
+	}
+#endif
+
 public:
 	template <int i, int alignment, u32 mask>
 	__forceinline static void WriteColumn32(u8* RESTRICT dst, const u8* RESTRICT src, int srcpitch)
@@ -1541,7 +1549,30 @@ public:
 	{
 		//printf("ReadAndExpandBlock8_32\n");
 
-#if _M_SSE >= 0x501
+#if _M_SSE >= 0x600
+
+		const GSVector8i* s = (const GSVector8i*)src;
+
+		GSVector8i v0, v1;
+		GSVector8i mask = GSVector8i::x000000ff();
+
+		for (int i = 0; i < 4; i++)
+		{
+			// Same source order as below, (0, 1), (3, 2), (4, 5), (7, 6)
+			LoadSW128(v0, v1, &s[i * 2 + (i & 1)], &s[i * 2 + 1 - (i & 1)]);
+			GSVector8i::sw64(v0, v1);
+
+			_mm512_storeu_si512(dst + dstpitch * 0, Gather32_32x16((v0      ) & mask, (v0 >> 16) & mask, pal));
+			_mm512_storeu_si512(dst + dstpitch * 1, Gather32_32x16((v1      ) & mask, (v1 >> 16) & mask, pal));
+			v0 = v0.cdab();
+			v1 = v1.cdab();
+			_mm512_storeu_si512(dst + dstpitch * 2, Gather32_32x16((v0 >>  8) & mask, (v0 >> 24)       , pal));
+			_mm512_storeu_si512(dst + dstpitch * 3, Gather32_32x16((v1 >>  8) & mask, (v1 >> 24)       , pal));
+
+			dst += dstpitch * 4;
+		}
+
+#elif _M_SSE >= 0x501
 
 		const GSVector8i* s = (const GSVector8i*)src;
 
@@ -1834,7 +1865,26 @@ public:
 	{
 		//printf("ReadAndExpandBlock8H_32\n");
 
-#if _M_SSE >= 0x501
+#if _M_SSE >= 0x600
+
+		const GSVector8i* s = (const GSVector8i*)src;
+		for (int i = 0; i < 4; i++)
+		{
+			GSVector8i v0, v1;
+
+			LoadSW128(v0, v1, &s[i * 2 + 0], &s[i * 2 + 1]);
+			GSVector8i::sw64(v0, v1);
+
+			const __m512i c = Gather32_32x16(v0 >> 24, v1 >> 24, pal);
+
+			*reinterpret_cast<GSVector8i*>(dst) = GSVector8i(_mm512_castsi512_si256(c));
+			dst += dstpitch;
+
+			*reinterpret_cast<GSVector8i*>(dst) = GSVector8i(_mm512_extracti64x4_epi64(c, 1));
+			dst += dstpitch;
+		}
+
+#elif _M_SSE >= 0x501
 
 		const GSVector8i* s = (const GSVector8i*)src;
 		for (int i = 0; i < 4; i++)
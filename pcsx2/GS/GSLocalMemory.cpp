@@ -67,8 +67,18 @@ GSLocalMemory::GSLocalMemory()
 	if (!m_vm8)
 		throw std::bad_alloc();
 
+	// The software renderer is all over this, so it's worth keeping the TLB misses down.
+	// It's shared memory on Linux, so this only takes effect when /dev/shm is mounted with huge=.
+	const bool huge_pages = EmuConfig.HugePages && HostSys::AdviseHugePages(m_vm8, m_vmsize * 4);
+
 	memset(m_vm8, 0, m_vmsize);
 
+	if (huge_pages)
+	{
+		Console.WriteLn("GS local memory: %zu of %zu KB in huge pages",
+			HostSys::GetHugePageMappedSize(m_vm8, m_vmsize) / 1024, m_vmsize / 1024);
+	}
+
 	MULTI_ISA_SELECT(GSLocalMemoryPopulateFunctions)(*this);
 
 	for (psm_t& psm : m_psm)
@@ -446,6 +456,35 @@ std::vector<GSVector2i>* GSLocalMemory::GetPage2TileMap(const GIFRegTEX0& TEX0)
 	return p2t;
 }
 
+void GSLocalMemory::MarkPagesWritten(const GSOffset& off, const GSVector4i& r)
+{
+	// Transfers wrap at 2048, don't bother working out where.
+	if (r.z > 2048 || r.w > 2048)
+	{
+		MarkAllPagesWritten();
+		return;
+	}
+
+	const u64 generation = ++m_write_generation;
+	off.loopPages(r, [this, generation](u32 page) { m_page_write_generation[page] = generation; });
+}
+
+void GSLocalMemory::MarkAllPagesWritten()
+{
+	const u64 generation = ++m_write_generation;
+	std::fill(std::begin(m_page_write_generation), std::end(m_page_write_generation), generation);
+}
+
+bool GSLocalMemory::WasWrittenSince(const GSOffset& off, const GSVector4i& r, u64 generation) const
+{
+	bool written = false;
+	off.pageLooperForRect(r).loopPagesWithBreak([this, generation, &written](u32 page) {
+		written = m_page_write_generation[page] > generation;
+		return !written;
+	});
+	return written;
+}
+
 ///////////////////
 
 void GSLocalMemory::ReadTexture(const GSOffset& off, const GSVector4i& r, u8* dst, int dstpitch, const GIFRegTEXA& TEXA)
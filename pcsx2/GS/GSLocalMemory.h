@@ -521,6 +521,9 @@ protected:
 	std::unordered_map<u32, GSPixelOffset4*> m_po4map;
 	std::unordered_map<u64, std::vector<GSVector2i>*> m_p2tmap;
 
+	u64 m_write_generation = 0;
+	u64 m_page_write_generation[MAX_PAGES] = {};
+
 public:
 	GSLocalMemory();
 	~GSLocalMemory();
@@ -536,6 +539,20 @@ public:
 	GSPixelOffset4* GetPixelOffset4(const GIFRegFRAME& FRAME, const GIFRegZBUF& ZBUF);
 	std::vector<GSVector2i>* GetPage2TileMap(const GIFRegTEX0& TEX0);
 
+	// write tracking
+
+	/// Returns the generation of the most recent write, any later write gets a higher one.
+	u64 GetWriteGeneration() const { return m_write_generation; }
+
+	/// Marks the pages touched by the rect as written.
+	void MarkPagesWritten(const GSOffset& off, const GSVector4i& r);
+
+	/// Marks all of local memory as written, for resets and state loads.
+	void MarkAllPagesWritten();
+
+	/// Returns true if any page touched by the rect was written after the given generation.
+	bool WasWrittenSince(const GSOffset& off, const GSVector4i& r, u64 generation) const;
+
 	// address
 
 	static u32 BlockNumber32(int x, int y, u32 bp, u32 bw)
@@ -978,11 +995,13 @@ public:
 
 	void WritePixel32(u8* RESTRICT src, u32 pitch, const GSOffset& off, const GSVector4i& r)
 	{
+		MarkPagesWritten(off, r);
 		off.loopPixels(r, vm32(), (u32*)src, pitch, [&](u32* dst, u32* src) { *dst = *src; });
 	}
 
 	void WritePixel24(u8* RESTRICT src, u32 pitch, const GSOffset& off, const GSVector4i& r)
 	{
+		MarkPagesWritten(off, r);
 		off.loopPixels(r, vm32(), (u32*)src, pitch,
 		[&](u32* dst, u32* src)
 		{
@@ -992,6 +1011,7 @@ public:
 
 	void WritePixel16(u8* RESTRICT src, u32 pitch, const GSOffset& off, const GSVector4i& r)
 	{
+		MarkPagesWritten(off, r);
 		off.loopPixels(r, vm16(), (u16*)src, pitch, [&](u16* dst, u16* src) { *dst = *src; });
 	}
 
@@ -1107,15 +1107,40 @@ struct alignas(32) GIFPath
 	u32 reg;
 	u32 type;
 	GSVector4i regs;
+	u32 fused;
 
 	enum
 	{
 		TYPE_UNKNOWN,
 		TYPE_ADONLY,
 		TYPE_STQRGBAXYZF2,
-		TYPE_STQRGBAXYZ2
+		TYPE_STQRGBAXYZ2,
+		TYPE_FUSED
 	};
 
+	struct FusedPattern
+	{
+		u64 regs;
+		u32 nreg;
+	};
+
+	// REGS combinations which get a handler with the register sequence unrolled at compile time.
+	// Only vertex registers (RGBA, STQ, UV, XYZF2, XYZ2, FOG, NOP) are allowed, so PRIM can't
+	// change in the middle of the loop. Use the packed REGS profile in dev builds to find new ones.
+	static constexpr FusedPattern FUSED_PATTERNS[] = {
+		{0x0401, 2}, // RGBA XYZF2
+		{0x0501, 2}, // RGBA XYZ2
+		{0x040103, 3}, // UV RGBA XYZF2
+		{0x050103, 3}, // UV RGBA XYZ2
+		{0x040201, 3}, // RGBA STQ XYZF2
+		{0x050201, 3}, // RGBA STQ XYZ2
+		{0x04010f0f02, 5}, // mgs3
+		{0x0401020f0f, 5}, // mgs3
+		{0x040f010f02, 5}, // xeno2
+		{0x04010f020f, 5}, // xeno2
+	};
+	static constexpr u32 FUSED_PATTERN_COUNT = static_cast<u32>(std::size(FUSED_PATTERNS));
+
 	__forceinline void SetTag(const void* mem)
 	{
 		const GIFTag* RESTRICT src = (const GIFTag*)mem;
@@ -1156,13 +1181,12 @@ struct alignas(32) GIFPath
 					case 2:
 						break;
 					case 3:
-						// many games, TODO: formats mixed with NOPs (xeno2: 040f010f02, 04010f020f, mgs3: 04010f0f02, 0401020f0f, 04010f020f)
+						// many games, formats mixed with NOPs are in FUSED_PATTERNS
 						if (regs.U32[0] == 0x00040102)
 							type = TYPE_STQRGBAXYZF2;
 						// GoW (has other crazy formats, like ...030503050103)
 						if (regs.U32[0] == 0x00050102)
 							type = TYPE_STQRGBAXYZ2;
-						// TODO: common types with UV instead
 						break;
 					case 4:
 						break;
@@ -1207,6 +1231,19 @@ struct alignas(32) GIFPath
 					default:
 						__assume(0);
 				}
+
+				if (type == TYPE_UNKNOWN && nreg <= 8)
+				{
+					for (u32 i = 0; i < FUSED_PATTERN_COUNT; i++)
+					{
+						if (FUSED_PATTERNS[i].nreg == nreg && FUSED_PATTERNS[i].regs == regs.U64[0])
+						{
+							type = TYPE_FUSED;
+							fused = i;
+							break;
+						}
+					}
+				}
 			}
 		}
 	}
@@ -119,6 +119,10 @@ GSState::GSState()
 
 GSState::~GSState()
 {
+#if defined(PCSX2_DEVBUILD) || defined(_DEBUG)
+	DumpPackedRegsProfile();
+#endif
+
 	if (m_vertex.buff)
 		_aligned_free(m_vertex.buff);
 	if (m_index.buff)
@@ -141,7 +145,10 @@ void GSState::Reset(bool hardware_reset)
 
 	// FIXME: bios logo not shown cut in half after reset, missing graphics in GoW after first FMV
 	if (hardware_reset)
+	{
 		memset(m_mem.m_vm8, 0, m_mem.m_vmsize);
+		m_mem.MarkAllPagesWritten();
+	}
 	memset(&m_path, 0, sizeof(m_path));
 	memset(&m_v, 0, sizeof(m_v));
 
@@ -192,7 +199,8 @@ void GSState::SetPrimHandlers()
 	m_fpGIFRegHandlerXYZ[P][2] = &GSState::GIFRegHandlerXYZ2<P, 0, auto_flush, index_swap>; \
 	m_fpGIFRegHandlerXYZ[P][3] = &GSState::GIFRegHandlerXYZ2<P, 1, auto_flush, index_swap>; \
 	m_fpGIFPackedRegHandlerSTQRGBAXYZF2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZF2<P, auto_flush, index_swap>; \
-	m_fpGIFPackedRegHandlerSTQRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZ2<P, auto_flush, index_swap>;
+	m_fpGIFPackedRegHandlerSTQRGBAXYZ2[P] = &GSState::GIFPackedRegHandlerSTQRGBAXYZ2<P, auto_flush, index_swap>; \
+	SetFusedHandlers<P, auto_flush, index_swap>(std::make_index_sequence<GIFPath::FUSED_PATTERN_COUNT>());
 
 	SetHandlerXYZ(GS_POINTLIST, true, false);
 	SetHandlerXYZ(GS_LINELIST, auto_flush, index_swap);
@@ -206,6 +214,12 @@ void GSState::SetPrimHandlers()
 #undef SetHandlerXYZ
 }
 
+template <u32 prim, bool auto_flush, bool index_swap, size_t... i>
+void GSState::SetFusedHandlers(std::index_sequence<i...>)
+{
+	((m_fpGIFPackedRegHandlerFused[prim][i] = &GSState::GIFPackedRegHandlerFused<prim, auto_flush, index_swap, static_cast<u32>(i)>), ...);
+}
+
 void GSState::ResetHandlers()
 {
 	std::fill(std::begin(m_fpGIFPackedRegHandlers), std::end(m_fpGIFPackedRegHandlers), &GSState::GIFPackedRegHandlerNull);
@@ -934,10 +948,121 @@ void GSState::GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, u32
 	m_q = r[-3].STQ.Q; // remember the last one, STQ outputs this to the temp Q each time
 }
 
+template <u32 prim, bool auto_flush, bool index_swap, u32 reg>
+__forceinline void GSState::GIFPackedRegHandlerFusedReg(const GIFPackedReg* RESTRICT r, bool uv_hack)
+{
+	if constexpr (reg == GIF_REG_RGBA)
+	{
+		GIFPackedRegHandlerRGBA(r);
+	}
+	else if constexpr (reg == GIF_REG_STQ)
+	{
+		GIFPackedRegHandlerSTQ(r);
+	}
+	else if constexpr (reg == GIF_REG_UV)
+	{
+		if (uv_hack)
+			GIFPackedRegHandlerUV_Hack(r);
+		else
+			GIFPackedRegHandlerUV(r);
+	}
+	else if constexpr (reg == GIF_REG_XYZF2)
+	{
+		GIFPackedRegHandlerXYZF2<prim, 0, auto_flush, index_swap>(r);
+	}
+	else if constexpr (reg == GIF_REG_XYZ2)
+	{
+		GIFPackedRegHandlerXYZ2<prim, 0, auto_flush, index_swap>(r);
+	}
+	else if constexpr (reg == GIF_REG_FOG)
+	{
+		GIFPackedRegHandlerFOG(r);
+	}
+	else
+	{
+		static_assert(reg == GIF_REG_NOP, "Register not allowed in a fused pattern");
+	}
+}
+
+template <u32 prim, bool auto_flush, bool index_swap, u32 pattern, size_t... i>
+__forceinline void GSState::GIFPackedRegHandlerFusedLoop(const GIFPackedReg* RESTRICT r, u32 size, std::index_sequence<i...>)
+{
+	constexpr u64 regs = GIFPath::FUSED_PATTERNS[pattern].regs;
+	constexpr u32 nreg = GIFPath::FUSED_PATTERNS[pattern].nreg;
+
+	const bool uv_hack = (m_fpGIFPackedRegHandlers[GIF_REG_UV] == &GSState::GIFPackedRegHandlerUV_Hack);
+	const GIFPackedReg* RESTRICT r_end = r + size;
+
+	while (r < r_end)
+	{
+		(GIFPackedRegHandlerFusedReg<prim, auto_flush, index_swap, static_cast<u32>((regs >> (i * 8)) & 0xf)>(&r[i], uv_hack), ...);
+
+		r += nreg;
+	}
+}
+
+template <u32 prim, bool auto_flush, bool index_swap, u32 pattern>
+void GSState::GIFPackedRegHandlerFused(const GIFPackedReg* RESTRICT r, u32 size)
+{
+	constexpr u32 nreg = GIFPath::FUSED_PATTERNS[pattern].nreg;
+
+	ASSERT(size > 0 && size % nreg == 0);
+
+	GIFPackedRegHandlerFusedLoop<prim, auto_flush, index_swap, pattern>(r, size, std::make_index_sequence<nreg>());
+}
+
 void GSState::GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, u32 size)
 {
 }
 
+#if defined(PCSX2_DEVBUILD) || defined(_DEBUG)
+
+void GSState::ProfilePackedRegs(const GIFPath& path, u32 qwords)
+{
+	// Open addressing, combinations seen after the table fills up aren't counted.
+	const u64 lo = path.regs.U64[0];
+	const u64 hi = path.regs.U64[1];
+	const u32 mask = static_cast<u32>(m_packed_regs_profile.size()) - 1;
+	u32 index = static_cast<u32>(((lo ^ (hi * 31) ^ path.nreg) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+	for (u32 i = 0; i <= mask; i++, index = (index + 1) & mask)
+	{
+		PackedRegsProfileEntry& entry = m_packed_regs_profile[index];
+		if (entry.tags == 0)
+		{
+			entry.regs_lo = lo;
+			entry.regs_hi = hi;
+			entry.nreg = path.nreg;
+		}
+		else if (entry.regs_lo != lo || entry.regs_hi != hi || entry.nreg != path.nreg)
+		{
+			continue;
+		}
+
+		entry.tags++;
+		entry.qwords += qwords;
+		return;
+	}
+}
+
+void GSState::DumpPackedRegsProfile()
+{
+	std::array<PackedRegsProfileEntry, 64> entries = m_packed_regs_profile;
+	std::sort(entries.begin(), entries.end(), [](const PackedRegsProfileEntry& a, const PackedRegsProfileEntry& b) { return a.qwords > b.qwords; });
+
+	for (u32 i = 0; i < 16 && entries[i].tags > 0; i++)
+	{
+		const PackedRegsProfileEntry& entry = entries[i];
+		DevCon.WriteLn("GS: Packed REGS %016llx%016llx NREG %u: %llu tags, %llu qwords",
+			static_cast<unsigned long long>(entry.regs_hi), static_cast<unsigned long long>(entry.regs_lo), entry.nreg,
+			static_cast<unsigned long long>(entry.tags), static_cast<unsigned long long>(entry.qwords));
+	}
+
+	m_packed_regs_profile = {};
+}
+
+#endif
+
 void GSState::GIFRegHandlerNull(const GIFReg* RESTRICT r)
 {
 }
@@ -1754,6 +1879,7 @@ void GSState::FlushWrite()
 	r.bottom = r.top + m_env.TRXREG.RRH;
 	ExpandTarget(m_env.BITBLTBUF, r);
 	InvalidateVideoMem(m_env.BITBLTBUF, r, true);
+	m_mem.MarkPagesWritten(m_mem.GetOffset(m_env.BITBLTBUF.DBP, m_env.BITBLTBUF.DBW, m_env.BITBLTBUF.DPSM), r);
 
 	const GSLocalMemory::writeImage wi = GSLocalMemory::m_psm[m_env.BITBLTBUF.DPSM].wi;
 
@@ -2016,6 +2142,7 @@ void GSState::Write(const u8* mem, int len)
 		r.bottom = r.top + m_env.TRXREG.RRH;
 		ExpandTarget(m_env.BITBLTBUF, r);
 		InvalidateVideoMem(blit, r, true);
+		m_mem.MarkPagesWritten(m_mem.GetOffset(blit.DBP, blit.DBW, blit.DPSM), r);
 
 		psm.wi(m_mem, m_tr.x, m_tr.y, mem, m_tr.total, blit, m_env.TRXPOS, m_env.TRXREG);
 
@@ -2084,6 +2211,86 @@ void GSState::Read(u8* mem, int len)
 	}
 }
 
+bool GSState::MoveBlocks()
+{
+	// Block-granular copy for the common case of a same-format, block-aligned transfer.
+	// Both sides use the same swizzle, so every source block lands whole on one destination
+	// block and the pixel order within it is unchanged.
+	const u32 psm = m_env.BITBLTBUF.SPSM;
+	const GSLocalMemory::psm_t& psm_s = GSLocalMemory::m_psm[psm];
+	if (psm != m_env.BITBLTBUF.DPSM || psm_s.bpp != psm_s.trbpp || psm_s.trbpp == 24)
+		return false;
+
+	const int sx = m_env.TRXPOS.SSAX;
+	const int sy = m_env.TRXPOS.SSAY;
+	const int dx = m_env.TRXPOS.DSAX;
+	const int dy = m_env.TRXPOS.DSAY;
+	const int w = m_env.TRXREG.RRW;
+	const int h = m_env.TRXREG.RRH;
+	const u32 sbw = m_env.BITBLTBUF.SBW;
+	const u32 dbw = m_env.BITBLTBUF.DBW;
+
+	const GSVector4i mask = GSVector4i(psm_s.bs.x - 1, psm_s.bs.y - 1).xyxy();
+	if (w == 0 || h == 0 || sbw == 0 || dbw == 0 ||
+		!(GSVector4i(sx, sy, dx, dy) & mask).eq(GSVector4i::zero()) ||
+		!(GSVector4i(w, h, w, h) & mask).eq(GSVector4i::zero()) ||
+		(std::max(sx, dx) + w) > 2048 || (std::max(sy, dy) + h) > 2048)
+	{
+		return false;
+	}
+
+	const GSOffset spo = m_mem.GetOffset(m_env.BITBLTBUF.SBP, sbw, psm);
+	const GSOffset dpo = m_mem.GetOffset(m_env.BITBLTBUF.DBP, dbw, psm);
+	const int bw = w / psm_s.bs.x;
+	const int bh = h / psm_s.bs.y;
+
+	// The transfer direction only matters when a destination block is also a source block,
+	// leave those to the pixel loop which copies in the order the GS does.
+	u32 src_blocks[MAX_BLOCKS / 32] = {};
+	for (int by = 0; by < bh; by++)
+	{
+		for (int bx = 0; bx < bw; bx++)
+		{
+			const u32 bn = spo.bn(sx + bx * psm_s.bs.x, sy + by * psm_s.bs.y) % MAX_BLOCKS;
+			src_blocks[bn >> 5] |= 1u << (bn & 31);
+		}
+	}
+	for (int by = 0; by < bh; by++)
+	{
+		for (int bx = 0; bx < bw; bx++)
+		{
+			const u32 bn = dpo.bn(dx + bx * psm_s.bs.x, dy + by * psm_s.bs.y) % MAX_BLOCKS;
+			if (src_blocks[bn >> 5] & (1u << (bn & 31)))
+				return false;
+		}
+	}
+
+	for (int by = 0; by < bh; by++)
+	{
+		for (int bx = 0; bx < bw; bx++)
+		{
+			const GSVector4i* RESTRICT s = reinterpret_cast<const GSVector4i*>(
+				m_mem.BlockPtr(spo.bn(sx + bx * psm_s.bs.x, sy + by * psm_s.bs.y)));
+			GSVector4i* RESTRICT d = reinterpret_cast<GSVector4i*>(
+				m_mem.BlockPtr(dpo.bn(dx + bx * psm_s.bs.x, dy + by * psm_s.bs.y)));
+
+			for (int i = 0; i < 16; i += 4)
+			{
+				const GSVector4i v0 = s[i + 0];
+				const GSVector4i v1 = s[i + 1];
+				const GSVector4i v2 = s[i + 2];
+				const GSVector4i v3 = s[i + 3];
+				d[i + 0] = v0;
+				d[i + 1] = v1;
+				d[i + 2] = v2;
+				d[i + 3] = v3;
+			}
+		}
+	}
+
+	return true;
+}
+
 void GSState::Move()
 {
 	// ffxii uses this to move the top/bottom of the scrolling menus offscreen and then blends them back over the text to create a shading effect
@@ -2148,6 +2355,11 @@ void GSState::Move()
 	}
 	// Invalid the CLUT if it crosses paths.
 	m_mem.m_clut.InvalidateRange(write_start_bp, write_end_bp);
+	// After the flush above, so hashes taken by that draw don't outlive the copy.
+	m_mem.MarkPagesWritten(dpo, GSVector4i(m_env.TRXPOS.DSAX, m_env.TRXPOS.DSAY, m_env.TRXPOS.DSAX + w, m_env.TRXPOS.DSAY + h));
+
+	if (MoveBlocks())
+		return;
 
 	auto genericCopy = [=](const GSOffset& dpo, const GSOffset& spo, auto&& getPAHelper, auto&& pxCopyFn)
 	{
@@ -2407,6 +2619,10 @@ void GSState::Transfer(const u8* mem, u32 size)
 						{
 							case GIFPath::TYPE_UNKNOWN:
 							{
+#if defined(PCSX2_DEVBUILD) || defined(_DEBUG)
+								ProfilePackedRegs(path, total);
+#endif
+
 								u32 reg = 0;
 
 								do
@@ -2439,6 +2655,12 @@ void GSState::Transfer(const u8* mem, u32 size)
 
 								mem += total * sizeof(GIFPackedReg);
 
+								break;
+							case GIFPath::TYPE_FUSED:
+								(this->*m_fpGIFPackedRegHandlersFused[path.fused])((GIFPackedReg*)mem, total);
+
+								mem += total * sizeof(GIFPackedReg);
+
 								break;
 							default:
 								__assume(0);
@@ -2712,6 +2934,7 @@ int GSState::Defrost(const freezeData* fd)
 	ReadState(&m_tr.x, data);
 	ReadState(&m_tr.y, data);
 	ReadState(m_mem.m_vm8, data, m_mem.m_vmsize);
+	m_mem.MarkAllPagesWritten();
 
 	m_tr.total = 0; // TODO: restore transfer state
 
@@ -2798,6 +3021,7 @@ void GSState::UpdateVertexKick()
 
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZF2] = m_fpGIFPackedRegHandlerSTQRGBAXYZF2[prim];
 	m_fpGIFPackedRegHandlersC[GIF_REG_STQRGBAXYZ2] = m_fpGIFPackedRegHandlerSTQRGBAXYZ2[prim];
+	std::copy(std::begin(m_fpGIFPackedRegHandlerFused[prim]), std::end(m_fpGIFPackedRegHandlerFused[prim]), m_fpGIFPackedRegHandlersFused);
 }
 
 void GSState::GrowVertexBuffer()
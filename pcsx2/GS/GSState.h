@@ -66,11 +66,33 @@ private:
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersC[2];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZF2[8];
 	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerSTQRGBAXYZ2[8];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlersFused[GIFPath::FUSED_PATTERN_COUNT];
+	GIFPackedRegHandlerC m_fpGIFPackedRegHandlerFused[8][GIFPath::FUSED_PATTERN_COUNT];
 
 	template<u32 prim, bool auto_flush, bool index_swap> void GIFPackedRegHandlerSTQRGBAXYZF2(const GIFPackedReg* RESTRICT r, u32 size);
 	template<u32 prim, bool auto_flush, bool index_swap> void GIFPackedRegHandlerSTQRGBAXYZ2(const GIFPackedReg* RESTRICT r, u32 size);
+	template<u32 prim, bool auto_flush, bool index_swap, u32 pattern> void GIFPackedRegHandlerFused(const GIFPackedReg* RESTRICT r, u32 size);
+	template<u32 prim, bool auto_flush, bool index_swap, u32 reg> void GIFPackedRegHandlerFusedReg(const GIFPackedReg* RESTRICT r, bool uv_hack);
+	template<u32 prim, bool auto_flush, bool index_swap, u32 pattern, size_t... i> void GIFPackedRegHandlerFusedLoop(const GIFPackedReg* RESTRICT r, u32 size, std::index_sequence<i...>);
+	template<u32 prim, bool auto_flush, bool index_swap, size_t... i> void SetFusedHandlers(std::index_sequence<i...>);
 	void GIFPackedRegHandlerNOP(const GIFPackedReg* RESTRICT r, u32 size);
 
+#if defined(PCSX2_DEVBUILD) || defined(_DEBUG)
+	struct PackedRegsProfileEntry
+	{
+		u64 regs_lo, regs_hi;
+		u32 nreg;
+		u64 tags;
+		u64 qwords;
+	};
+
+	// GIFtag REGS/NREG combinations which went through the per-register packed loop.
+	std::array<PackedRegsProfileEntry, 64> m_packed_regs_profile = {};
+
+	void ProfilePackedRegs(const GIFPath& path, u32 qwords);
+	void DumpPackedRegsProfile();
+#endif
+
 	template<int i> void ApplyTEX0(GIFRegTEX0& TEX0);
 	void ApplyPRIM(u32 prim);
 
@@ -137,6 +159,7 @@ private:
 
 private:
 	void CalcAlphaMinMax();
+	bool MoveBlocks();
 
 protected:
 	GSVertex m_v;
@@ -349,6 +372,8 @@ public:
 	virtual void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool eewrite = false) {}
 	virtual void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false) {}
 	virtual void ExpandTarget(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r) {}
+	// Waits for anything still writing to local memory behind our back (the SW rasterizer threads).
+	virtual void SyncLocalMem() {}
 
 	virtual void Move();
 
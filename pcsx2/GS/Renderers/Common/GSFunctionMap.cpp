@@ -40,6 +40,7 @@ void GSCodeReserve::Reset()
 {
 	RecompiledCodeReserve::Reset();
 	m_memory_used = 0;
+	Perf::gs.reset();
 }
 
 u8* GSCodeReserve::Reserve(size_t size)
@@ -19,6 +19,7 @@
 #include "GS/Renderers/SW/GSScanlineEnvironment.h"
 #include "VirtualMemory.h"
 #include "common/emitter/tools.h"
+#include "common/Perf.h"
 
 template <class KEY, class VALUE>
 class GSFunctionMap
@@ -28,6 +29,7 @@ protected:
 	{
 		u64 frame, frames, prims;
 		u64 ticks, actual, total;
+		u64 uses; // counted even without draw stats, for GetKeysByUsage()
 		VALUE f;
 	};
 
@@ -74,6 +76,8 @@ public:
 			m_active = p;
 		}
 
+		m_active->uses++;
+
 		return m_active->f;
 	}
 
@@ -96,6 +100,20 @@ public:
 		}
 	}
 
+	/// Returns every key which has been looked up, most used first.
+	std::vector<KEY> GetKeysByUsage() const
+	{
+		std::vector<std::pair<KEY, ActivePtr*>> sorted(std::begin(m_map_active), std::end(m_map_active));
+		std::sort(std::begin(sorted), std::end(sorted), [](const auto& l, const auto& r) { return l.second->uses > r.second->uses; });
+
+		std::vector<KEY> keys;
+		keys.reserve(sorted.size());
+		for (const auto& i : sorted)
+			keys.push_back(i.first);
+
+		return keys;
+	}
+
 	virtual void PrintStats()
 	{
 		u64 totalTicks = 0;
@@ -157,6 +175,9 @@ public:
 
 	size_t GetMemoryUsed() const { return m_memory_used; }
 
+	/// Held while generating code, since selectors can be precompiled off the GS thread.
+	std::mutex& GetLock() { return m_lock; }
+
 	void Assign(VirtualMemoryManagerPtr allocator);
 	void Reset();
 
@@ -165,6 +186,7 @@ public:
 
 private:
 	size_t m_memory_used = 0;
+	std::mutex m_lock;
 };
 
 template <class CG, class KEY, class VALUE>
@@ -185,11 +207,30 @@ public:
 
 	void Clear()
 	{
+		std::unique_lock lock(GSCodeReserve::GetInstance().GetLock());
 		m_cgmap.clear();
 	}
 
+	/// Generates the function for key ahead of time, unless the code buffer has already reached
+	/// max_memory_used. Returns false if there wasn't room. Safe to call from any thread.
+	bool Precompile(KEY key, size_t max_memory_used)
+	{
+		{
+			std::unique_lock lock(GSCodeReserve::GetInstance().GetLock());
+			if (m_cgmap.find(key) != m_cgmap.end())
+				return true;
+			if ((GSCodeReserve::GetInstance().GetMemoryUsed() + MAX_SIZE) > max_memory_used)
+				return false;
+		}
+
+		GetDefaultFunction(key);
+		return true;
+	}
+
 	VALUE GetDefaultFunction(KEY key)
 	{
+		std::unique_lock lock(GSCodeReserve::GetInstance().GetLock());
+
 		VALUE ret = nullptr;
 
 		auto i = m_cgmap.find(key);
@@ -216,6 +257,8 @@ public:
 
 			m_cgmap[key] = ret;
 
+			Perf::gs.map((uptr)ret, (u32)cg.getSize(), m_name.c_str(), (u64)key);
+
 #ifdef ENABLE_VTUNE
 
 			// vtune method registration
@@ -33,6 +33,23 @@ public:
 
 MULTI_ISA_UNSHARED_IMPL;
 
+#if _M_SSE >= 0x600
+/// Reduces the four 128-bit lanes of v with op, the result ends up in the lowest lane.
+template <typename Op>
+static __forceinline __m512i ReduceLanes(__m512i v, Op op)
+{
+	v = op(v, _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return op(v, _mm512_shuffle_i32x4(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+template <typename Op>
+static __forceinline __m512 ReduceLanes(__m512 v, Op op)
+{
+	v = op(v, _mm512_shuffle_f32x4(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return op(v, _mm512_shuffle_f32x4(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+#endif
+
 void CURRENT_ISA::GSVertexTracePopulateFunctions(GSVertexTrace& vt, bool provoking_vertex_first)
 {
 	GSVertexTraceFMM::Populate(vt, provoking_vertex_first);
@@ -182,9 +199,89 @@ void GSVertexTraceFMM::FindMinMax(GSVertexTrace& vt, const void* vertex, const u
 		pmax = pmax.max_u32(p0.max_u32(p1));
 	};
 
+#if _M_SSE >= 0x600
+	// Same as processVertices(), but for two pairs at once with one vertex in each 128-bit lane.
+	// The lanes are folded back into the accumulators above once all vertices have been seen.
+	__m512 tmin4 = _mm512_set1_ps(FLT_MAX);
+	__m512 tmax4 = _mm512_set1_ps(-FLT_MAX);
+	__m512i cmin4 = _mm512_set1_epi32(-1);
+	__m512i cmax4 = _mm512_setzero_si512();
+	__m512i pmin4 = _mm512_set1_epi32(-1);
+	__m512i pmax4 = _mm512_setzero_si512();
+
+	auto processVertices4 = [&](const GSVertex& v0, const GSVertex& v1, const GSVertex& v2, const GSVertex& v3, bool finalVertex)
+	{
+		const __m512i m0 = _mm512_inserti32x4(_mm512_inserti32x4(_mm512_inserti32x4(
+			_mm512_castsi128_si512(v0.m[0]), v1.m[0], 1), v2.m[0], 2), v3.m[0], 3);
+		const __m512i m1 = _mm512_inserti32x4(_mm512_inserti32x4(_mm512_inserti32x4(
+			_mm512_castsi128_si512(v0.m[1]), v1.m[1], 1), v2.m[1], 2), v3.m[1], 3);
+
+		if (color)
+		{
+			// RGBA is in z, it's moved to x when the lanes are folded.
+			if (iip || finalVertex)
+			{
+				cmin4 = _mm512_min_epu8(cmin4, m0);
+				cmax4 = _mm512_max_epu8(cmax4, m0);
+			}
+			else if (n == 2)
+			{
+				const __m512i c = flat_swapped ?
+					_mm512_shuffle_i32x4(m0, m0, _MM_SHUFFLE(2, 2, 0, 0)) :
+					_mm512_shuffle_i32x4(m0, m0, _MM_SHUFFLE(3, 3, 1, 1));
+				cmin4 = _mm512_min_epu8(cmin4, c);
+				cmax4 = _mm512_max_epu8(cmax4, c);
+			}
+		}
+
+		if (tme)
+		{
+			if (!fst)
+			{
+				const __m512 stq = _mm512_castsi512_ps(m0);
+
+				__m512 q = _mm512_permute_ps(stq, _MM_SHUFFLE(3, 3, 3, 3));
+				if (primclass == GS_SPRITE_CLASS)
+					q = _mm512_shuffle_f32x4(q, q, _MM_SHUFFLE(3, 3, 1, 1));
+
+				// Only s and t are divided, the (often denormal) rgba field is masked off.
+				const __m512 st = _mm512_mask_div_ps(q, 0x3333, stq, q);
+
+				tmin4 = _mm512_min_ps(tmin4, st);
+				tmax4 = _mm512_max_ps(tmax4, st);
+			}
+			else
+			{
+				const __m512i uv = _mm512_unpackhi_epi16(m1, _mm512_setzero_si512());
+				const __m512 st = _mm512_permute_ps(_mm512_cvtepi32_ps(uv), _MM_SHUFFLE(1, 0, 1, 0));
+
+				tmin4 = _mm512_min_ps(tmin4, st);
+				tmax4 = _mm512_max_ps(tmax4, st);
+			}
+		}
+
+		const __m512i xy = _mm512_unpacklo_epi16(m1, _mm512_setzero_si512());
+		__m512i zf = _mm512_shuffle_epi32(m1, static_cast<_MM_PERM_ENUM>(_MM_SHUFFLE(3, 1, 3, 1)));
+		if (primclass == GS_SPRITE_CLASS)
+			zf = _mm512_shuffle_i32x4(zf, zf, _MM_SHUFFLE(3, 3, 1, 1));
+
+		const __m512i p = _mm512_mask_blend_epi32(0xCCCC, xy, zf);
+
+		pmin4 = _mm512_min_epu32(pmin4, p);
+		pmax4 = _mm512_max_epu32(pmax4, p);
+	};
+#endif
+
 	if (n == 2)
 	{
-		for (int i = 0; i < count; i += 2)
+		int i = 0;
+#if _M_SSE >= 0x600
+		for (; i < (count - 3); i += 4)
+		{
+			processVertices4(v[index[i + 0]], v[index[i + 1]], v[index[i + 2]], v[index[i + 3]], false);
+		}
+#endif
+		for (; i < count; i += 2)
 		{
 			processVertices(v[index[i + 0]], v[index[i + 1]], false);
 		}
@@ -192,6 +289,12 @@ void GSVertexTraceFMM::FindMinMax(GSVertexTrace& vt, const void* vertex, const u
 	else if (iip || n == 1) // iip means final and non-final vertexes are treated the same
 	{
 		int i = 0;
+#if _M_SSE >= 0x600
+		for (; i < (count - 3); i += 4)
+		{
+			processVertices4(v[index[i + 0]], v[index[i + 1]], v[index[i + 2]], v[index[i + 3]], true);
+		}
+#endif
 		for (; i < (count - 1); i += 2) // 2x loop unroll
 		{
 			processVertices(v[index[i + 0]], v[index[i + 1]], true);
@@ -235,6 +338,33 @@ void GSVertexTraceFMM::FindMinMax(GSVertexTrace& vt, const void* vertex, const u
 		pxAssertRel(0, "Bad n value");
 	}
 
+#if _M_SSE >= 0x600
+	if (n != 3 || iip)
+	{
+		const auto min_ps = [](__m512 a, __m512 b) { return _mm512_min_ps(a, b); };
+		const auto max_ps = [](__m512 a, __m512 b) { return _mm512_max_ps(a, b); };
+		const auto min_u8 = [](__m512i a, __m512i b) { return _mm512_min_epu8(a, b); };
+		const auto max_u8 = [](__m512i a, __m512i b) { return _mm512_max_epu8(a, b); };
+		const auto min_u32 = [](__m512i a, __m512i b) { return _mm512_min_epu32(a, b); };
+		const auto max_u32 = [](__m512i a, __m512i b) { return _mm512_max_epu32(a, b); };
+
+		if (color)
+		{
+			cmin = cmin.min_u8(GSVector4i(_mm512_castsi512_si128(ReduceLanes(cmin4, min_u8))).zzzz());
+			cmax = cmax.max_u8(GSVector4i(_mm512_castsi512_si128(ReduceLanes(cmax4, max_u8))).zzzz());
+		}
+
+		if (tme)
+		{
+			tmin = tmin.min(GSVector4(_mm512_castps512_ps128(ReduceLanes(tmin4, min_ps))));
+			tmax = tmax.max(GSVector4(_mm512_castps512_ps128(ReduceLanes(tmax4, max_ps))));
+		}
+
+		pmin = pmin.min_u32(GSVector4i(_mm512_castsi512_si128(ReduceLanes(pmin4, min_u32))));
+		pmax = pmax.max_u32(GSVector4i(_mm512_castsi512_si128(ReduceLanes(pmax4, max_u32))));
+	}
+#endif
+
 	GSVector4 o(context->XYOFFSET);
 	GSVector4 s(1.0f / 16, 1.0f / 16, 2.0f, 1.0f);
 
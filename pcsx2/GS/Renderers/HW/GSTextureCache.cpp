@@ -26,6 +26,35 @@
 
 static u8* s_unswizzle_buffer;
 
+namespace
+{
+	struct TextureHashMemoKey
+	{
+		u64 TEX0[MAXIMUM_TEXTURE_MIPMAP_LEVELS];
+		u64 TEXA;
+
+		__fi bool operator==(const TextureHashMemoKey& e) const { return std::memcmp(this, &e, sizeof(*this)) == 0; }
+	};
+
+	struct TextureHashMemoKeyHash
+	{
+		__fi u64 operator()(const TextureHashMemoKey& key) const { return GSXXH3_64bits(&key, sizeof(key)); }
+	};
+
+	struct TextureHashMemo
+	{
+		GSTextureCache::HashType hash;
+		u64 generation; ///< Local memory write generation when the hash was calculated.
+	};
+} // namespace
+
+// Hashes are kept until one of the pages the texture covers is written, so looking up the
+// same unmodified texture again (new CLUT/TEXA, or its source was dropped by a neighbouring
+// write) doesn't have to hash it again. The hash is of the whole texture, since dumped and
+// replaced textures are named by it.
+static std::unordered_map<TextureHashMemoKey, TextureHashMemo, TextureHashMemoKeyHash> s_texture_hash_memo;
+static constexpr size_t TEXTURE_HASH_MEMO_MAX_SIZE = 4096;
+
 GSTextureCache::GSTextureCache()
 {
 	// In theory 4MB is enough but 9MB is safer for overflow (8MB
@@ -57,6 +86,7 @@ void GSTextureCache::RemovePartial()
 			delete t;
 
 		m_dst[type].clear();
+		m_dst_map[type].RemoveAll();
 	}
 }
 
@@ -70,6 +100,7 @@ void GSTextureCache::RemoveAll()
 			delete t;
 
 		m_dst[type].clear();
+		m_dst_map[type].RemoveAll();
 	}
 
 	for (auto it : m_hash_cache)
@@ -78,6 +109,7 @@ void GSTextureCache::RemoveAll()
 	m_hash_cache.clear();
 	m_hash_cache_memory_usage = 0;
 	m_hash_cache_replacement_memory_usage = 0;
+	s_texture_hash_memo.clear();
 
 	m_palette_map.Clear();
 	m_target_heights.clear();
@@ -135,40 +167,34 @@ GSTextureCache::Source* GSTextureCache::LookupDepthSource(const GIFRegTEX0& TEX0
 	const u32 bp = TEX0.TBP0;
 	const u32 psm = TEX0.PSM;
 
-	for (auto t : m_dst[DepthStencil])
+	// Perfect Match
+	dst = FindTarget(DepthStencil, bp, bp, [bp, psm](const Target* t) {
+		return t->m_age == 0 && t->m_used && t->m_dirty.empty() && GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM);
+	});
+
+	if (!dst)
 	{
-		if (t->m_used && t->m_dirty.empty() && GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM))
-		{
-			ASSERT(GSLocalMemory::m_psm[t->m_TEX0.PSM].depth);
-			if (t->m_age == 0)
+		// Better than nothing (Full Spectrum Warrior), the least recently used one wins.
+		m_dst_map[DepthStencil].ForEach(bp, bp, [bp, psm, &dst](Target* t) {
+			if (t->m_age == 1 && t->m_used && t->m_dirty.empty() && GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM) &&
+				(!dst || t->m_mru_seq < dst->m_mru_seq))
 			{
-				// Perfect Match
 				dst = t;
-				break;
 			}
-			else if (t->m_age == 1)
-			{
-				// Better than nothing (Full Spectrum Warrior)
-				dst = t;
-			}
-		}
+		});
 	}
 
 	if (!dst)
 	{
 		// Retry on the render target (Silent Hill 4)
-		for (auto t : m_dst[RenderTarget])
-		{
-			// FIXME: do I need to allow m_age == 1 as a potential match (as DepthStencil) ???
-			if (!t->m_age && t->m_used && t->m_dirty.empty() && GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM))
-			{
-				ASSERT(GSLocalMemory::m_psm[t->m_TEX0.PSM].depth);
-				dst = t;
-				break;
-			}
-		}
+		// FIXME: do I need to allow m_age == 1 as a potential match (as DepthStencil) ???
+		dst = FindTarget(RenderTarget, bp, bp, [bp, psm](const Target* t) {
+			return !t->m_age && t->m_used && t->m_dirty.empty() && GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM);
+		});
 	}
 
+	ASSERT(!dst || GSLocalMemory::m_psm[dst->m_TEX0.PSM].depth);
+
 	if (dst)
 	{
 		GL_CACHE("TC depth: dst %s hit: %d (0x%x, %s)", to_string(dst->m_type),
@@ -484,76 +510,62 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, con
 	};
 
 	Target* dst = nullptr;
-	auto& list = m_dst[type];
 	Target* old_found = nullptr;
 
 	if (!is_frame)
 	{
-		for (auto i = list.begin(); i != list.end(); ++i)
+		dst = FindTarget(type, bp, bp, [](const Target*) { return true; });
+		if (dst)
 		{
-			Target* t = *i;
-
-			if (bp == t->m_TEX0.TBP0)
-			{
-				list.MoveFront(i.Index());
-
-				dst = t;
+			MoveTargetFront(dst);
 
-				dst->m_32_bits_fmt |= (psm_s.bpp != 16);
-				dst->m_TEX0 = TEX0;
-
-				break;
-			}
+			dst->m_32_bits_fmt |= (psm_s.bpp != 16);
+			dst->m_TEX0 = TEX0;
 		}
 	}
 	else
 	{
 		assert(type == RenderTarget);
 		// Let's try to find a perfect frame that contains valid data
-		for (auto t : list)
-		{
-			// Only checks that the texure starts at the requested bp, size isn't considered.
-			if (bp == t->m_TEX0.TBP0 && t->m_end_block >= bp)
-			{
-				// If the frame is older than 30 frames (0.5 seconds) then it hasn't been updated for ages, so it's probably not a valid output frame.
-				// The rest of the checks will get better equality, so suffer less from misdetection.
-				// Kind of arbitrary but it's low enough to not break Grandia Xtreme and high enough not to break Mission Impossible Operation Surma.
-				if (t->m_age > 30 && !old_found)
-				{
-					old_found = t;
-					continue;
-				}
+		// Only checks that the texure starts at the requested bp, size isn't considered.
+		const auto perfect_match = [bp](const Target* t) { return t->m_end_block >= bp; };
+		dst = FindTarget(RenderTarget, bp, bp, perfect_match);
 
-				dst = t;
-				GL_CACHE("TC: Lookup Frame %dx%d, perfect hit: %d (0x%x -> 0x%x %s)", size.x, size.y, dst->m_texture->GetID(), bp, t->m_end_block, psm_str(TEX0.PSM));
-				if (real_h > 0 || real_w > 0)
-					ScaleTargetForDisplay(dst, TEX0, real_w, real_h);
+		// If the frame is older than 30 frames (0.5 seconds) then it hasn't been updated for ages, so it's probably not a valid output frame.
+		// The rest of the checks will get better equality, so suffer less from misdetection.
+		// Kind of arbitrary but it's low enough to not break Grandia Xtreme and high enough not to break Mission Impossible Operation Surma.
+		if (dst && dst->m_age > 30)
+		{
+			old_found = dst;
+			dst = FindTarget(RenderTarget, bp, bp, [&perfect_match, old_found](const Target* t) { return t != old_found && perfect_match(t); });
+		}
 
-				break;
-			}
+		if (dst)
+		{
+			GL_CACHE("TC: Lookup Frame %dx%d, perfect hit: %d (0x%x -> 0x%x %s)", size.x, size.y, dst->m_texture->GetID(), bp, dst->m_end_block, psm_str(TEX0.PSM));
+			if (real_h > 0 || real_w > 0)
+				ScaleTargetForDisplay(dst, TEX0, real_w, real_h);
 		}
 
 		// 2nd try ! Try to find a frame at the requested bp -> bp + size is inside of (or equal to)
 		if (!dst)
 		{
 			const u32 needed_end = GSLocalMemory::m_psm[TEX0.PSM].info.bn(real_w - 1, real_h - 1, bp, TEX0.TBW);
-			for (auto t : list)
-			{
+			dst = FindTarget(RenderTarget, m_dst_map[RenderTarget].GetSpanStart(bp), bp, [&](Target* t) {
 				// Make sure the target is inside the texture
-				if (t->m_TEX0.TBP0 <= bp && bp <= t->m_end_block && t->Inside(bp, TEX0.TBW, TEX0.PSM, GSVector4i(0, 0, real_w, real_h)))
-				{
-					// If we already have an old one, make sure the "new" one matches at least on one end (double buffer?).
-					if (old_found && (t->m_age > 4 || (t->m_TEX0.TBP0 != bp && needed_end != t->m_end_block)))
-						continue;
+				if (!(t->m_TEX0.TBP0 <= bp && bp <= t->m_end_block && t->Inside(bp, TEX0.TBW, TEX0.PSM, GSVector4i(0, 0, real_w, real_h))))
+					return false;
 
-					dst = t;
-					GL_CACHE("TC: Lookup Frame %dx%d, inclusive hit: %d (0x%x, took 0x%x -> 0x%x %s)", size.x, size.y, t->m_texture->GetID(), bp, t->m_TEX0.TBP0, t->m_end_block, psm_str(TEX0.PSM));
+				// If we already have an old one, make sure the "new" one matches at least on one end (double buffer?).
+				return !(old_found && (t->m_age > 4 || (t->m_TEX0.TBP0 != bp && needed_end != t->m_end_block)));
+			});
 
-					if (real_h > 0 || real_w > 0)
-						ScaleTargetForDisplay(dst, TEX0, real_w, real_h);
+			if (dst)
+			{
+				GL_CACHE("TC: Lookup Frame %dx%d, inclusive hit: %d (0x%x, took 0x%x -> 0x%x %s)", size.x, size.y, dst->m_texture->GetID(), bp, dst->m_TEX0.TBP0, dst->m_end_block, psm_str(TEX0.PSM));
 
-					break;
-				}
+				if (real_h > 0 || real_w > 0)
+					ScaleTargetForDisplay(dst, TEX0, real_w, real_h);
 			}
 		}
 
@@ -565,15 +577,9 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, con
 		// 3rd try ! Try to find a frame that doesn't contain valid data (honestly I'm not sure we need to do it)
 		if (!dst)
 		{
-			for (auto t : list)
-			{
-				if (bp == t->m_TEX0.TBP0)
-				{
-					dst = t;
-					GL_CACHE("TC: Lookup Frame %dx%d, empty hit: %d (0x%x -> 0x%x %s)", size.x, size.y, dst->m_texture->GetID(), bp, t->m_end_block, psm_str(TEX0.PSM));
-					break;
-				}
-			}
+			dst = FindTarget(RenderTarget, bp, bp, [](const Target*) { return true; });
+			if (dst)
+				GL_CACHE("TC: Lookup Frame %dx%d, empty hit: %d (0x%x -> 0x%x %s)", size.x, size.y, dst->m_texture->GetID(), bp, dst->m_end_block, psm_str(TEX0.PSM));
 		}
 
 		if (dst)
@@ -609,21 +615,13 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(const GIFRegTEX0& TEX0, con
 
 		// Depth stencil/RT can be an older RT/DS but only check recent RT/DS to avoid to pick
 		// some bad data.
-		Target* dst_match = nullptr;
-		for (auto t : m_dst[rev_type])
+		Target* dst_match = FindTarget(rev_type, bp, bp, [](const Target* t) { return t->m_age == 0; });
+		if (!dst_match)
 		{
-			if (bp == t->m_TEX0.TBP0)
-			{
-				if (t->m_age == 0)
-				{
+			m_dst_map[rev_type].ForEach(bp, bp, [&dst_match](Target* t) {
+				if (t->m_age == 1 && (!dst_match || t->m_mru_seq < dst_match->m_mru_seq))
 					dst_match = t;
-					break;
-				}
-				else if (t->m_age == 1)
-				{
-					dst_match = t;
-				}
-			}
+			});
 		}
 
 		if (dst_match)
@@ -800,25 +798,15 @@ void GSTextureCache::ExpandTarget(const GIFRegBITBLTBUF& BITBLTBUF, const GSVect
 	TEX0.TBP0 = BITBLTBUF.DBP;
 	TEX0.TBW = BITBLTBUF.DBW;
 	TEX0.PSM = BITBLTBUF.DPSM;
-	Target* dst = nullptr;
-	auto& list = m_dst[RenderTarget];
-
-	for (auto i = list.begin(); i != list.end(); ++i)
-	{
-		Target* t = *i;
-
-		if (TEX0.TBP0 == t->m_TEX0.TBP0 && TEX0.PSM == t->m_TEX0.PSM && t->Overlaps(TEX0.TBP0, TEX0.TBW, TEX0.PSM, r))
-		{
-			list.MoveFront(i.Index());
+	Target* dst = FindTarget(RenderTarget, TEX0.TBP0, TEX0.TBP0, [&TEX0, &r](Target* t) {
+		return TEX0.PSM == t->m_TEX0.PSM && t->Overlaps(TEX0.TBP0, TEX0.TBW, TEX0.PSM, r);
+	});
 
-			dst = t;
-			break;
-		}
-	}
-	
 	if (!dst)
 		return;
 
+	MoveTargetFront(dst);
+
 	// Only expand the target when the FBW matches. Otherwise, games like GT4 will end up with the main render target
 	// being 2000+ due to unrelated EE writes.
 	if (TEX0.TBW == dst->m_TEX0.TBW)
@@ -861,22 +849,14 @@ void GSTextureCache::InvalidateVideoMemType(int type, u32 bp)
 	if (g_gs_renderer->m_game.title == CRC::GetawayGames)
 		return;
 
-	auto& list = m_dst[type];
-	for (auto i = list.begin(); i != list.end(); ++i)
+	Target* t = FindTarget(type, bp, bp, [](const Target*) { return true; });
+	if (t)
 	{
-		Target* t = *i;
+		GL_CACHE("TC: InvalidateVideoMemType: Remove Target(%s) %d (0x%x)", to_string(type),
+			t->m_texture ? t->m_texture->GetID() : 0,
+			t->m_TEX0.TBP0);
 
-		if (bp == t->m_TEX0.TBP0)
-		{
-			GL_CACHE("TC: InvalidateVideoMemType: Remove Target(%s) %d (0x%x)", to_string(type),
-				t->m_texture ? t->m_texture->GetID() : 0,
-				t->m_TEX0.TBP0);
-
-			list.erase(i);
-			delete t;
-
-			break;
-		}
+		RemoveTarget(t);
 	}
 }
 
@@ -888,6 +868,9 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 	u32 bw = off.bw();
 	u32 psm = off.psm();
 
+	// Memory behind the rect is about to change (or has, for SW draws), so memoised hashes can't be trusted.
+	g_gs_renderer->m_mem.MarkPagesWritten(off, rect);
+
 	if (!target)
 	{
 		// Remove Source that have same BP as the render target (color&dss)
@@ -1024,14 +1007,23 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 	if (!target)
 		return;
 
+	// Only targets starting around the written blocks can be affected, see the conditions below:
+	// - at bp itself (shared bits/alpha),
+	// - after bp, up to the last row of the write (dirty after),
+	// - containing or overlapping the written blocks (dirty in the middle).
+	const GSLocalMemory::psm_t& psm_s = GSLocalMemory::m_psm[psm];
+	const u32 start_block = psm_s.info.bn(rect.x, rect.y, bp, bw);
+	const u32 end_block = psm_s.info.bn(rect.z - 1, rect.w - 1, bp, bw);
+	const u32 after_blocks = ((r.bottom + psm_s.pgs.y - 1) / psm_s.pgs.y) * bw * 32;
+	const bool wraps = end_block < bp;
+
 	for (int type = 0; type < 2; type++)
 	{
-		auto& list = m_dst[type];
-		for (auto i = list.begin(); i != list.end();)
-		{
-			auto j = i;
-			Target* t = *j;
+		const TargetMap& map = m_dst_map[type];
+		const u32 start_bp = wraps ? 0 : map.GetSpanStart(std::min(bp, start_block));
+		const u32 end_bp = wraps ? MAX_BP : std::max(bp + after_blocks, end_block);
 
+		map.ForEach(start_bp, end_bp, [&](Target* t) {
 			// GH: (I think) this code is completely broken. Typical issue:
 			// EE write an alpha channel into 32 bits texture
 			// Results: the target is deleted (because HasCompatibleBits is false)
@@ -1089,15 +1081,12 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 					}
 					if (!ComputeSurfaceOffset(off, r, t).is_valid)
 					{
-						i = list.erase(j);
 						GL_CACHE("TC: Remove Target(%s) %d (0x%x)", to_string(type),
 							t->m_texture ? t->m_texture->GetID() : 0,
 							t->m_TEX0.TBP0);
-						delete t;
+						RemoveTarget(t);
 					}
-					else
-						++i;
-					continue;
+					return;
 				}
 			}
 			else if (bp == t->m_TEX0.TBP0)
@@ -1109,8 +1098,6 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 				t->m_dirty_alpha = false;
 			}
 
-			++i;
-
 			// GH: Try to detect texture write that will overlap with a target buffer
 			// TODO Use ComputeSurfaceOffset below.
 			if (GSUtil::HasSharedBits(psm, t->m_TEX0.PSM))
@@ -1143,7 +1130,7 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 
 							const GSVector4i dirty_r = GSVector4i(r.left, r.top - y, r.right, r.bottom - y);
 							AddDirtyRectTarget(t, dirty_r, psm, bw);
-							continue;
+							return;
 						}
 					}
 				}
@@ -1176,7 +1163,7 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 
 						const GSVector4i dirty_r = GSVector4i(r.left, r.top + y, r.right, r.bottom + y);
 						AddDirtyRectTarget(t, dirty_r, psm, bw);
-						continue;
+						return;
 					}
 				}
 				else if (GSConfig.UserHacks_TextureInsideRt && t->Overlaps(bp, bw, psm, rect) && GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
@@ -1192,7 +1179,7 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 				}
 #endif
 			}
-		}
+		});
 	}
 }
 
@@ -1225,10 +1212,10 @@ void GSTextureCache::InvalidateLocalMem(const GSOffset& off, const GSVector4i& r
 
 		if (!GSConfig.UserHacks_DisableDepthSupport)
 		{
-			auto& dss = m_dst[DepthStencil];
-			for (auto it = dss.rbegin(); it != dss.rend(); ++it)  // Iterate targets from LRU to MRU.
+			std::vector<Target*> dss;
+			GetTargetsLRUToMRU(DepthStencil, bp, bp, dss);
+			for (Target* t : dss)
 			{
-				Target* t = *it;
 				if (GSUtil::HasSharedBits(bp, psm, t->m_TEX0.TBP0, t->m_TEX0.PSM))
 				{
 					if (GSUtil::HasCompatibleBits(psm, t->m_TEX0.PSM))
@@ -1243,10 +1230,11 @@ void GSTextureCache::InvalidateLocalMem(const GSOffset& off, const GSVector4i& r
 	// It works for all the games mentioned below and fixes a couple of other ones as well
 	// (Busen0: Wizardry and Chaos Legion).
 	// Also in a few games the below code ran the Grandia3 case when it shouldn't :p
-	auto& rts = m_dst[RenderTarget];
-	for (auto it = rts.rbegin(); it != rts.rend(); ++it)  // Iterate targets from LRU to MRU.
+	// Only targets starting within the read blocks can pass the overlap check below.
+	std::vector<Target*> rts;
+	GetTargetsLRUToMRU(RenderTarget, bp, GSLocalMemory::m_psm[psm].info.bn(r.z - 1, r.w - 1, bp, bw), rts);
+	for (Target* t : rts)
 	{
-		Target* t = *it;
 		if (t->m_TEX0.PSM != PSM_PSMZ32 && t->m_TEX0.PSM != PSM_PSMZ24 && t->m_TEX0.PSM != PSM_PSMZ16 && t->m_TEX0.PSM != PSM_PSMZ16S)
 		{
 			// Some games like to offset their GS download memory addresses by
@@ -1587,29 +1575,23 @@ bool GSTextureCache::ShuffleMove(u32 BP, u32 BW, u32 PSM, int sx, int sy, int dx
 
 GSTextureCache::Target* GSTextureCache::GetExactTarget(u32 BP, u32 BW, u32 PSM) const
 {
-	auto& rts = m_dst[GSLocalMemory::m_psm[PSM].depth ? DepthStencil : RenderTarget];
-	for (auto it = rts.begin(); it != rts.end(); ++it) // Iterate targets from MRU to LRU.
-	{
-		Target* t = *it;
-		if (t->m_TEX0.TBP0 == BP && t->m_TEX0.TBW == BW && t->m_TEX0.PSM == PSM)
-			return t;
-	}
-
-	return nullptr;
+	return FindTarget(GSLocalMemory::m_psm[PSM].depth ? DepthStencil : RenderTarget, BP, BP, [BW, PSM](const Target* t) {
+		return t->m_TEX0.TBW == BW && t->m_TEX0.PSM == PSM;
+	});
 }
 
 GSTextureCache::Target* GSTextureCache::GetTargetWithSharedBits(u32 BP, u32 PSM) const
 {
-	auto& rts = m_dst[GSLocalMemory::m_psm[PSM].depth ? DepthStencil : RenderTarget];
-	for (auto it = rts.begin(); it != rts.end(); ++it) // Iterate targets from MRU to LRU.
-	{
-		Target* t = *it;
+	return FindTarget(GSLocalMemory::m_psm[PSM].depth ? DepthStencil : RenderTarget, BP, BP, [BP, PSM](const Target* t) {
 		u32 t_psm = (t->m_dirty_alpha) ? t->m_TEX0.PSM & ~0x1 : t->m_TEX0.PSM;
-		if (GSUtil::HasSharedBits(BP, PSM, t->m_TEX0.TBP0, t_psm))
-			return t;
-	}
+		return GSUtil::HasSharedBits(BP, PSM, t->m_TEX0.TBP0, t_psm);
+	});
+}
 
-	return nullptr;
+void GSTextureCache::GetTargetsLRUToMRU(int type, u32 start_bp, u32 end_bp, std::vector<Target*>& targets) const
+{
+	m_dst_map[type].ForEach(start_bp, end_bp, [&targets](Target* t) { targets.push_back(t); });
+	std::sort(targets.begin(), targets.end(), [](const Target* lhs, const Target* rhs) { return lhs->m_mru_seq < rhs->m_mru_seq; });
 }
 
 u32 GSTextureCache::GetTargetHeight(u32 fbp, u32 fbw, u32 psm, u32 min_height)
@@ -1620,25 +1602,22 @@ u32 GSTextureCache::GetTargetHeight(u32 fbp, u32 fbw, u32 psm, u32 min_height)
 	search.psm = psm;
 	search.height = min_height;
 
-	for (auto it = m_target_heights.begin(); it != m_target_heights.end(); ++it)
+	auto it = m_target_heights.find(search.bits);
+	if (it != m_target_heights.end())
 	{
-		TargetHeightElem& elem = const_cast<TargetHeightElem&>(*it);
-		if (elem.bits == search.bits)
+		TargetHeightElem& elem = it->second;
+		if (elem.height < min_height)
 		{
-			if (elem.height < min_height)
-			{
-				DbgCon.WriteLn("Expand height at %x %u %u from %u to %u", fbp, fbw, psm, elem.height, min_height);
-				elem.height = min_height;
-			}
-
-			m_target_heights.MoveFront(it.Index());
-			elem.age = 0;
-			return elem.height;
+			DbgCon.WriteLn("Expand height at %x %u %u from %u to %u", fbp, fbw, psm, elem.height, min_height);
+			elem.height = min_height;
 		}
+
+		elem.age = 0;
+		return elem.height;
 	}
 
 	DbgCon.WriteLn("New height at %x %u %u: %u", fbp, fbw, psm, min_height);
-	m_target_heights.push_front(search);
+	m_target_heights.emplace(search.bits, search);
 	return min_height;
 }
 
@@ -1651,25 +1630,16 @@ void GSTextureCache::InvalidateVideoMemSubTarget(GSTextureCache::Target* rt)
 	if (!rt)
 		return;
 
-	auto& list = m_dst[RenderTarget];
-
-	for (auto i = list.begin(); i != list.end();)
-	{
-		Target* t = *i;
-
+	// Sub targets start and end strictly inside rt.
+	m_dst_map[RenderTarget].ForEach(rt->m_TEX0.TBP0 + 1, rt->m_end_block, [this, rt](Target* t) {
 		if ((t->m_TEX0.TBP0 > rt->m_TEX0.TBP0) && (t->m_end_block < rt->m_end_block) && (t->m_TEX0.TBW == rt->m_TEX0.TBW) && (t->m_TEX0.TBP0 < t->m_end_block))
 		{
 			GL_INS("InvalidateVideoMemSubTarget: rt 0x%x -> 0x%x, sub rt 0x%x -> 0x%x",
 				rt->m_TEX0.TBP0, rt->m_end_block, t->m_TEX0.TBP0, t->m_end_block);
 
-			i = list.erase(i);
-			delete t;
+			RemoveTarget(t);
 		}
-		else
-		{
-			++i;
-		}
-	}
+	});
 }
 
 void GSTextureCache::IncAge()
@@ -1729,6 +1699,10 @@ void GSTextureCache::IncAge()
 
 	for (int type = 0; type < 2; type++)
 	{
+		// Recompute the span bound from the targets which are left, it only grows in between.
+		TargetMap& map = m_dst_map[type];
+		map.m_max_span = 0;
+
 		auto& list = m_dst[type];
 		for (auto i = list.begin(); i != list.end();)
 		{
@@ -1744,25 +1718,25 @@ void GSTextureCache::IncAge()
 				t->m_32_bits_fmt = false;
 			}
 
+			++i;
 			if (++t->m_age > max_rt_age)
 			{
-				i = list.erase(i);
 				GL_CACHE("TC: Remove Target(%s): %d (0x%x) due to age", to_string(type),
 					t->m_texture ? t->m_texture->GetID() : 0,
 					t->m_TEX0.TBP0);
 
-				delete t;
+				RemoveTarget(t);
 			}
 			else
 			{
-				++i;
+				map.UpdateSpan(t);
 			}
 		}
 	}
 
 	for (auto it = m_target_heights.begin(); it != m_target_heights.end();)
 	{
-		TargetHeightElem& elem = const_cast<TargetHeightElem&>(*it);
+		TargetHeightElem& elem = it->second;
 		if (elem.age >= max_rt_age)
 		{
 			it = m_target_heights.erase(it);
@@ -2295,11 +2269,26 @@ GSTextureCache::Target* GSTextureCache::CreateTarget(const GIFRegTEX0& TEX0, int
 	t->m_texture->SetScale(static_cast<GSRendererHW*>(g_gs_renderer.get())->GetTextureScaleFactor());
 	m_target_memory_usage += t->m_texture->GetMemUsage();
 
-	m_dst[type].push_front(t);
+	t->m_dst_it = m_dst[type].InsertFront(t);
+	t->m_mru_seq = ++m_dst_mru_seq;
+	m_dst_map[type].Add(t);
 
 	return t;
 }
 
+void GSTextureCache::MoveTargetFront(Target* t)
+{
+	m_dst[t->m_type].MoveFront(t->m_dst_it);
+	t->m_mru_seq = ++m_dst_mru_seq;
+}
+
+void GSTextureCache::RemoveTarget(Target* t)
+{
+	m_dst[t->m_type].EraseIndex(t->m_dst_it);
+	m_dst_map[t->m_type].Remove(t);
+	delete t;
+}
+
 GSTexture* GSTextureCache::LookupPaletteSource(u32 CBP, u32 CPSM, u32 CBW, GSVector2i& offset, const GSVector2i& size)
 {
 	for (auto t : m_dst[RenderTarget])
@@ -2971,6 +2960,7 @@ void GSTextureCache::Target::UpdateValidity(const GSVector4i& rect)
 	// at the moment, we blow the valid rect out to twice the size. The only thing stopping everything breaking is the fact
 	// that we clamp the draw rect to the target size in GSRendererHW::Draw().
 	m_end_block = GSLocalMemory::m_psm[m_TEX0.PSM].info.bn(m_valid.z - 1, m_valid.w - 1, m_TEX0.TBP0, m_TEX0.TBW); // Valid only for color formats
+	GSRendererHW::GetInstance()->GetTextureCache()->m_dst_map[m_type].UpdateSpan(this);
 
 	// GL_CACHE("UpdateValidity (0x%x->0x%x) from R:%d,%d Valid: %d,%d", m_TEX0.TBP0, m_end_block, rect.z, rect.w, m_valid.z, m_valid.w);
 }
@@ -3113,6 +3103,42 @@ void GSTextureCache::SourceMap::RemoveAt(Source* s)
 	delete s;
 }
 
+// GSTextureCache::TargetMap
+
+void GSTextureCache::TargetMap::Add(Target* t)
+{
+	const u32 page = t->m_TEX0.TBP0 >> 5;
+	t->m_map_it = m_map[page].InsertFront(t);
+	m_pages[page >> 5] |= 1u << (page & 31);
+	UpdateSpan(t);
+}
+
+void GSTextureCache::TargetMap::Remove(Target* t)
+{
+	const u32 page = t->m_TEX0.TBP0 >> 5;
+	m_map[page].EraseIndex(t->m_map_it);
+	if (m_map[page].empty())
+		m_pages[page >> 5] &= ~(1u << (page & 31));
+}
+
+void GSTextureCache::TargetMap::RemoveAll()
+{
+	for (FastList<Target*>& item : m_map)
+	{
+		item.clear();
+	}
+
+	memset(m_pages, 0, sizeof(m_pages));
+	m_max_span = 0;
+}
+
+void GSTextureCache::TargetMap::UpdateSpan(const Target* t)
+{
+	// Targets which haven't been validated yet end before they start, they can't cover anything.
+	if (t->m_end_block > t->m_TEX0.TBP0)
+		m_max_span = std::max(m_max_span, t->m_end_block - t->m_TEX0.TBP0);
+}
+
 void GSTextureCache::AttachPaletteToSource(Source* s, u16 pal, bool need_gs_texture)
 {
 	s->m_palette_obj = m_palette_map.LookupPalette(pal, need_gs_texture);
@@ -3633,12 +3659,47 @@ static void HashTextureLevel(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Blo
 	}
 }
 
-GSTextureCache::HashType GSTextureCache::HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
+static GSTextureCache::HashType HashTextureLevels(const GIFRegTEX0* levels, int count, const GIFRegTEXA& TEXA)
 {
+	GSLocalMemory& mem = g_gs_renderer->m_mem;
+
+	TextureHashMemoKey key = {};
+	for (int i = 0; i < count; i++)
+		key.TEX0[i] = levels[i].U64 & 0x3ffffffffull; // TBP0 TBW PSM TW TH
+	key.TEXA = TEXA.U64 & 0x000000FF000080FFULL;
+
+	auto it = s_texture_hash_memo.find(key);
+	if (it != s_texture_hash_memo.end())
+	{
+		bool written = false;
+		for (int i = 0; i < count && !written; i++)
+		{
+			const GIFRegTEX0& TEX0 = levels[i];
+			const GSVector4i rect(GSVector4i(0, 0, 1 << TEX0.TW, 1 << TEX0.TH).ralign<Align_Outside>(GSLocalMemory::m_psm[TEX0.PSM].bs));
+			written = mem.WasWrittenSince(mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM), rect, it->second.generation);
+		}
+
+		if (!written)
+			return it->second.hash;
+	}
+	else if (s_texture_hash_memo.size() >= TEXTURE_HASH_MEMO_MAX_SIZE)
+	{
+		s_texture_hash_memo.clear();
+	}
+
 	BlockHashState hash_st;
 	BlockHashReset(hash_st);
-	HashTextureLevel(TEX0, TEXA, hash_st, s_unswizzle_buffer);
-	return FinishBlockHash(hash_st);
+	for (int i = 0; i < count; i++)
+		HashTextureLevel(levels[i], TEXA, hash_st, s_unswizzle_buffer);
+
+	const GSTextureCache::HashType hash = FinishBlockHash(hash_st);
+	s_texture_hash_memo[key] = {hash, mem.GetWriteGeneration()};
+	return hash;
+}
+
+GSTextureCache::HashType GSTextureCache::HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
+{
+	return HashTextureLevels(&TEX0, 1, TEXA);
 }
 
 void GSTextureCache::PreloadTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, GSLocalMemory& mem, bool paltex, GSTexture* tex, u32 level)
@@ -3697,25 +3758,21 @@ GSTextureCache::HashCacheKey GSTextureCache::HashCacheKey::Create(const GIFRegTE
 	ret.TEXA.U64 = (psm.pal == 0 && psm.fmt > 0) ? (TEXA.U64 & 0x000000FF000080FFULL) : 0;
 	ret.CLUTHash = clut ? GSTextureCache::PaletteKeyHash{}({clut, psm.pal}) : 0;
 
-	BlockHashState hash_st;
-	BlockHashReset(hash_st);
-
 	// base level is always hashed
-	HashTextureLevel(TEX0, TEXA, hash_st, s_unswizzle_buffer);
+	GIFRegTEX0 levels[MAXIMUM_TEXTURE_MIPMAP_LEVELS];
+	levels[0] = TEX0;
+	int nlevels = 1;
 
 	if (lod)
 	{
 		// hash and combine full mipmaps when enabled
 		const int basemip = lod->x;
-		const int nmips = lod->y - lod->x + 1;
-		for (int i = 1; i < nmips; i++)
-		{
-			const GIFRegTEX0 MIP_TEX0{g_gs_renderer->GetTex0Layer(basemip + i)};
-			HashTextureLevel(MIP_TEX0, TEXA, hash_st, s_unswizzle_buffer);
-		}
+		const int nmips = std::min(lod->y - lod->x + 1, MAXIMUM_TEXTURE_MIPMAP_LEVELS);
+		for (; nlevels < nmips; nlevels++)
+			levels[nlevels] = g_gs_renderer->GetTex0Layer(basemip + nlevels);
 	}
 
-	ret.TEX0Hash = FinishBlockHash(hash_st);
+	ret.TEX0Hash = HashTextureLevels(levels, nlevels, TEXA);
 
 	return ret;
 }
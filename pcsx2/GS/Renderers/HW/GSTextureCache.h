@@ -198,6 +198,10 @@ public:
 		GSVector4i m_valid;
 		const bool m_depth_supported;
 		bool m_dirty_alpha;
+		// Keep GSTextureCache::m_dst and GSTextureCache::TargetMap::m_map positions to allow fast erase
+		u16 m_dst_it = 0;
+		u16 m_map_it = 0;
+		u64 m_mru_seq = 0; // Bumped each time the target moves to the front of m_dst, newest first
 
 	public:
 		Target(const GIFRegTEX0& TEX0, const bool depth_supported, const int type);
@@ -252,6 +256,65 @@ public:
 		void RemoveAt(Source* s);
 	};
 
+	// Targets indexed by the page of their base pointer. TBP0 never changes once a target is created,
+	// so lookups only have to walk the pages which can hold a matching target instead of all of them.
+	class TargetMap
+	{
+	public:
+		std::array<FastList<Target*>, MAX_PAGES> m_map;
+		u32 m_pages[MAX_PAGES / 32]; // bitmap of all non-empty pages
+		u32 m_max_span; // upper bound of m_end_block - TBP0 over all targets
+
+		TargetMap()
+			: m_max_span(0)
+		{
+			memset(m_pages, 0, sizeof(m_pages));
+		}
+
+		void Add(Target* t);
+		void Remove(Target* t);
+		void RemoveAll();
+		void UpdateSpan(const Target* t);
+
+		/// Returns the lowest base pointer a target covering bp can start at.
+		__fi u32 GetSpanStart(u32 bp) const { return (bp > m_max_span) ? (bp - m_max_span) : 0; }
+
+		/// Calls fn for every target with a TBP0 within [start_bp, end_bp], in no particular order.
+		/// fn may remove the target it is called with, but no other.
+		template <typename Fn>
+		void ForEach(u32 start_bp, u32 end_bp, const Fn& fn) const
+		{
+			end_bp = std::min(end_bp, MAX_BP);
+			if (start_bp > end_bp)
+				return;
+
+			const u32 end_page = end_bp >> 5;
+			for (u32 page = start_bp >> 5; page <= end_page; page++)
+			{
+				const u32 bits = m_pages[page >> 5];
+				if (bits == 0)
+				{
+					page |= 31;
+					continue;
+				}
+				else if (!(bits & (1u << (page & 31))))
+				{
+					continue;
+				}
+
+				const FastList<Target*>& list = m_map[page];
+				for (auto i = list.begin(); i != list.end();)
+				{
+					Target* t = *i;
+					++i;
+
+					if (t->m_TEX0.TBP0 >= start_bp && t->m_TEX0.TBP0 <= end_bp)
+						fn(t);
+				}
+			}
+		}
+	};
+
 	struct TargetHeightElem
 	{
 		union
@@ -309,7 +372,9 @@ protected:
 	u64 m_hash_cache_replacement_memory_usage = 0;
 
 	FastList<Target*> m_dst[2];
-	FastList<TargetHeightElem> m_target_heights;
+	TargetMap m_dst_map[2];
+	u64 m_dst_mru_seq = 0;
+	std::unordered_map<u32, TargetHeightElem> m_target_heights; // keyed by TargetHeightElem::bits
 	u64 m_target_memory_usage = 0;
 
 	constexpr static size_t S_SURFACE_OFFSET_CACHE_MAX_SIZE = std::numeric_limits<u16>::max();
@@ -324,6 +389,27 @@ protected:
 	Source* CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* t, bool half_right, int x_offset, int y_offset, const GSVector2i* lod, const GSVector4i* src_range, GSTexture* gpu_clut);
 	Target* CreateTarget(const GIFRegTEX0& TEX0, int w, int h, int type, const bool clear);
 
+	/// Moves a target to the front of its MRU list.
+	void MoveTargetFront(Target* t);
+
+	/// Removes a target from the cache and deletes it.
+	void RemoveTarget(Target* t);
+
+	/// Returns the most recently used target of the given type with a TBP0 within [start_bp, end_bp] for which pred is true.
+	template <typename Pred>
+	Target* FindTarget(int type, u32 start_bp, u32 end_bp, const Pred& pred) const
+	{
+		Target* found = nullptr;
+		m_dst_map[type].ForEach(start_bp, end_bp, [&found, &pred](Target* t) {
+			if ((!found || t->m_mru_seq > found->m_mru_seq) && pred(t))
+				found = t;
+		});
+		return found;
+	}
+
+	/// Collects the targets of the given type with a TBP0 within [start_bp, end_bp], from LRU to MRU.
+	void GetTargetsLRUToMRU(int type, u32 start_bp, u32 end_bp, std::vector<Target*>& targets) const;
+
 	/// Expands a target when the block pointer for a display framebuffer is within another target, but the read offset
 	/// plus the height is larger than the current size of the target.
 	void ScaleTargetForDisplay(Target* t, const GIFRegTEX0& dispfb, int real_w, int real_h);
@@ -16,6 +16,7 @@
 #include "PrecompiledHeader.h"
 
 #include "common/AlignedMalloc.h"
+#include "common/General.h"
 #include "common/HashCombine.h"
 #include "common/FileSystem.h"
 #include "common/Path.h"
@@ -35,7 +36,7 @@
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
+#include <deque>
 #include <tuple>
 #include <thread>
 
@@ -44,6 +45,7 @@
 #define TEXTURE_FILENAME_CLUT_FORMAT_STRING "%" PRIx64 "-%" PRIx64 "-%08x"
 #define TEXTURE_REPLACEMENT_SUBDIRECTORY_NAME "replacements"
 #define TEXTURE_DUMP_SUBDIRECTORY_NAME "dumps"
+#define TEXTURE_PACK_FILENAME "replacements.pack"
 
 namespace
 {
@@ -87,6 +89,50 @@ namespace
 		__fi bool operator<(const TextureName& rhs) const { return std::tie(TEX0Hash, CLUTHash, bits) < std::tie(rhs.TEX0Hash, rhs.CLUTHash, rhs.bits); }
 	};
 	static_assert(sizeof(TextureName) == 24, "ReplacementTextureName is expected size");
+
+	// Packed replacement archives hold textures which are ready to upload, so they can be used
+	// straight from a mapping of the file instead of being decoded into memory. Layout:
+	//   TexturePackHeader
+	//   TexturePackEntry[num_entries], at index_offset
+	//   Texture data. Each entry's levels are stored back to back from the largest, with rows
+	//   (of 4x4 blocks for compressed formats) tightly packed.
+	static constexpr u32 TEXTURE_PACK_MAGIC = 0x50585450; // "PTXP"
+	static constexpr u32 TEXTURE_PACK_VERSION = 1;
+
+	enum class TexturePackFormat : u8
+	{
+		RGBA8,
+		BC1,
+		BC2,
+		BC3,
+		BC7,
+		MaxCount
+	};
+
+	struct TexturePackHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 num_entries;
+		u32 reserved;
+		u64 index_offset;
+	};
+	static_assert(sizeof(TexturePackHeader) == 24, "TexturePackHeader is expected size");
+
+	struct TexturePackEntry
+	{
+		u64 TEX0Hash;
+		u64 CLUTHash;
+		u32 bits; // Same as TextureName
+		TexturePackFormat format;
+		u8 num_levels;
+		u16 reserved;
+		u32 width;
+		u32 height;
+		u64 offset;
+		u64 size;
+	};
+	static_assert(sizeof(TexturePackEntry) == 48, "TexturePackEntry is expected size");
 } // namespace
 
 namespace std
@@ -115,11 +161,21 @@ namespace GSTextureReplacements
 	static void PrecacheReplacementTextures();
 	static void ClearReplacementTextures();
 
+	static void LoadTexturePack(const std::string& filename);
+	static void CloseTexturePack();
+	static const TexturePackEntry* LookupTexturePackEntry(const TextureName& name);
+	static GSTexture* CreatePackedReplacementTexture(const TextureName& name, const TexturePackEntry& entry, bool mipmap);
+	static void QueueAsyncPackedTextureLoad(const TextureName& name, const TexturePackEntry& entry, bool mipmap);
+	static void PrefetchTexturePackEntry(const TexturePackEntry& entry);
+	static bool CanUseMipmaps(bool compressed, bool has_mips);
+
+	static u32 GetWorkerThreadCount();
 	static void StartWorkerThread();
 	static void StopWorkerThread();
-	static void QueueWorkerThreadItem(std::function<void()> fn);
+	static void QueueWorkerThreadItem(std::function<void()> fn, bool uses_texture_pack = false);
 	static void WorkerThreadEntryPoint();
 	static void SyncWorkerThread();
+	static void CancelTexturePackItems();
 	static void CancelPendingLoadsAndDumps();
 
 	static std::string s_current_serial;
@@ -147,11 +203,27 @@ namespace GSTextureReplacements
 	/// Second element is whether the texture should be created with mipmaps.
 	static std::vector<std::pair<TextureName, bool>> s_async_loaded_textures;
 
-	/// Loader/dumper thread.
-	static std::thread s_worker_thread;
+	/// Mapping of the packed replacement archive, if the game has one.
+	static const u8* s_texture_pack_data = nullptr;
+	static size_t s_texture_pack_size = 0;
+
+	/// Lookup map of texture names to entries in the packed archive. Loose files take priority.
+	static std::unordered_map<TextureName, const TexturePackEntry*> s_texture_pack_entries;
+
+	/// Loader/dumper threads.
+	static constexpr u32 MAX_WORKER_THREADS = 4;
+	static std::vector<std::thread> s_worker_threads;
 	static std::mutex s_worker_thread_mutex;
 	static std::condition_variable s_worker_thread_cv;
-	static std::queue<std::function<void()>> s_worker_thread_queue;
+	static std::condition_variable s_worker_thread_idle_cv;
+	struct WorkerThreadItem
+	{
+		std::function<void()> fn;
+		bool uses_texture_pack; // reads the pack mapping, dropped when the pack is closed
+	};
+	static std::deque<WorkerThreadItem> s_worker_thread_queue;
+	static u32 s_worker_threads_busy = 0;
+	static u32 s_worker_threads_using_texture_pack = 0;
 	static bool s_worker_thread_running = false;
 }; // namespace GSTextureReplacements
 
@@ -276,6 +348,8 @@ void GSTextureReplacements::GameChanged()
 
 void GSTextureReplacements::ReloadReplacementMap()
 {
+	// close the pack first, so the sync doesn't wait for its queued prefetches
+	CloseTexturePack();
 	SyncWorkerThread();
 
 	// clear out the caches
@@ -296,8 +370,7 @@ void GSTextureReplacements::ReloadReplacementMap()
 	const std::string replacement_dir(Path::Combine(GetGameTextureDirectory(), TEXTURE_REPLACEMENT_SUBDIRECTORY_NAME));
 
 	FileSystem::FindResultsArray files;
-	if (!FileSystem::FindFiles(replacement_dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE, &files))
-		return;
+	FileSystem::FindFiles(replacement_dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_HIDDEN_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
 
 	std::string filename;
 	for (FILESYSTEM_FIND_DATA& fd : files)
@@ -320,7 +393,11 @@ void GSTextureReplacements::ReloadReplacementMap()
 		s_replacement_textures_without_clut_hash.insert(name.value());
 	}
 
-	if (!s_replacement_texture_filenames.empty())
+	const std::string pack_filename(Path::Combine(GetGameTextureDirectory(), TEXTURE_PACK_FILENAME));
+	if (FileSystem::FileExists(pack_filename.c_str()))
+		LoadTexturePack(pack_filename);
+
+	if (HasAnyReplacementTextures())
 	{
 		if (GSConfig.PrecacheTextureReplacements)
 			PrecacheReplacementTextures();
@@ -377,7 +454,7 @@ u32 GSTextureReplacements::CalcMipmapLevelsForReplacement(u32 width, u32 height)
 
 bool GSTextureReplacements::HasAnyReplacementTextures()
 {
-	return !s_replacement_texture_filenames.empty();
+	return !s_replacement_texture_filenames.empty() || !s_texture_pack_entries.empty();
 }
 
 bool GSTextureReplacements::HasReplacementTextureWithOtherPalette(const GSTextureCache::HashCacheKey& hash)
@@ -394,7 +471,24 @@ GSTexture* GSTextureReplacements::LookupReplacementTexture(const GSTextureCache:
 	// replacement for this name exists?
 	auto fnit = s_replacement_texture_filenames.find(name);
 	if (fnit == s_replacement_texture_filenames.end())
-		return nullptr;
+	{
+		// packed textures don't need decoding, so they're never cached
+		const TexturePackEntry* entry = LookupTexturePackEntry(name);
+		if (!entry)
+			return nullptr;
+
+		// but faulting in the data can still stall, so let the workers do that
+		if (GSConfig.LoadTextureReplacementsAsync)
+		{
+			std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
+			QueueAsyncPackedTextureLoad(name, *entry, mipmap);
+
+			*pending = true;
+			return nullptr;
+		}
+
+		return CreatePackedReplacementTexture(name, *entry, mipmap);
+	}
 
 	// try the full cache first, to avoid reloading from disk
 	{
@@ -494,12 +588,20 @@ void GSTextureReplacements::PrecacheReplacementTextures()
 		// precaching always goes async.. for now
 		QueueAsyncReplacementTextureLoad(it.first, it.second, mipmap);
 	}
+
+	// packed textures are uploaded straight from the mapping, so only pull them into the page cache
+	for (const auto& it : s_texture_pack_entries)
+	{
+		const TexturePackEntry* entry = it.second;
+		QueueWorkerThreadItem([entry]() { PrefetchTexturePackEntry(*entry); }, true);
+	}
 }
 
 void GSTextureReplacements::ClearReplacementTextures()
 {
 	s_replacement_texture_filenames.clear();
 	s_replacement_textures_without_clut_hash.clear();
+	CloseTexturePack();
 
 	std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
 	s_replacement_texture_cache.clear();
@@ -507,11 +609,11 @@ void GSTextureReplacements::ClearReplacementTextures()
 	s_async_loaded_textures.clear();
 }
 
-GSTexture* GSTextureReplacements::CreateReplacementTexture(const ReplacementTexture& rtex, const GSVector2& scale, bool mipmap)
+bool GSTextureReplacements::CanUseMipmaps(bool compressed, bool has_mips)
 {
 	// can't use generated mipmaps with compressed formats, because they can't be rendered to
 	// in the future I guess we could decompress the dds and generate them... but there's no reason that modders can't generate mips in dds
-	if (mipmap && GSTexture::IsCompressedFormat(rtex.format) && rtex.mips.empty())
+	if (compressed && !has_mips)
 	{
 		static bool log_once = false;
 		if (!log_once)
@@ -523,9 +625,17 @@ GSTexture* GSTextureReplacements::CreateReplacementTexture(const ReplacementText
 			log_once = true;
 		}
 
-		mipmap = false;
+		return false;
 	}
 
+	return true;
+}
+
+GSTexture* GSTextureReplacements::CreateReplacementTexture(const ReplacementTexture& rtex, const GSVector2& scale, bool mipmap)
+{
+	if (mipmap)
+		mipmap = CanUseMipmaps(GSTexture::IsCompressedFormat(rtex.format), !rtex.mips.empty());
+
 	GSTexture* tex = g_gs_device->CreateTexture(rtex.width, rtex.height, static_cast<int>(rtex.mips.size()) + 1, rtex.format);
 	if (!tex)
 		return nullptr;
@@ -559,7 +669,15 @@ void GSTextureReplacements::ProcessAsyncLoadedTextures()
 		// we should be in the cache now, lock and loaded
 		auto it = s_replacement_texture_cache.find(name);
 		if (it == s_replacement_texture_cache.end())
+		{
+			// unless it's coming from the pack, in which case it's ready to go
+			const TexturePackEntry* entry = LookupTexturePackEntry(name);
+			GSTexture* tex = entry ? CreatePackedReplacementTexture(name, *entry, mipmap) : nullptr;
+			if (tex)
+				s_tc->InjectHashCacheTexture(HashCacheKeyFromTextureName(name), tex);
+
 			continue;
+		}
 
 		// upload and inject into TC
 		GSTexture* tex = CreateReplacementTexture(it->second, name.ReplacementScale(it->second), mipmap);
@@ -573,8 +691,11 @@ void GSTextureReplacements::DumpTexture(const GSTextureCache::HashCacheKey& hash
 {
 	// check if it's been dumped or replaced already
 	const TextureName name(CreateTextureName(hash, level));
-	if (s_dumped_textures.find(name) != s_dumped_textures.end() || s_replacement_texture_filenames.find(name) != s_replacement_texture_filenames.end())
+	if (s_dumped_textures.find(name) != s_dumped_textures.end() || s_replacement_texture_filenames.find(name) != s_replacement_texture_filenames.end() ||
+		s_texture_pack_entries.find(name) != s_texture_pack_entries.end())
+	{
 		return;
+	}
 
 	s_dumped_textures.insert(name);
 
@@ -614,44 +735,260 @@ void GSTextureReplacements::ClearDumpedTextureList()
 	s_dumped_textures.clear();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Texture Packs
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static GSTexture::Format GetTexturePackTextureFormat(TexturePackFormat format)
+{
+	static constexpr GSTexture::Format formats[] = {
+		GSTexture::Format::Color, // RGBA8
+		GSTexture::Format::BC1, // BC1
+		GSTexture::Format::BC2, // BC2
+		GSTexture::Format::BC3, // BC3
+		GSTexture::Format::BC7, // BC7
+	};
+	static_assert(std::size(formats) == static_cast<size_t>(TexturePackFormat::MaxCount));
+
+	return formats[static_cast<size_t>(format)];
+}
+
+static void CalcTexturePackLevelSize(GSTexture::Format format, u32 base_width, u32 base_height, u32 level, u32* width, u32* height, u32* pitch, u32* size)
+{
+	*width = std::max<u32>(base_width >> level, 1u);
+	*height = std::max<u32>(base_height >> level, 1u);
+
+	if (GSTexture::IsCompressedFormat(format))
+	{
+		const u32 block_size = GSTexture::GetCompressedBlockSize(format);
+		const u32 blocks_wide = (*width + (block_size - 1)) / block_size;
+		const u32 blocks_high = (*height + (block_size - 1)) / block_size;
+		*pitch = blocks_wide * GSTexture::GetCompressedBytesPerBlock(format);
+		*size = blocks_high * *pitch;
+	}
+	else
+	{
+		*pitch = *width * sizeof(u32);
+		*size = *height * *pitch;
+	}
+}
+
+static bool ValidateTexturePackEntry(const TexturePackEntry& entry, size_t file_size)
+{
+	if (entry.format >= TexturePackFormat::MaxCount || entry.width == 0 || entry.height == 0 ||
+		entry.width > 16384 || entry.height > 16384 || entry.num_levels == 0 ||
+		entry.num_levels > GSTextureReplacements::CalcMipmapLevelsForReplacement(entry.width, entry.height) ||
+		entry.offset > file_size || entry.size > (file_size - entry.offset))
+	{
+		return false;
+	}
+
+	// Same restriction as DDS, the base level has to be whole blocks.
+	const GSTexture::Format format = GetTexturePackTextureFormat(entry.format);
+	if (GSTexture::IsCompressedFormat(format))
+	{
+		const u32 block_size = GSTexture::GetCompressedBlockSize(format);
+		if ((entry.width % block_size) != 0 || (entry.height % block_size) != 0)
+			return false;
+	}
+
+	u64 total_size = 0;
+	for (u32 level = 0; level < entry.num_levels; level++)
+	{
+		u32 width, height, pitch, size;
+		CalcTexturePackLevelSize(format, entry.width, entry.height, level, &width, &height, &pitch, &size);
+		total_size += size;
+	}
+
+	return (total_size <= entry.size);
+}
+
+void GSTextureReplacements::LoadTexturePack(const std::string& filename)
+{
+	size_t size = 0;
+	const u8* data = static_cast<const u8*>(HostSys::MapFile(filename.c_str(), &size));
+	if (!data)
+	{
+		Console.Error("Failed to map texture pack '%s'.", filename.c_str());
+		return;
+	}
+
+	TexturePackHeader header;
+	if (size < sizeof(header))
+	{
+		Console.Error("Texture pack '%s' is truncated.", filename.c_str());
+		HostSys::UnmapFile(const_cast<u8*>(data), size);
+		return;
+	}
+
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != TEXTURE_PACK_MAGIC || header.version != TEXTURE_PACK_VERSION ||
+		(header.index_offset % alignof(TexturePackEntry)) != 0 || header.index_offset > size ||
+		header.num_entries > ((size - header.index_offset) / sizeof(TexturePackEntry)))
+	{
+		Console.Error("Texture pack '%s' has an invalid header.", filename.c_str());
+		HostSys::UnmapFile(const_cast<u8*>(data), size);
+		return;
+	}
+
+	s_texture_pack_data = data;
+	s_texture_pack_size = size;
+
+	const TexturePackEntry* entries = reinterpret_cast<const TexturePackEntry*>(data + header.index_offset);
+	u32 num_loaded = 0;
+	for (u32 i = 0; i < header.num_entries; i++)
+	{
+		const TexturePackEntry& entry = entries[i];
+		if (!ValidateTexturePackEntry(entry, size))
+		{
+			Console.Warning("Skipping invalid entry %u in texture pack '%s'.", i, filename.c_str());
+			continue;
+		}
+
+		TextureName name;
+		name.TEX0Hash = entry.TEX0Hash;
+		name.bits = entry.bits;
+		name.CLUTHash = name.HasPalette() ? entry.CLUTHash : 0;
+		name.miplevel = 0;
+
+		// loose files override the pack
+		if (s_replacement_texture_filenames.find(name) != s_replacement_texture_filenames.end())
+			continue;
+
+		s_texture_pack_entries.emplace(name, &entry);
+		num_loaded++;
+
+		name.CLUTHash = 0;
+		s_replacement_textures_without_clut_hash.insert(name);
+	}
+
+	Console.WriteLn("Loaded %u replacements from texture pack '%s'.", num_loaded, filename.c_str());
+}
+
+void GSTextureReplacements::CloseTexturePack()
+{
+	if (!s_texture_pack_data)
+		return;
+
+	// workers might still be touching the mapping, but there's no point finishing queued prefetches
+	CancelTexturePackItems();
+
+	s_texture_pack_entries.clear();
+	HostSys::UnmapFile(const_cast<u8*>(s_texture_pack_data), s_texture_pack_size);
+	s_texture_pack_data = nullptr;
+	s_texture_pack_size = 0;
+}
+
+const TexturePackEntry* GSTextureReplacements::LookupTexturePackEntry(const TextureName& name)
+{
+	auto it = s_texture_pack_entries.find(name);
+	return (it != s_texture_pack_entries.end()) ? it->second : nullptr;
+}
+
+GSTexture* GSTextureReplacements::CreatePackedReplacementTexture(const TextureName& name, const TexturePackEntry& entry, bool mipmap)
+{
+	const GSTexture::Format format = GetTexturePackTextureFormat(entry.format);
+	if (mipmap)
+		mipmap = CanUseMipmaps(GSTexture::IsCompressedFormat(format), entry.num_levels > 1);
+
+	// an uncompressed entry without its own mips gets a full chain, which is generated from the base level
+	const u32 num_levels = mipmap ? entry.num_levels : 1;
+	const int tex_levels = (mipmap && num_levels == 1) ? -1 : static_cast<int>(num_levels);
+	GSTexture* tex = g_gs_device->CreateTexture(entry.width, entry.height, tex_levels, format);
+	if (!tex)
+		return nullptr;
+
+	// upload straight from the mapping, pages get read in as we go
+	const u8* data = s_texture_pack_data + entry.offset;
+	for (u32 level = 0; level < num_levels; level++)
+	{
+		u32 width, height, pitch, size;
+		CalcTexturePackLevelSize(format, entry.width, entry.height, level, &width, &height, &pitch, &size);
+		tex->Update(GSVector4i(0, 0, static_cast<int>(width), static_cast<int>(height)), data, pitch, level);
+		data += size;
+	}
+
+	tex->SetScale(name.ReplacementScale(entry.width, entry.height));
+	return tex;
+}
+
+void GSTextureReplacements::QueueAsyncPackedTextureLoad(const TextureName& name, const TexturePackEntry& entry, bool mipmap)
+{
+	// check the pending list, so we don't queue it up multiple times
+	if (s_pending_async_load_textures.find(name) != s_pending_async_load_textures.end())
+		return;
+
+	s_pending_async_load_textures.insert(name);
+	QueueWorkerThreadItem([name, &entry, mipmap]() {
+		PrefetchTexturePackEntry(entry);
+
+		std::unique_lock<std::mutex> lock(s_replacement_texture_cache_mutex);
+		if (s_pending_async_load_textures.find(name) == s_pending_async_load_textures.end())
+			return;
+
+		s_async_loaded_textures.emplace_back(name, mipmap);
+	}, true);
+}
+
+void GSTextureReplacements::PrefetchTexturePackEntry(const TexturePackEntry& entry)
+{
+	// reading a byte from each page is enough to get it into the page cache, without copying it
+	const u8* data = s_texture_pack_data + entry.offset;
+	u8 sum = 0;
+	for (size_t offset = 0; offset < entry.size; offset += __pagesize)
+		sum += *static_cast<const volatile u8*>(data + offset);
+	(void)sum;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Worker Thread
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+u32 GSTextureReplacements::GetWorkerThreadCount()
+{
+	// leave the rest of the cores for the EE/GS/VU threads
+	return std::clamp(std::thread::hardware_concurrency() / 2u, 1u, MAX_WORKER_THREADS);
+}
+
 void GSTextureReplacements::StartWorkerThread()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
 
-	if (s_worker_thread.joinable())
+	if (!s_worker_threads.empty())
 		return;
 
 	s_worker_thread_running = true;
-	s_worker_thread = std::thread(WorkerThreadEntryPoint);
+
+	const u32 num_threads = GetWorkerThreadCount();
+	for (u32 i = 0; i < num_threads; i++)
+		s_worker_threads.emplace_back(WorkerThreadEntryPoint);
 }
 
 void GSTextureReplacements::StopWorkerThread()
 {
 	{
 		std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-		if (!s_worker_thread.joinable())
+		if (s_worker_threads.empty())
 			return;
 
 		s_worker_thread_running = false;
-		s_worker_thread_cv.notify_one();
+		s_worker_thread_cv.notify_all();
 	}
 
-	s_worker_thread.join();
+	for (std::thread& thread : s_worker_threads)
+		thread.join();
+	s_worker_threads.clear();
 
 	// clear out workery-things too
 	CancelPendingLoadsAndDumps();
 }
 
-void GSTextureReplacements::QueueWorkerThreadItem(std::function<void()> fn)
+void GSTextureReplacements::QueueWorkerThreadItem(std::function<void()> fn, bool uses_texture_pack)
 {
-	pxAssert(s_worker_thread.joinable());
+	pxAssert(!s_worker_threads.empty());
 
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	s_worker_thread_queue.push(std::move(fn));
+	s_worker_thread_queue.push_back(WorkerThreadItem{std::move(fn), uses_texture_pack});
 	s_worker_thread_cv.notify_one();
 }
 
@@ -666,37 +1003,52 @@ void GSTextureReplacements::WorkerThreadEntryPoint()
 			continue;
 		}
 
-		std::function<void()> fn = std::move(s_worker_thread_queue.front());
-		s_worker_thread_queue.pop();
+		WorkerThreadItem item = std::move(s_worker_thread_queue.front());
+		s_worker_thread_queue.pop_front();
+		s_worker_threads_busy++;
+		s_worker_threads_using_texture_pack += item.uses_texture_pack;
 		lock.unlock();
-		fn();
+		item.fn();
 		lock.lock();
+
+		s_worker_threads_busy--;
+		s_worker_threads_using_texture_pack -= item.uses_texture_pack;
+		if ((s_worker_thread_queue.empty() && s_worker_threads_busy == 0) ||
+			(item.uses_texture_pack && s_worker_threads_using_texture_pack == 0))
+		{
+			s_worker_thread_idle_cv.notify_all();
+		}
 	}
 }
 
 void GSTextureReplacements::SyncWorkerThread()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	if (!s_worker_thread.joinable())
+	if (s_worker_threads.empty())
 		return;
 
-	// not the most efficient by far, but it only gets called on config changes, so whatever
-	for (;;)
-	{
-		if (s_worker_thread_queue.empty())
-			break;
+	// wait for in-flight items too, since they may be using the pack mapping
+	s_worker_thread_idle_cv.wait(lock, []() { return s_worker_thread_queue.empty() && s_worker_threads_busy == 0; });
+}
 
-		lock.unlock();
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		lock.lock();
-	}
+void GSTextureReplacements::CancelTexturePackItems()
+{
+	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
+	if (s_worker_threads.empty())
+		return;
+
+	// callers clear the pending list for any dropped loads
+	s_worker_thread_queue.erase(std::remove_if(s_worker_thread_queue.begin(), s_worker_thread_queue.end(),
+									[](const WorkerThreadItem& item) { return item.uses_texture_pack; }),
+		s_worker_thread_queue.end());
+
+	s_worker_thread_idle_cv.wait(lock, []() { return s_worker_threads_using_texture_pack == 0; });
 }
 
 void GSTextureReplacements::CancelPendingLoadsAndDumps()
 {
 	std::unique_lock<std::mutex> lock(s_worker_thread_mutex);
-	while (!s_worker_thread_queue.empty())
-		s_worker_thread_queue.pop();
+	s_worker_thread_queue.clear();
 	s_async_loaded_textures.clear();
 	s_pending_async_load_textures.clear();
 }
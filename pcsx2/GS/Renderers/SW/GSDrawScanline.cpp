@@ -19,6 +19,8 @@
 #include "GS/Renderers/SW/GSScanlineEnvironment.h"
 #include "GS/Renderers/SW/GSRasterizer.h"
 
+#include "common/Timer.h"
+
 // Comment to disable all dynamic code generation.
 #define ENABLE_JIT_RASTERIZER
 
@@ -44,6 +46,8 @@ GSDrawScanline::GSDrawScanline()
 
 GSDrawScanline::~GSDrawScanline()
 {
+	StopPrecompile();
+
 	if (const size_t used = GSCodeReserve::GetInstance().GetMemoryUsed(); used > 0)
 		DevCon.WriteLn("SW JIT generated %zu bytes of code", used);
 
@@ -83,6 +87,7 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData& data, GSScanlineLocalData
 void GSDrawScanline::ResetCodeCache()
 {
 	Console.Warning("GS Software JIT cache overflow, resetting.");
+	StopPrecompile();
 	m_sp_map.Clear();
 	m_ds_map.Clear();
 	GSCodeReserve::GetInstance().Reset();
@@ -151,6 +156,55 @@ void GSDrawScanline::PrintStats()
 	m_ds_map.PrintStats();
 }
 
+void GSDrawScanline::StartPrecompile(std::vector<u64> sp_keys, std::vector<u64> ds_keys)
+{
+#ifdef ENABLE_JIT_RASTERIZER
+	StopPrecompile();
+
+	m_precompile_thread = std::thread([this, sp_keys = std::move(sp_keys), ds_keys = std::move(ds_keys)]() {
+		Threading::SetNameOfCurrentThread("GS-SW-Precompile");
+
+		// Leave half of the buffer for anything new, so a big cache doesn't force a reset.
+		const size_t max_memory_used = GSCodeReserve::GetInstance().GetSize() / 2;
+		Common::Timer timer;
+		u32 count = 0;
+
+		for (const u64 key : sp_keys)
+		{
+			if (m_precompile_cancel.load(std::memory_order_relaxed) || !m_sp_map.Precompile(key, max_memory_used))
+				break;
+			count++;
+		}
+
+		for (const u64 key : ds_keys)
+		{
+			if (m_precompile_cancel.load(std::memory_order_relaxed) || !m_ds_map.Precompile(key, max_memory_used))
+				break;
+			count++;
+		}
+
+		DevCon.WriteLn("Precompiled %u of %zu SW JIT selectors in %.2f ms", count, sp_keys.size() + ds_keys.size(),
+			timer.GetTimeMilliseconds());
+	});
+#endif
+}
+
+void GSDrawScanline::StopPrecompile()
+{
+	if (!m_precompile_thread.joinable())
+		return;
+
+	m_precompile_cancel.store(true, std::memory_order_relaxed);
+	m_precompile_thread.join();
+	m_precompile_cancel.store(false, std::memory_order_relaxed);
+}
+
+void GSDrawScanline::GetUsedSelectors(std::vector<u64>* sp_keys, std::vector<u64>* ds_keys) const
+{
+	*sp_keys = m_sp_map.GetKeysByUsage();
+	*ds_keys = m_ds_map.GetKeysByUsage();
+}
+
 #if _M_SSE >= 0x501
 typedef GSVector8i VectorI;
 typedef GSVector8  VectorF;
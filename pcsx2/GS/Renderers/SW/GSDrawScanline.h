@@ -19,6 +19,10 @@
 #include "GS/Renderers/SW/GSSetupPrimCodeGenerator.h"
 #include "GS/Renderers/SW/GSDrawScanlineCodeGenerator.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 struct GSScanlineLocalData;
 
 MULTI_ISA_UNSHARED_START
@@ -56,10 +60,21 @@ public:
 	void UpdateDrawStats(u64 frame, u64 ticks, int actual, int total, int prims);
 	void PrintStats();
 
+	/// Compiles selectors on a background thread, so they don't hitch when they're first drawn.
+	void StartPrecompile(std::vector<u64> sp_keys, std::vector<u64> ds_keys);
+
+	/// Returns the selectors which have been drawn with, most expensive first.
+	void GetUsedSelectors(std::vector<u64>* sp_keys, std::vector<u64>* ds_keys) const;
+
 private:
+	void StopPrecompile();
+
 	GSCodeGeneratorFunctionMap<GSSetupPrimCodeGenerator, u64, SetupPrimPtr> m_sp_map;
 	GSCodeGeneratorFunctionMap<GSDrawScanlineCodeGenerator, u64, DrawScanlinePtr> m_ds_map;
 
+	std::thread m_precompile_thread;
+	std::atomic_bool m_precompile_cancel{false};
+
 	static void CSetupPrim(const GSVertexSW* vertex, const u32* index, const GSVertexSW& dscan, GSScanlineLocalData& local);
 	static void CDrawScanline(int pixels, int left, int top, const GSVertexSW& scan, GSScanlineLocalData& local);
 	static void CDrawEdge(int pixels, int left, int top, const GSVertexSW& scan, GSScanlineLocalData& local);
@@ -20,6 +20,7 @@
 #include "GS/Renderers/SW/GSDrawScanline.h"
 #include "GS/GSExtra.h"
 #include "PerformanceMetrics.h"
+#include "TimelineTracer.h"
 #include "common/AlignedMalloc.h"
 #include "common/StringUtil.h"
 #include "VMManager.h"
@@ -1220,7 +1221,9 @@ GSRasterizerList::~GSRasterizerList()
 
 void GSRasterizerList::OnWorkerStartup(int i)
 {
-	Threading::SetNameOfCurrentThread(StringUtil::StdStringFromFormat("GS-SW-%d", i).c_str());
+	const std::string name(StringUtil::StdStringFromFormat("GS-SW-%d", i));
+	Threading::SetNameOfCurrentThread(name.c_str());
+	TimelineTracer::SetCurrentThreadName(name.c_str());
 
 	Threading::ThreadHandle handle(Threading::ThreadHandle::GetForCallingThread());
 
@@ -1320,7 +1323,10 @@ std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
 		rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(&rl->m_ds, i, threads)));
 		auto& r = *rl->m_r[i];
 		rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker([i]() { GSRasterizerList::OnWorkerStartup(i); },
-			[&r](GSRingHeap::SharedPtr<GSRasterizerData>& item) { r.Draw(*item.get()); },
+			[&r](GSRingHeap::SharedPtr<GSRasterizerData>& item) {
+				TimelineTracer::ScopedZone zone("GS SW Draw");
+				r.Draw(*item.get());
+			},
 			[i]() { GSRasterizerList::OnWorkerShutdown(i); })));
 	}
 
@@ -142,6 +142,8 @@ public:
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
+
+	virtual GSDrawScanline& GetDrawScanline() = 0;
 };
 
 class GSSingleRasterizer final : public IRasterizer
@@ -156,6 +158,8 @@ public:
 	int GetPixels(bool reset = true) override;
 	void PrintStats() override;
 
+	GSDrawScanline& GetDrawScanline() override { return m_ds; }
+
 	void Draw(GSRasterizerData& data);
 
 private:
@@ -193,6 +197,8 @@ public:
 	bool IsSynced() const override;
 	int GetPixels(bool reset) override;
 	void PrintStats() override;
+
+	GSDrawScanline& GetDrawScanline() override { return m_ds; }
 };
 
 MULTI_ISA_UNSHARED_END
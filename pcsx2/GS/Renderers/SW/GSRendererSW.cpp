@@ -16,8 +16,14 @@
 #include "PrecompiledHeader.h"
 #include "GSRendererSW.h"
 #include "GS/GSGL.h"
+#include "TimelineTracer.h"
+#include "VMManager.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
 #include "common/StringUtil.h"
 
+#include <unordered_set>
+
 MULTI_ISA_UNSHARED_IMPL;
 
 GSRenderer* CURRENT_ISA::makeGSRendererSW(int threads)
@@ -31,6 +37,18 @@ static FILE* s_fp = LOG ? fopen("c:\\temp1\\_.txt", "w") : NULL;
 
 static constexpr GSVector4 s_pos_scale = GSVector4::cxpr(1.0f / 16, 1.0f / 16, 1.0f, 128.0f);
 
+// Bump when GSScanlineSelector changes, so old selectors aren't compiled for nothing.
+static constexpr u32 SELECTOR_CACHE_MAGIC = 0x4A575347; // GSWJ
+static constexpr u32 SELECTOR_CACHE_VERSION = 1;
+
+struct SelectorCacheHeader
+{
+	u32 magic;
+	u32 version;
+	u32 num_sp_selectors;
+	u32 num_ds_selectors;
+};
+
 GSRendererSW::GSRendererSW(int threads)
 	: GSRenderer(), m_fzb(NULL)
 {
@@ -64,6 +82,8 @@ void GSRendererSW::Reset(bool hardware_reset)
 
 void GSRendererSW::Destroy()
 {
+	SaveSelectorCache();
+
 	// Need to destroy worker queue first to stop any pending thread work
 	m_rl.reset();
 	m_tc.reset();
@@ -78,6 +98,97 @@ void GSRendererSW::Destroy()
 	m_output = nullptr;
 }
 
+void GSRendererSW::SetGameCRC(u32 crc)
+{
+	const bool changed = (crc != m_crc);
+	if (changed)
+		SaveSelectorCache();
+
+	GSRenderer::SetGameCRC(crc);
+
+	if (changed)
+		LoadSelectorCache();
+}
+
+void GSRendererSW::LoadSelectorCache()
+{
+	m_selector_cache_path.clear();
+	m_cached_sp_selectors.clear();
+	m_cached_ds_selectors.clear();
+
+	const std::string serial(VMManager::GetGameSerial());
+	if (serial.empty() || m_crc == 0)
+		return;
+
+	// Generated code differs between ISAs, so keep each one's selectors separate.
+	m_selector_cache_path = Path::Combine(EmuFolders::Cache,
+		fmt::format("sw_selectors_{}_{:08X}_{}.bin", serial, m_crc, STRINGIZE(CURRENT_ISA)));
+
+	std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(m_selector_cache_path.c_str()));
+	if (!data.has_value())
+		return;
+
+	SelectorCacheHeader header = {};
+	if (data->size() >= sizeof(header))
+		std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != SELECTOR_CACHE_MAGIC || header.version != SELECTOR_CACHE_VERSION ||
+		data->size() != (sizeof(header) + (static_cast<size_t>(header.num_sp_selectors) + header.num_ds_selectors) * sizeof(u64)))
+	{
+		Console.Warning("Ignoring invalid SW selector cache '%s'", m_selector_cache_path.c_str());
+		return;
+	}
+
+	const u8* ptr = data->data() + sizeof(header);
+	m_cached_sp_selectors.resize(header.num_sp_selectors);
+	std::memcpy(m_cached_sp_selectors.data(), ptr, header.num_sp_selectors * sizeof(u64));
+	ptr += header.num_sp_selectors * sizeof(u64);
+	m_cached_ds_selectors.resize(header.num_ds_selectors);
+	std::memcpy(m_cached_ds_selectors.data(), ptr, header.num_ds_selectors * sizeof(u64));
+
+	m_rl->GetDrawScanline().StartPrecompile(m_cached_sp_selectors, m_cached_ds_selectors);
+}
+
+void GSRendererSW::SaveSelectorCache()
+{
+	if (m_selector_cache_path.empty() || !m_rl)
+		return;
+
+	std::vector<u64> sp_selectors, ds_selectors;
+	m_rl->GetDrawScanline().GetUsedSelectors(&sp_selectors, &ds_selectors);
+
+	// Keep anything cached which wasn't drawn this time, it's probably from another part of the game.
+	// Returns true if there's something new, otherwise the file doesn't need rewriting.
+	const auto merge = [](std::vector<u64>& selectors, const std::vector<u64>& cached) {
+		std::unordered_set<u64> seen(selectors.begin(), selectors.end());
+		for (const u64 sel : cached)
+		{
+			if (seen.insert(sel).second)
+				selectors.push_back(sel);
+		}
+		return (selectors.size() != cached.size());
+	};
+	const bool sp_changed = merge(sp_selectors, m_cached_sp_selectors);
+	const bool ds_changed = merge(ds_selectors, m_cached_ds_selectors);
+	if (!sp_changed && !ds_changed)
+		return;
+
+	auto fp = FileSystem::OpenManagedCFile(m_selector_cache_path.c_str(), "wb");
+	const SelectorCacheHeader header = {SELECTOR_CACHE_MAGIC, SELECTOR_CACHE_VERSION,
+		static_cast<u32>(sp_selectors.size()), static_cast<u32>(ds_selectors.size())};
+	if (!fp || std::fwrite(&header, sizeof(header), 1, fp.get()) != 1 ||
+		std::fwrite(sp_selectors.data(), sizeof(u64), sp_selectors.size(), fp.get()) != sp_selectors.size() ||
+		std::fwrite(ds_selectors.data(), sizeof(u64), ds_selectors.size(), fp.get()) != ds_selectors.size())
+	{
+		Console.Error("Failed to write SW selector cache '%s'", m_selector_cache_path.c_str());
+		return;
+	}
+
+	DevCon.WriteLn("Saved %zu SW JIT selectors to '%s'", sp_selectors.size() + ds_selectors.size(),
+		m_selector_cache_path.c_str());
+	m_cached_sp_selectors = std::move(sp_selectors);
+	m_cached_ds_selectors = std::move(ds_selectors);
+}
+
 void GSRendererSW::VSync(u32 field, bool registers_written)
 {
 	Sync(0); // IncAge might delete a cached texture in use
@@ -246,6 +357,89 @@ void ConvertVertexBuffer(const GSDrawingContext* RESTRICT ctx, GSVertexSW* RESTR
 	GSVector4 tsize = GSVector4(0x10000 << ctx->TEX0.TW, 0x10000 << ctx->TEX0.TH, 1, 0);
 	GSVector4i z_max = GSVector4i::xffffffff().srl32(GSLocalMemory::m_psm[ctx->ZBUF.PSM].fmt * 8);
 
+#if _M_SSE >= 0x600
+
+	// Four vertices at a time, one in each 128-bit lane, then the rest with the loop below.
+	// Sprites dividing by the q of the next vertex need the pairs to line up with the lanes,
+	// which they do as long as the count is even (it always should be).
+
+	constexpr bool next_q = primclass == GS_SPRITE_CLASS && tme && !fst && q_div;
+
+	if (!next_q || (count & 1) == 0)
+	{
+		const __m512i off4 = _mm512_broadcast_i32x4(off);
+		const __m512 tsize4 = _mm512_broadcast_f32x4(tsize.m);
+		const __m512i z_max4 = _mm512_broadcast_i32x4(z_max);
+		const __m512 scale4 = _mm512_broadcast_f32x4(s_pos_scale.m);
+		const __m512i rgba_mask = _mm512_broadcast_i32x4(_mm_setr_epi8(8, -1, -1, -1, 9, -1, -1, -1, 10, -1, -1, -1, 11, -1, -1, -1));
+
+		// (p, _pad, t, c) of one vertex from (p0, p1, c0, c1) and t
+		const __m512i out0 = _mm512_setr_epi32(0, 1, 2, 3, 0, 0, 0, 0, 16, 17, 18, 19, 8, 9, 10, 11);
+		const __m512i out1 = _mm512_setr_epi32(4, 5, 6, 7, 0, 0, 0, 0, 20, 21, 22, 23, 12, 13, 14, 15);
+		const __m512i out2 = _mm512_setr_epi32(0, 1, 2, 3, 0, 0, 0, 0, 24, 25, 26, 27, 8, 9, 10, 11);
+		const __m512i out3 = _mm512_setr_epi32(4, 5, 6, 7, 0, 0, 0, 0, 28, 29, 30, 31, 12, 13, 14, 15);
+
+		for (; count >= 4; count -= 4, src += 4, dst += 4)
+		{
+			const __m512i v01 = _mm512_loadu_si512(&src[0]);
+			const __m512i v23 = _mm512_loadu_si512(&src[2]);
+
+			const __m512 stcq = _mm512_castsi512_ps(_mm512_shuffle_i32x4(v01, v23, _MM_SHUFFLE(2, 0, 2, 0))); // s t rgba q
+			const __m512i xyzuvf = _mm512_shuffle_i32x4(v01, v23, _MM_SHUFFLE(3, 1, 3, 1));
+
+			const __m512 xy = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_unpacklo_epi16(xyzuvf, _mm512_setzero_si512()), off4));
+
+			const __m512 c = _mm512_cvtepi32_ps(_mm512_slli_epi32(_mm512_shuffle_epi8(_mm512_castps_si512(stcq), rgba_mask), 7));
+
+			__m512 t = _mm512_setzero_ps();
+
+			if (tme)
+			{
+				if (fst)
+				{
+					t = _mm512_cvtepi32_ps(_mm512_slli_epi32(_mm512_unpackhi_epi16(xyzuvf, _mm512_setzero_si512()), 16 - 4));
+				}
+				else if (q_div)
+				{
+					__m512 q = _mm512_permute_ps(stcq, _MM_SHUFFLE(3, 3, 3, 3));
+					if (next_q)
+						q = _mm512_shuffle_f32x4(q, q, _MM_SHUFFLE(3, 3, 1, 1));
+					t = _mm512_mul_ps(_mm512_div_ps(stcq, q), tsize4);
+				}
+				else
+				{
+					t = _mm512_mul_ps(_mm512_permute_ps(stcq, _MM_SHUFFLE(3, 3, 1, 0)), tsize4);
+				}
+			}
+
+			__m512 p;
+
+			if (primclass == GS_SPRITE_CLASS)
+			{
+				p = _mm512_mul_ps(_mm512_shuffle_ps(xy, _mm512_cvtepi32_ps(xyzuvf), _MM_SHUFFLE(3, 1, 1, 0)), scale4);
+
+				const __m512 z = _mm512_castsi512_ps(_mm512_min_epu32(xyzuvf, z_max4));
+				t = _mm512_mask_permute_ps(t, 0x8888, z, _MM_SHUFFLE(1, 1, 1, 1));
+			}
+			else
+			{
+				const __m512d z = _mm512_cvtepu64_pd(_mm512_srli_epi64(xyzuvf, 32));
+				p = _mm512_castpd_ps(_mm512_unpacklo_pd(_mm512_castps_pd(_mm512_mul_ps(xy, scale4)), z));
+				t = _mm512_mask_blend_ps(0x8888, t, _mm512_cvtepi32_ps(_mm512_slli_epi32(xyzuvf, 7)));
+			}
+
+			const __m512 pc01 = _mm512_shuffle_f32x4(p, c, _MM_SHUFFLE(1, 0, 1, 0));
+			const __m512 pc23 = _mm512_shuffle_f32x4(p, c, _MM_SHUFFLE(3, 2, 3, 2));
+
+			_mm512_storeu_ps(&dst[0], _mm512_maskz_permutex2var_ps(0xFF0F, pc01, out0, t));
+			_mm512_storeu_ps(&dst[1], _mm512_maskz_permutex2var_ps(0xFF0F, pc01, out1, t));
+			_mm512_storeu_ps(&dst[2], _mm512_maskz_permutex2var_ps(0xFF0F, pc23, out2, t));
+			_mm512_storeu_ps(&dst[3], _mm512_maskz_permutex2var_ps(0xFF0F, pc23, out3, t));
+		}
+	}
+
+#endif
+
 	for (int i = (int)count; i > 0; i--, src++, dst++)
 	{
 		GSVector4 stcq = GSVector4::load<true>(&src->m[0]); // s t rgba q
@@ -590,10 +784,17 @@ void GSRendererSW::Queue(GSRingHeap::SharedPtr<GSRasterizerData>& item)
 	}
 }
 
+void GSRendererSW::SyncLocalMem()
+{
+	Sync(6);
+}
+
 void GSRendererSW::Sync(int reason)
 {
 	//printf("sync %d\n", reason);
 
+	TimelineTracer::ScopedZone zone("GS SW Sync", reason);
+
 	u64 t = LOG ? __rdtsc() : 0;
 
 	m_rl->Sync();
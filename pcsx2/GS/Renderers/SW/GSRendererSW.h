@@ -70,6 +70,14 @@ protected:
 	std::atomic<u32> m_fzb_pages[512]; // u16 frame/zbuf pages interleaved
 	std::atomic<u16> m_tex_pages[512];
 
+	// Selectors used by the current game in previous runs, and where they're saved.
+	std::string m_selector_cache_path;
+	std::vector<u64> m_cached_sp_selectors;
+	std::vector<u64> m_cached_ds_selectors;
+
+	void LoadSelectorCache();
+	void SaveSelectorCache();
+
 	void Reset(bool hardware_reset) override;
 	void VSync(u32 field, bool registers_written) override;
 	GSTexture* GetOutput(int i, int& y_offset) override;
@@ -81,6 +89,7 @@ protected:
 	void ExpandTarget(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r) override;
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool eewrite = false) override;
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false) override;
+	void SyncLocalMem() override;
 
 	void UsePages(const GSOffset::PageLooper& pages, const int type);
 	void ReleasePages(const GSOffset::PageLooper& pages, const int type);
@@ -97,6 +106,7 @@ public:
 	__fi static GSRendererSW* GetInstance() { return static_cast<GSRendererSW*>(g_gs_renderer.get()); }
 
 	void Destroy() override;
+	void SetGameCRC(u32 crc) override;
 };
 
 MULTI_ISA_UNSHARED_END
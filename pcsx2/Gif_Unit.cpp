@@ -207,7 +207,7 @@ void Gif_AddCompletedGSPacket(GS_Packet& gsPack, GIF_PATH path)
 	{
 		GetMTGS().PrepDataPacket(path, gsPack.size / 16);
 		MemCopy_WrappedDest((u128*)&gifUnit.gifPath[path].buffer[gsPack.offset], RingBuffer.m_Ring,
-							GetMTGS().m_packet_writepos, RingBufferSize, gsPack.size / 16);
+							GetMTGS().m_packet_writepos, RingBuffer.m_Size, gsPack.size / 16);
 		GetMTGS().SendDataPacket();
 	}
 	else
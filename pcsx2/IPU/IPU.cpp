@@ -18,6 +18,7 @@
 
 #include "IPU.h"
 #include "IPU_MultiISA.h"
+#include "IPU_Thread.h"
 #include "IPUdma.h"
 
 #include <limits.h>
@@ -94,8 +95,21 @@ void tIPU_cmd::clear()
 
 __fi void IPUProcessInterrupt()
 {
-	if (ipuRegs.ctrl.BUSY && !CommandExecuteQueued)
+	// Collect anything the IPU thread decoded since it was last kicked.
+	ipu_thread.Flush();
+
+	if (!ipuRegs.ctrl.BUSY || CommandExecuteQueued)
+		return;
+
+	if (ipu_thread.HandlesCommand())
+	{
+		if (ipu_thread.ShouldKick())
+			ipu_thread.Kick();
+	}
+	else if (!ipu_thread.HasPendingOutput())
+	{
 		IPUWorker();
+	}
 }
 
 /////////////////////////////////////////////////////////
@@ -104,6 +118,13 @@ __fi void IPUProcessInterrupt()
 void ipuReset()
 {
 	IPUWorker = MULTI_ISA_SELECT(IPUWorker);
+
+	if (EmuConfig.Speedhacks.ipuThread)
+		ipu_thread.Open();
+	else
+		ipu_thread.Close();
+	ipu_thread.Reset();
+
 	memzero(ipuRegs);
 	memzero(g_BP);
 	memzero(decoder);
@@ -134,6 +155,7 @@ void SaveStateBase::ipuFreeze()
 	// Get a report of the status of the ipu variables when saving and loading savestates.
 	//ReportIPU();
 	FreezeTag("IPU");
+	ipu_thread.WaitIdle();
 	Freeze(ipu_fifo);
 
 	Freeze(g_BP);
@@ -142,6 +164,7 @@ void SaveStateBase::ipuFreeze()
 	Freeze(coded_block_pattern);
 	Freeze(decoder);
 	Freeze(ipu_cmd);
+	Freeze(ipu_thread.queue);
 }
 
 void tIPU_CMD_IDEC::log() const
@@ -227,6 +250,8 @@ __fi u32 ipuRead32(u32 mem)
 	pxAssert((mem & ~0xff) == 0x10002000);
 	mem &= 0xff;	// ipu repeats every 0x100
 
+	ipu_thread.WaitIdle();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD) : // IPU_CMD
@@ -277,6 +302,8 @@ __fi u64 ipuRead64(u32 mem)
 	pxAssert((mem & ~0xff) == 0x10002000);
 	mem &= 0xff;	// ipu repeats every 0x100
 
+	ipu_thread.WaitIdle();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD): // IPU_CMD
@@ -313,6 +340,7 @@ __fi u64 ipuRead64(u32 mem)
 
 void ipuSoftReset()
 {
+	ipu_thread.Reset();
 	ipu_fifo.clear();
 	memzero(g_BP);
 
@@ -335,6 +363,8 @@ __fi bool ipuWrite32(u32 mem, u32 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipu_thread.WaitIdle();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD): // IPU_CMD
@@ -370,6 +400,8 @@ __fi bool ipuWrite64(u32 mem, u64 value)
 	pxAssert((mem & ~0xfff) == 0x10002000);
 	mem &= 0xfff;
 
+	ipu_thread.WaitIdle();
+
 	switch (mem)
 	{
 		ipucase(IPU_CMD):
@@ -465,6 +497,7 @@ __fi void IPUCMD_WRITE(u32 val)
 	ipuRegs.ctrl.SCD = 0;
 	ipu_cmd.clear();
 	ipu_cmd.current = val;
+	ipu_thread.ResetCommand();
 
 	switch (ipu_cmd.CMD)
 	{
@@ -533,5 +566,11 @@ __fi void IPUCMD_WRITE(u32 val)
 		CPU_INT(IPU_PROCESS, 64);
 	}
 	else
-		IPUWorker();
+	{
+		// Output from the last threaded IDEC/BDEC has to reach the FIFO first. Move what fits now,
+		// rather than holding the command back until the next IPU_PROCESS event.
+		ipu_thread.Flush();
+		if (!ipu_thread.HasPendingOutput())
+			IPUWorker();
+	}
 }
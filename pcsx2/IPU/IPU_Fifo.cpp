@@ -18,6 +18,7 @@
 #include "IPU/IPU.h"
 #include "IPU/IPUdma.h"
 #include "IPU/IPU_MultiISA.h"
+#include "IPU/IPU_Thread.h"
 
 alignas(16) IPU_Fifo ipu_fifo;
 
@@ -101,7 +102,8 @@ int IPU_Fifo_Input::read(void *value)
 		// IPU FIFO is empty and DMA is waiting so lets tell the DMA we are ready to put data in the FIFO
 		IPU1Status.DataRequested = true;
 
-		if(ipu1ch.chcr.STR && cpuRegs.eCycle[4] == 0x9999)
+		// The IPU thread can't touch the EE's event queue, IPU_Thread::Flush() will schedule this for it.
+		if (!ipu_thread.IsWorkerThread() && ipu1ch.chcr.STR && cpuRegs.eCycle[4] == 0x9999)
 		{
 			CPU_INT( DMAC_TO_IPU, 4);
 		}
@@ -165,6 +167,8 @@ void IPU_Fifo_Output::read(void *value, uint size)
 
 void ReadFIFO_IPUout(mem128_t* out)
 {
+	ipu_thread.WaitIdle();
+
 	if (!pxAssertDev( ipuRegs.ctrl.OFC > 0, "Attempted read from IPUout's FIFO, but the FIFO is empty!" )) return;
 	ipu_fifo.out.read(out, 1);
 
@@ -175,6 +179,7 @@ void ReadFIFO_IPUout(mem128_t* out)
 void WriteFIFO_IPUin(const mem128_t* value)
 {
 	IPU_LOG( "WriteFIFO/IPUin <- 0x%08X.%08X.%08X.%08X", value->_u32[0], value->_u32[1], value->_u32[2], value->_u32[3]);
+	ipu_thread.WaitIdle();
 
 	//committing every 16 bytes
 	if( ipu_fifo.in.write((u32*)value, 1) == 0 )
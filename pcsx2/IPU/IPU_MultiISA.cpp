@@ -26,6 +26,7 @@
 #include "IPU/IPUdma.h"
 #include "IPU/yuv2rgb.h"
 #include "IPU/IPU_MultiISA.h"
+#include "IPU/IPU_Thread.h"
 #include "common/MemsetFast.inl"
 
 // the IPU is fixed to 16 byte strides (128-bit / QWC resolution):
@@ -973,6 +974,24 @@ __ri static bool slice_non_intra_DCT(s16 * const dest, const int stride, const b
 	return true;
 }
 
+// On the IPU thread, macroblocks are queued for the EE to move into the FIFO later,
+// so decoding only has to wait for room in the queue rather than for IPU0.
+__fi static bool ipu0_ready()
+{
+	if (ipu_thread.IsWorkerThread())
+		return ipu_thread.HasOutputSpace();
+
+	return ipu0ch.chcr.STR && !ipuRegs.ctrl.OFC && ipu0ch.qwc != 0;
+}
+
+__fi static uint ipu0_write(const u32* data, uint size)
+{
+	if (ipu_thread.IsWorkerThread())
+		return ipu_thread.WriteOutput(data, size);
+
+	return ipu_fifo.out.write(data, size);
+}
+
 __fi static void finishmpeg2sliceIDEC()
 {
 	ipuRegs.ctrl.SCD = 0;
@@ -1007,7 +1026,7 @@ __ri static bool mpeg2sliceIDEC()
 		while (1)
 		{
 			// IPU0 isn't ready for data, so let's wait for it to be
-			if ((!ipu0ch.chcr.STR || ipuRegs.ctrl.OFC || ipu0ch.qwc == 0) && ipu_cmd.pos[1] <= 2)
+			if (!ipu0_ready() && ipu_cmd.pos[1] <= 2)
 			{
 				return false;
 			}
@@ -1122,7 +1141,7 @@ __ri static bool mpeg2sliceIDEC()
 
 				pxAssert(decoder.ipu0_data > 0);
 
-				uint read = ipu_fifo.out.write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
+				uint read = ipu0_write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
 				decoder.AdvanceIpuDataBy(read);
 
 				if (decoder.ipu0_data != 0)
@@ -1133,7 +1152,8 @@ __ri static bool mpeg2sliceIDEC()
 				}
 
 				mbaCount = 0;
-				if (read)
+				// The IPU thread carries on with the next macroblock, the queue absorbs the output.
+				if (read && !ipu_thread.IsWorkerThread())
 				{
 					ipu_cmd.pos[1] = 3;
 					return false;
@@ -1298,7 +1318,7 @@ __fi static bool mpeg2_slice()
 		ipu_cmd.pos[0] = 2;
 
 		// IPU0 isn't ready for data, so let's wait for it to be
-		if ((!ipu0ch.chcr.STR || ipuRegs.ctrl.OFC || ipu0ch.qwc == 0) && ipu_cmd.pos[0] <= 3)
+		if (!ipu0_ready() && ipu_cmd.pos[0] <= 3)
 		{
 			return false;
 		}
@@ -1503,7 +1523,7 @@ __fi static bool mpeg2_slice()
 	{
 		pxAssert(decoder.ipu0_data > 0);
 
-		uint read = ipu_fifo.out.write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
+		uint read = ipu0_write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
 		decoder.AdvanceIpuDataBy(read);
 
 		if (decoder.ipu0_data != 0)
@@ -1514,7 +1534,7 @@ __fi static bool mpeg2_slice()
 		}
 
 		mbaCount = 0;
-		if (read)
+		if (read && !ipu_thread.IsWorkerThread())
 		{
 			ipu_cmd.pos[0] = 4;
 			return false;
@@ -1912,6 +1932,13 @@ __noinline void IPUWorker()
 		case SCE_IPU_IDEC:
 			if (!mpeg2sliceIDEC()) return;
 
+			// The EE retires the command once the queued macroblocks have reached the FIFO.
+			if (ipu_thread.IsWorkerThread())
+			{
+				ipu_thread.queue.decode_done = true;
+				return;
+			}
+
 			//ipuRegs.ctrl.OFC = 0;
 			ipuRegs.topbusy = 0;
 			ipuRegs.cmd.BUSY = 0;
@@ -1920,6 +1947,12 @@ __noinline void IPUWorker()
 		case SCE_IPU_BDEC:
 			if (!mpeg2_slice()) return;
 
+			if (ipu_thread.IsWorkerThread())
+			{
+				ipu_thread.queue.decode_done = true;
+				return;
+			}
+
 			ipuRegs.topbusy = 0;
 			ipuRegs.cmd.BUSY = 0;
 
@@ -0,0 +1,183 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "IPU/IPU.h"
+#include "IPU/IPU_MultiISA.h"
+#include "IPU/IPU_Thread.h"
+#include "IPU/IPUdma.h"
+
+IPU_Thread ipu_thread;
+
+static thread_local bool s_is_worker_thread = false;
+
+// Largest macroblock the decoder outputs in one go (IDEC RGB32).
+static constexpr u32 MAX_MACROBLOCK_QWC = sizeof(macroblock_rgb32) / 16;
+
+IPU_Thread::IPU_Thread()
+{
+	Reset();
+}
+
+IPU_Thread::~IPU_Thread()
+{
+	Close();
+}
+
+void IPU_Thread::Open()
+{
+	if (IsOpen())
+		return;
+
+	m_worker = MULTI_ISA_SELECT(IPUWorker);
+	m_sema.Reset();
+	m_shutdown_flag.store(false, std::memory_order_release);
+	m_thread.Start([this]() { ThreadEntryPoint(); });
+}
+
+void IPU_Thread::Close()
+{
+	if (!IsOpen())
+		return;
+
+	m_sema.WaitForEmpty();
+	m_shutdown_flag.store(true, std::memory_order_release);
+	m_sema.NotifyOfWork();
+	m_thread.Join();
+}
+
+void IPU_Thread::Reset()
+{
+	WaitIdle();
+	memzero(queue);
+}
+
+void IPU_Thread::ResetCommand()
+{
+	queue.decode_done = false;
+	queue.output_full = false;
+	queue.input_starved = false;
+}
+
+bool IPU_Thread::IsWorkerThread() const
+{
+	return s_is_worker_thread;
+}
+
+void IPU_Thread::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("IPU");
+	s_is_worker_thread = true;
+
+	for (;;)
+	{
+		m_sema.WaitForWork();
+		if (m_shutdown_flag.load(std::memory_order_acquire))
+			break;
+
+		queue.output_full = false;
+		m_worker();
+		queue.input_starved = !queue.decode_done && !queue.output_full;
+		queue.ran = true;
+	}
+}
+
+bool IPU_Thread::HandlesCommand() const
+{
+	return IsOpen() && (ipu_cmd.CMD == SCE_IPU_IDEC || ipu_cmd.CMD == SCE_IPU_BDEC);
+}
+
+bool IPU_Thread::ShouldKick() const
+{
+	if (queue.decode_done)
+		return false;
+
+	// Don't bother waking the worker if it'd stop again straight away.
+	if (queue.output_full)
+		return (IPU_OutputQueue::SIZE - queue.count) >= MAX_MACROBLOCK_QWC;
+	if (queue.input_starved)
+		return g_BP.IFC > 0;
+
+	return true;
+}
+
+void IPU_Thread::Kick()
+{
+	pxAssert(ipuRegs.ctrl.BUSY && !CommandExecuteQueued);
+
+	CommandExecuteQueued = true;
+	CPU_INT(IPU_PROCESS, IPU_THREAD_SYNC_CYCLES);
+	m_sema.NotifyOfWork();
+}
+
+void IPU_Thread::Flush()
+{
+	WaitIdle();
+
+	if (queue.ran)
+	{
+		queue.ran = false;
+
+		// The worker can't schedule DMAC events, so request more IPU1 data for it.
+		// IPU_Fifo_Input::read() would have done this if it were running on the EE.
+		if (IPU1Status.DataRequested && ipu1ch.chcr.STR && cpuRegs.eCycle[4] == 0x9999)
+			CPU_INT(DMAC_TO_IPU, 4);
+	}
+
+	// Same condition the decoder checks before writing to IPU0 itself.
+	if (queue.count > 0 && ipu0ch.chcr.STR && !ipuRegs.ctrl.OFC && ipu0ch.qwc != 0)
+	{
+		const u32 contiguous = std::min(queue.count, IPU_OutputQueue::SIZE - queue.readpos);
+		const uint written = ipu_fifo.out.write((u32*)&queue.data[queue.readpos], contiguous);
+		queue.readpos = (queue.readpos + written) & (IPU_OutputQueue::SIZE - 1);
+		queue.count -= written;
+	}
+
+	if (queue.decode_done && queue.count == 0)
+	{
+		ResetCommand();
+
+		IPU_LOG("IPU Command finished (threaded)");
+		ipuRegs.topbusy = 0;
+		ipuRegs.cmd.BUSY = 0;
+		ipuRegs.ctrl.BUSY = 0;
+		hwIntcIrq(INTC_IPU);
+	}
+}
+
+bool IPU_Thread::HasOutputSpace()
+{
+	if ((IPU_OutputQueue::SIZE - queue.count) >= MAX_MACROBLOCK_QWC)
+		return true;
+
+	queue.output_full = true;
+	return false;
+}
+
+uint IPU_Thread::WriteOutput(const u32* data, uint size)
+{
+	pxAssertMsg((IPU_OutputQueue::SIZE - queue.count) >= size, "IPU output queue overflow");
+
+	for (uint i = 0; i < size; i++)
+	{
+		CopyQWC(&queue.data[queue.writepos], data);
+		queue.writepos = (queue.writepos + 1) & (IPU_OutputQueue::SIZE - 1);
+		data += 4;
+	}
+
+	queue.count += size;
+	return size;
+}
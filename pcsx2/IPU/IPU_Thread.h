@@ -0,0 +1,113 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Threading.h"
+#include "IPU/IPU.h"
+
+#include <atomic>
+
+// Cycles between kicking the IPU thread and the IPU_PROCESS event which collects its output.
+static constexpr u32 IPU_THREAD_SYNC_CYCLES = 256;
+
+// Decoded macroblocks waiting to be moved into the IPU0 FIFO.
+// Saved into the savestate as-is, so keep it a plain struct.
+struct IPU_OutputQueue
+{
+	static constexpr u32 SIZE = 512; // in QWC, eight RGB32 macroblocks (must be power of 2)
+
+	alignas(16) u128 data[SIZE];
+	u32 readpos, writepos, count;
+
+	bool decode_done;   // Slice fully decoded, retire the command once the queue is drained
+	bool output_full;   // Worker stopped because there was no room for another macroblock
+	bool input_starved; // Worker stopped because the input FIFO ran dry
+	bool ran;           // Worker has run since the last flush
+};
+
+// Notes:
+// - This class should only be accessed from the EE thread, except for the worker-side
+//   functions (HasOutputSpace/WriteOutput) which the decoder calls while on the IPU thread.
+// - The worker only runs IDEC/BDEC between Kick() and the next WaitIdle(). Every EE-side
+//   access to IPU state waits for it first, so the decoder globals are never shared.
+// - FIFO writes and DMAC/INTC interrupts are still raised by the EE from Flush(), which
+//   runs on the IPU_PROCESS event, so the DMAC sees the same cycle costs as without the thread.
+class IPU_Thread final
+{
+	Threading::Thread m_thread;
+	Threading::WorkSema m_sema;
+	std::atomic_bool m_shutdown_flag{false};
+	void (*m_worker)() = nullptr;
+
+public:
+	alignas(16) IPU_OutputQueue queue;
+
+	IPU_Thread();
+	~IPU_Thread();
+
+	/// Returns true if the IPU thread has been started.
+	__fi bool IsOpen() const { return m_thread.Joinable(); }
+
+	/// Ensures the IPU thread is started.
+	void Open();
+
+	/// Waits for any pending decode and shuts down the IPU thread. Queued output is still
+	/// drained by Flush(), so this can be called in the middle of a command.
+	void Close();
+
+	/// Discards any queued output and pending command state.
+	void Reset();
+
+	/// Called when a new command is written, the previous one no longer needs retiring.
+	void ResetCommand();
+
+	/// Returns true when called from the IPU worker thread.
+	bool IsWorkerThread() const;
+
+	/// Returns true if the current command is decoded on the worker rather than inline.
+	bool HandlesCommand() const;
+
+	/// Returns true if the worker has something to do for the current command.
+	bool ShouldKick() const;
+
+	/// Starts decoding the current IDEC/BDEC command on the worker, and schedules the
+	/// IPU_PROCESS event which will collect the result.
+	void Kick();
+
+	/// Waits until the worker has finished its current run.
+	__fi void WaitIdle()
+	{
+		if (IsOpen())
+			m_sema.WaitForEmpty();
+	}
+
+	/// Returns true if decoded output is waiting to be moved into the FIFO, in which
+	/// case the decoder must not write to the FIFO directly.
+	__fi bool HasPendingOutput() const { return queue.count > 0 || queue.decode_done; }
+
+	/// Moves queued macroblocks into the IPU0 FIFO, raises any events the worker couldn't,
+	/// and retires the command when everything has been output. Run on IPU_PROCESS.
+	void Flush();
+
+	// Worker-side
+	bool HasOutputSpace();
+	uint WriteOutput(const u32* data, uint size);
+
+private:
+	void ThreadEntryPoint();
+};
+
+extern IPU_Thread ipu_thread;
@@ -18,6 +18,7 @@
 #include "IPU/IPU.h"
 #include "IPU/IPUdma.h"
 #include "IPU/IPU_MultiISA.h"
+#include "IPU/IPU_Thread.h"
 
 IPUStatus IPU1Status;
 bool CommandExecuteQueued;
@@ -205,6 +206,8 @@ void IPU0dma()
 
 __fi void dmaIPU0() // fromIPU
 {
+	ipu_thread.WaitIdle();
+
 	//if (dmacRegs.ctrl.STS == STS_fromIPU) DevCon.Warning("DMA Stall enabled on IPU0");
 
 	if (dmacRegs.ctrl.STS == STS_fromIPU)   // STS == fromIPU - Initial settings
@@ -235,6 +238,8 @@ __fi void dmaIPU0() // fromIPU
 
 __fi void dmaIPU1() // toIPU
 {
+	ipu_thread.WaitIdle();
+
 	IPU_LOG("IPU1DMAStart QWC %x, MADR %x, CHCR %x, TADR %x", ipu1ch.qwc, ipu1ch.madr, ipu1ch.chcr._u32, ipu1ch.tadr);
 	CPU_SET_DMASTALL(DMAC_TO_IPU, false);
 
@@ -286,6 +291,8 @@ void ipuCMDProcess()
 
 void ipu0Interrupt()
 {
+	ipu_thread.WaitIdle();
+
 	IPU_LOG("ipu0Interrupt: %x", cpuRegs.cycle);
 
 	if(ipu0ch.qwc > 0)
@@ -302,6 +309,8 @@ void ipu0Interrupt()
 
 __fi void ipu1Interrupt()
 {
+	ipu_thread.WaitIdle();
+
 	IPU_LOG("ipu1Interrupt %x:", cpuRegs.cycle);
 
 	if(!IPU1Status.DMAFinished || IPU1Status.InProgress)  //Sanity Check
@@ -25,7 +25,9 @@
 
 #include "common/FastJmp.h"
 
+#include <cstring>
 #include <float.h>
+#include <memory>
 
 using namespace R5900;		// for OPCODE and OpcodeImpl
 
@@ -37,6 +39,113 @@ static std::string disOut;
 static bool intExitExecution = false;
 static fastjmp_buf intJmpBuf;
 
+// Predecoded instruction cache. Code pages in main RAM and the BIOS ROM are decoded into
+// the handler and opcode word for each of their 1024 instructions, so execI() neither
+// goes through the vtlb read path nor walks the opcode tables for code it has already
+// seen. Pages are looked up through the host pointer the PC maps to, so TLB remaps pick
+// the right page. RAM pages are write protected the same way the recompiler protects its
+// blocks, and writes land in intClear() via the page fault handler; pages that keep being
+// cleared (code and data sharing a page) stop being cached and take the slow path.
+struct DecodedInstruction
+{
+	const OPCODE* opcode;
+	u32 code;
+};
+
+struct DecodedPage
+{
+	DecodedInstruction insts[__pagesize / 4];
+};
+
+static constexpr u32 DECODE_RAM_PAGES = Ps2MemSize::MainRam >> __pageshift;
+static constexpr u32 DECODE_ROM_PAGES = Ps2MemSize::Rom >> __pageshift;
+static constexpr u32 DECODE_PAGES = DECODE_RAM_PAGES + DECODE_ROM_PAGES;
+static constexpr u32 DECODE_PAGE_MAX_CLEARS = 8;
+
+static DecodedPage* s_decode_pages[DECODE_PAGES];
+static std::unique_ptr<DecodedPage> s_decode_page_storage[DECODE_PAGES];
+static u8 s_decode_page_clears[DECODE_PAGES];
+
+// Returns the cache page for a host pointer into EE memory, or DECODE_PAGES if it isn't cacheable.
+static __fi u32 intGetDecodePageIndex(uptr ptr)
+{
+	const uptr ram = ptr - (uptr)eeMem->Main;
+	if (ram < Ps2MemSize::MainRam)
+		return static_cast<u32>(ram >> __pageshift);
+
+	const uptr rom = ptr - (uptr)eeMem->ROM;
+	if (rom < Ps2MemSize::Rom)
+		return DECODE_RAM_PAGES + static_cast<u32>(rom >> __pageshift);
+
+	return DECODE_PAGES;
+}
+
+static DecodedPage* intBuildDecodePage(u32 index)
+{
+	if (s_decode_page_clears[index] >= DECODE_PAGE_MAX_CLEARS)
+		return nullptr;
+
+	std::unique_ptr<DecodedPage>& page = s_decode_page_storage[index];
+	if (!page)
+		page = std::make_unique<DecodedPage>();
+	std::memset(page.get(), 0, sizeof(DecodedPage));
+
+	// Protect before anything is decoded, so no write can slip in between.
+	if (index < DECODE_RAM_PAGES)
+		mmap_MarkCountedRamPage(index << __pageshift);
+
+	s_decode_pages[index] = page.get();
+	return page.get();
+}
+
+static void intClearDecodePage(u32 index)
+{
+	if (!s_decode_pages[index])
+		return;
+
+	s_decode_pages[index] = nullptr;
+	if (s_decode_page_clears[index] < DECODE_PAGE_MAX_CLEARS)
+		s_decode_page_clears[index]++;
+}
+
+static void intResetDecodeCache()
+{
+	std::memset(s_decode_pages, 0, sizeof(s_decode_pages));
+	std::memset(s_decode_page_clears, 0, sizeof(s_decode_page_clears));
+}
+
+// Fetches the instruction at pc into cpuRegs.code and returns its opcode.
+static __fi const OPCODE& intFetch(u32 pc)
+{
+	using namespace vtlb_private;
+
+	const VTLBVirtual vmv = vtlbdata.vmap[pc >> VTLB_PAGE_BITS];
+	if (!(pc & 3) && !vmv.isHandler(pc) && !CHECK_CACHE)
+	{
+		const uptr ptr = vmv.assumePtr(pc);
+		const u32 index = intGetDecodePageIndex(ptr);
+		if (index < DECODE_PAGES)
+		{
+			DecodedPage* page = s_decode_pages[index];
+			if (page || (page = intBuildDecodePage(index)))
+			{
+				DecodedInstruction& di = page->insts[(ptr & __pagemask) >> 2];
+				if (!di.opcode)
+				{
+					di.code = *reinterpret_cast<const u32*>(ptr);
+					di.opcode = &GetInstruction(di.code);
+				}
+
+				cpuRegs.code = di.code;
+				return *di.opcode;
+			}
+		}
+	}
+
+	cpuRegs.code = memRead32(pc);
+	return GetInstruction(cpuRegs.code);
+}
+
 static void intEventTest();
 
 // These macros are used to assemble the repassembler functions
@@ -141,9 +250,7 @@ static void execI()
 	cpuRegs.pc += 4;
 
 	// interprete instruction
-	cpuRegs.code = memRead32( pc );
-
-	const OPCODE& opcode = GetCurrentInstruction();
+	const OPCODE& opcode = intFetch(pc);
 #if 0
 	static long int runs = 0;
 	//use this to find out what opcodes your game uses. very slow! (rama)
@@ -481,6 +588,8 @@ static void intReset()
 {
 	cpuRegs.branch = 0;
 	branch2 = 0;
+	intResetDecodeCache();
+	mmap_ResetBlockTracking();
 }
 
 static void intEventTest()
@@ -606,9 +715,36 @@ static void intStep()
 
 static void intClear(u32 Addr, u32 Size)
 {
+	// Size is in words, like recClear(). Addresses are resolved the same way the page
+	// protection code does, so clears coming from a write fault hit the faulting page.
+	if (!eeMem || !Size)
+		return;
+
+	if (Size >= Ps2MemSize::MainRam / 4)
+	{
+		intResetDecodeCache();
+		return;
+	}
+
+	const u32 start = Addr & ~__pagemask;
+	const u32 end = Addr + (Size - 1) * 4;
+	for (u32 paddr = start; paddr - start <= end - start; paddr += __pagesize)
+	{
+		const uptr ptr = (uptr)PSM(paddr);
+		if (!ptr)
+			continue;
+
+		const u32 index = intGetDecodePageIndex(ptr);
+		if (index < DECODE_PAGES)
+			intClearDecodePage(index);
+	}
 }
 
-static void intShutdown() {
+static void intShutdown()
+{
+	intResetDecodeCache();
+	for (std::unique_ptr<DecodedPage>& page : s_decode_page_storage)
+		page.reset();
 }
 
 R5900cpu intCpu =
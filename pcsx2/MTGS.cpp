@@ -29,6 +29,8 @@
 #include "Host.h"
 #include "HostDisplay.h"
 #include "IconsFontAwesome5.h"
+#include "SubsystemProfiler.h"
+#include "TimelineTracer.h"
 #include "VMManager.h"
 
 // Uncomment this to enable profiling of the GS RingBufferCopy function.
@@ -73,11 +75,68 @@ SysMtgsThread::SysMtgsThread()
 	m_SignalRingPosition = 0;
 
 	m_CopyDataTally = 0;
+
+	ResizeRingBuffer(RingBufferSizeFactorDefault);
 }
 
 SysMtgsThread::~SysMtgsThread()
 {
 	ShutdownThread();
+
+	_aligned_free(RingBuffer.m_Ring);
+	RingBuffer.m_Ring = nullptr;
+}
+
+void SysMtgsThread::ResizeRingBuffer(uint size_factor)
+{
+	const uint size = 1u << size_factor;
+	if (RingBuffer.m_Size == size)
+		return;
+
+	pxAssert(m_ReadPos.load() == m_WritePos.load());
+
+	u128* ring = static_cast<u128*>(_aligned_malloc(size * sizeof(u128), 64));
+	if (!ring)
+	{
+		Console.Error("MTGS: Failed to allocate %u MB ringbuffer", (size * 16) / _1mb);
+		pxAssertRel(RingBuffer.m_Ring, "MTGS ringbuffer allocation failed");
+		return;
+	}
+
+	_aligned_free(RingBuffer.m_Ring);
+	RingBuffer.m_Ring = ring;
+	RingBuffer.m_Size = size;
+	RingBuffer.m_Mask = size - 1;
+	m_ReadPos.store(0, std::memory_order_release);
+	m_WritePos.store(0, std::memory_order_release);
+}
+
+// Called once a frame. If the EE spent more than a few percent of the last second waiting for
+// room in the ringbuffer, doubles it, since the GS is running in bursts which don't fit.
+void SysMtgsThread::CheckRingBufferGrowth()
+{
+	static constexpr u32 CHECK_FRAMES = 60;
+	static constexpr u64 MAX_WAIT_NS = 20 * 1000 * 1000;
+
+	if (++m_ring_grow_frames < CHECK_FRAMES)
+		return;
+
+	const u64 wait_ns = m_ring_waiter.GetWaitTimeNS();
+	const u64 waited = wait_ns - m_ring_grow_wait_ns;
+	m_ring_grow_wait_ns = wait_ns;
+	m_ring_grow_frames = 0;
+	if (waited < MAX_WAIT_NS || RingBuffer.m_Size >= (1u << RingBufferSizeFactorMax))
+		return;
+
+	// The ring has to be drained before it can be moved.
+	WaitGS(false, false, false);
+
+	uint size_factor = RingBufferSizeFactorMin;
+	while ((1u << size_factor) <= RingBuffer.m_Size)
+		size_factor++;
+	Console.WriteLn("MTGS: EE waited %.1fms for ringbuffer space in the last second, growing it to %u MB",
+		static_cast<double>(waited) / 1000000.0, (1u << size_factor) * 16 / _1mb);
+	ResizeRingBuffer(size_factor);
 }
 
 void SysMtgsThread::StartThread()
@@ -109,6 +168,7 @@ void SysMtgsThread::ShutdownThread()
 void SysMtgsThread::ThreadEntryPoint()
 {
 	Threading::SetNameOfCurrentThread("GS");
+	TimelineTracer::SetCurrentThreadName("GS");
 
 	if (GSinit() != 0)
 	{
@@ -201,16 +261,19 @@ void SysMtgsThread::PostVsyncStart(bool registers_written)
 	// 256-byte copy is only a few dozen cycles -- executed 60 times a second -- so probably
 	// not worth the effort or overhead of trying to selectively avoid it.
 
+	if (EmuConfig.GS.MTGSGrowRingBuffer)
+		CheckRingBufferGrowth();
+
 	uint packsize = sizeof(RingCmdPacket_Vsync) / 16;
 	PrepDataPacket(GS_RINGTYPE_VSYNC, packsize);
-	MemCopy_WrappedDest((u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBufferSize, 0xf);
+	MemCopy_WrappedDest((u128*)PS2MEM_GS, RingBuffer.m_Ring, m_packet_writepos, RingBuffer.m_Size, 0xf);
 
 	u32* remainder = (u32*)GetDataPacketPtr();
 	remainder[0] = GSCSRr;
 	remainder[1] = GSIMR._u32;
 	(GSRegSIGBLID&)remainder[2] = GSSIGLBLID;
 	remainder[4] = static_cast<u32>(registers_written);
-	m_packet_writepos = (m_packet_writepos + 2) & RingBufferMask;
+	m_packet_writepos = (m_packet_writepos + 2) & RingBuffer.m_Mask;
 
 	SendDataPacket();
 
@@ -311,13 +374,16 @@ void SysMtgsThread::MainLoop()
 		if (!m_open_flag.load(std::memory_order_acquire))
 			break;
 
+		TimelineTracer::ScopedZone zone("MTGS");
+		SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::GS);
+
 		// note: m_ReadPos is intentionally not volatile, because it should only
 		// ever be modified by this thread.
 		while (m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_acquire))
 		{
 			const unsigned int local_ReadPos = m_ReadPos.load(std::memory_order_relaxed);
 
-			pxAssert(local_ReadPos < RingBufferSize);
+			pxAssert(local_ReadPos < RingBuffer.m_Size);
 
 			const PacketTagType& tag = (PacketTagType&)RingBuffer[local_ReadPos];
 			u32 ringposinc = 1;
@@ -342,18 +408,18 @@ void SysMtgsThread::MainLoop()
 #if COPY_GS_PACKET_TO_MTGS == 1
 				case GS_RINGTYPE_P1:
 				{
-					uint datapos = (local_ReadPos + 1) & RingBufferMask;
+					uint datapos = (local_ReadPos + 1) & RingBuffer.m_Mask;
 					const int qsize = tag.data[0];
 					const u128* data = &RingBuffer[datapos];
 
 					MTGS_LOG("(MTGS Packet Read) ringtype=P1, qwc=%u", qsize);
 
 					uint endpos = datapos + qsize;
-					if (endpos >= RingBufferSize)
+					if (endpos >= RingBuffer.m_Size)
 					{
-						uint firstcopylen = RingBufferSize - datapos;
+						uint firstcopylen = RingBuffer.m_Size - datapos;
 						GSgifTransfer((u8*)data, firstcopylen);
-						datapos = endpos & RingBufferMask;
+						datapos = endpos & RingBuffer.m_Mask;
 						GSgifTransfer((u8*)RingBuffer.m_Ring, datapos);
 					}
 					else
@@ -367,18 +433,18 @@ void SysMtgsThread::MainLoop()
 
 				case GS_RINGTYPE_P2:
 				{
-					uint datapos = (local_ReadPos + 1) & RingBufferMask;
+					uint datapos = (local_ReadPos + 1) & RingBuffer.m_Mask;
 					const int qsize = tag.data[0];
 					const u128* data = &RingBuffer[datapos];
 
 					MTGS_LOG("(MTGS Packet Read) ringtype=P2, qwc=%u", qsize);
 
 					uint endpos = datapos + qsize;
-					if (endpos >= RingBufferSize)
+					if (endpos >= RingBuffer.m_Size)
 					{
-						uint firstcopylen = RingBufferSize - datapos;
+						uint firstcopylen = RingBuffer.m_Size - datapos;
 						GSgifTransfer2((u32*)data, firstcopylen);
-						datapos = endpos & RingBufferMask;
+						datapos = endpos & RingBuffer.m_Mask;
 						GSgifTransfer2((u32*)RingBuffer.m_Ring, datapos);
 					}
 					else
@@ -392,18 +458,18 @@ void SysMtgsThread::MainLoop()
 
 				case GS_RINGTYPE_P3:
 				{
-					uint datapos = (local_ReadPos + 1) & RingBufferMask;
+					uint datapos = (local_ReadPos + 1) & RingBuffer.m_Mask;
 					const int qsize = tag.data[0];
 					const u128* data = &RingBuffer[datapos];
 
 					MTGS_LOG("(MTGS Packet Read) ringtype=P3, qwc=%u", qsize);
 
 					uint endpos = datapos + qsize;
-					if (endpos >= RingBufferSize)
+					if (endpos >= RingBuffer.m_Size)
 					{
-						uint firstcopylen = RingBufferSize - datapos;
+						uint firstcopylen = RingBuffer.m_Size - datapos;
 						GSgifTransfer3((u32*)data, firstcopylen);
-						datapos = endpos & RingBufferMask;
+						datapos = endpos & RingBuffer.m_Mask;
 						GSgifTransfer3((u32*)RingBuffer.m_Ring, datapos);
 					}
 					else
@@ -433,7 +499,7 @@ void SysMtgsThread::MainLoop()
 					{
 						mtvu_lock.unlock();
 						// Wait for MTVU to complete vu1 program
-						vu1Thread.semaXGkick.Wait();
+						m_xgkick_waiter.Wait([]() { return vu1Thread.semaXGkick.TryWait(); }, []() { vu1Thread.semaXGkick.Wait(); });
 						mtvu_lock.lock();
 					}
 					Gif_Path& path = gifUnit.gifPath[GIF_PATH_1];
@@ -460,8 +526,8 @@ void SysMtgsThread::MainLoop()
 							// This seemingly obtuse system is needed in order to handle cases where the vsync data wraps
 							// around the edge of the ringbuffer.  If not for that I'd just use a struct. >_<
 
-							uint datapos = (local_ReadPos + 1) & RingBufferMask;
-							MemCopy_WrappedSrc(RingBuffer.m_Ring, datapos, RingBufferSize, (u128*)RingBuffer.Regs, 0xf);
+							uint datapos = (local_ReadPos + 1) & RingBuffer.m_Mask;
+							MemCopy_WrappedSrc(RingBuffer.m_Ring, datapos, RingBuffer.m_Size, (u128*)RingBuffer.Regs, 0xf);
 
 							u32* remainder = (u32*)&RingBuffer[datapos];
 							((u32&)RingBuffer.Regs[0x1000]) = remainder[0];
@@ -533,7 +599,7 @@ void SysMtgsThread::MainLoop()
 				}
 			}
 
-			uint newringpos = (m_ReadPos.load(std::memory_order_relaxed) + ringposinc) & RingBufferMask;
+			uint newringpos = (m_ReadPos.load(std::memory_order_relaxed) + ringposinc) & RingBuffer.m_Mask;
 
 			if (EmuConfig.GS.SynchronousMTGS)
 			{
@@ -623,7 +689,12 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 	}
 	else
 	{
-		if (!m_sem_event.WaitForEmpty())
+		bool alive = true;
+		if (isMTVU)
+			alive = m_sem_event.WaitForEmpty();
+		else
+			m_sync_waiter.Wait([this]() { return m_sem_event.IsEmpty(); }, [this, &alive]() { alive = m_sem_event.WaitForEmpty(); });
+		if (!alive)
 			pxFailRel("MTGS Thread Died");
 	}
 
@@ -646,7 +717,7 @@ void SysMtgsThread::SetEvent()
 
 u8* SysMtgsThread::GetDataPacketPtr() const
 {
-	return (u8*)&RingBuffer[m_packet_writepos & RingBufferMask];
+	return (u8*)&RingBuffer[m_packet_writepos & RingBuffer.m_Mask];
 }
 
 // Closes the data packet send command, and initiates the gs thread (if needed).
@@ -655,9 +726,9 @@ void SysMtgsThread::SendDataPacket()
 	// make sure a previous copy block has been started somewhere.
 	pxAssert(m_packet_size != 0);
 
-	uint actualSize = ((m_packet_writepos - m_packet_startpos) & RingBufferMask) - 1;
+	uint actualSize = ((m_packet_writepos - m_packet_startpos) & RingBuffer.m_Mask) - 1;
 	pxAssert(actualSize <= m_packet_size);
-	pxAssert(m_packet_writepos < RingBufferSize);
+	pxAssert(m_packet_writepos < RingBuffer.m_Size);
 
 	PacketTagType& tag = (PacketTagType&)RingBuffer[m_packet_startpos];
 	tag.data[0] = actualSize;
@@ -688,84 +759,51 @@ void SysMtgsThread::GenericStall(uint size)
 	const uint writepos = m_WritePos.load(std::memory_order_relaxed);
 
 	// Sanity checks! (within the confines of our ringbuffer please!)
-	pxAssert(size < RingBufferSize);
-	pxAssert(writepos < RingBufferSize);
+	pxAssert(size < RingBuffer.m_Size);
+	pxAssert(writepos < RingBuffer.m_Size);
 
 	// generic gs wait/stall.
 	// if the writepos is past the readpos then we're safe.
 	// But if not then we need to make sure the readpos is outside the scope of
 	// the block about to be written (writepos + size)
 
-	uint readpos = m_ReadPos.load(std::memory_order_acquire);
-	uint freeroom;
-
-	if (writepos < readpos)
-		freeroom = readpos - writepos;
-	else
-		freeroom = RingBufferSize - (writepos - readpos);
+	const auto get_free_room = [this, writepos]() {
+		const uint readpos = m_ReadPos.load(std::memory_order_acquire);
+		return (writepos < readpos) ? (readpos - writepos) : (RingBuffer.m_Size - (writepos - readpos));
+	};
 
+	const uint freeroom = get_free_room();
 	if (freeroom <= size)
 	{
 		// writepos will overlap readpos if we commit the data, so we need to wait until
 		// readpos is out past the end of the future write pos, or until it wraps around
 		// (in which case writepos will be >= readpos).
 
-		// Ideally though we want to wait longer, because if we just toss in this packet
-		// the next packet will likely stall up too.  So lets set a condition for the MTGS
-		// thread to wake up the EE once there's a sizable chunk of the ringbuffer emptied.
-
-		uint somedone = (RingBufferSize - freeroom) / 4;
-		if (somedone < size + 1)
-			somedone = size + 1;
-
-		// FMV Optimization: FMVs typically send *very* little data to the GS, in some cases
-		// every other frame is nothing more than a page swap.  Sleeping the EEcore is a
-		// waste of time, and we get better results using a spinwait.
-
-		if (somedone > 0x80)
-		{
-			pxAssertDev(m_SignalRingEnable == 0, "MTGS Thread Synchronization Error");
-			m_SignalRingPosition.store(somedone, std::memory_order_release);
-
-			//Console.WriteLn( Color_Blue, "(EEcore Sleep) PrepDataPacker \tringpos=0x%06x, writepos=0x%06x, signalpos=0x%06x", readpos, writepos, m_SignalRingPosition );
-
-			while (true)
-			{
-				m_SignalRingEnable.store(true, std::memory_order_release);
-				SetEvent();
-				m_sem_OnRingReset.Wait();
-				readpos = m_ReadPos.load(std::memory_order_acquire);
-				//Console.WriteLn( Color_Blue, "(EEcore Awake) Report!\tringpos=0x%06x", readpos );
-
-				if (writepos < readpos)
-					freeroom = readpos - writepos;
-				else
-					freeroom = RingBufferSize - (writepos - readpos);
-
-				if (freeroom > size)
-					break;
-			}
-
-			pxAssertDev(m_SignalRingPosition <= 0, "MTGS Thread Synchronization Error");
-		}
-		else
-		{
-			//Console.WriteLn( Color_StrongGray, "(EEcore Spin) PrepDataPacket!" );
-			SetEvent();
-			while (true)
-			{
-				SpinWait();
-				readpos = m_ReadPos.load(std::memory_order_acquire);
-
-				if (writepos < readpos)
-					freeroom = readpos - writepos;
-				else
-					freeroom = RingBufferSize - (writepos - readpos);
+		// How long this usually takes decides whether we spin or sleep. FMVs typically send
+		// *very* little data to the GS, so the MTGS catches up quickly and spinning wins, but
+		// sleeping is better when it's behind on a heavy frame, or the host is short on cores.
+		SetEvent();
+		m_ring_waiter.Wait([&get_free_room, size]() { return get_free_room() > size; },
+			[this, &get_free_room, freeroom, size]() {
+				// Ideally we want to sleep longer than needed, because if we just toss in this packet
+				// the next packet will likely stall up too. So lets set a condition for the MTGS
+				// thread to wake up the EE once there's a sizable chunk of the ringbuffer emptied.
+				uint somedone = (RingBuffer.m_Size - freeroom) / 4;
+				if (somedone < size + 1)
+					somedone = size + 1;
+
+				pxAssertDev(m_SignalRingEnable == 0, "MTGS Thread Synchronization Error");
+				m_SignalRingPosition.store(somedone, std::memory_order_release);
+
+				do
+				{
+					m_SignalRingEnable.store(true, std::memory_order_release);
+					SetEvent();
+					m_sem_OnRingReset.Wait();
+				} while (get_free_room() <= size);
 
-				if (freeroom > size)
-					break;
-			}
-		}
+				pxAssertDev(m_SignalRingPosition <= 0, "MTGS Thread Synchronization Error");
+			});
 	}
 }
 
@@ -783,7 +821,7 @@ void SysMtgsThread::PrepDataPacket(MTGS_RingCommand cmd, u32 size)
 	tag.command = cmd;
 	tag.data[0] = m_packet_size;
 	m_packet_startpos = local_WritePos;
-	m_packet_writepos = (local_WritePos + 1) & RingBufferMask;
+	m_packet_writepos = (local_WritePos + 1) & RingBuffer.m_Mask;
 }
 
 // Returns the amount of giftag data processed (in simd128 values).
@@ -800,7 +838,7 @@ void SysMtgsThread::PrepDataPacket(GIF_PATH pathidx, u32 size)
 
 __fi void SysMtgsThread::_FinishSimplePacket()
 {
-	uint future_writepos = (m_WritePos.load(std::memory_order_relaxed) + 1) & RingBufferMask;
+	uint future_writepos = (m_WritePos.load(std::memory_order_relaxed) + 1) & RingBuffer.m_Mask;
 	pxAssert(future_writepos != m_ReadPos.load(std::memory_order_acquire));
 	m_WritePos.store(future_writepos, std::memory_order_release);
 
@@ -863,6 +901,15 @@ bool SysMtgsThread::WaitForOpen()
 
 	StartThread();
 
+	// The ring can only change size while it's empty, which it usually is until the GS opens.
+	if (m_ReadPos.load() == m_WritePos.load())
+	{
+		uint size_factor = RingBufferSizeFactorMin;
+		while (size_factor < RingBufferSizeFactorMax && (1u << (size_factor - 16)) < static_cast<uint>(EmuConfig.GS.MTGSRingBufferSize))
+			size_factor++;
+		ResizeRingBuffer(size_factor);
+	}
+
 	// request open, and kick the thread.
 	m_open_flag.store(true, std::memory_order_release);
 	m_sem_event.NotifyOfWork();
@@ -18,6 +18,7 @@
 #include "MTVU.h"
 #include "newVif.h"
 #include "Gif_Unit.h"
+#include "TimelineTracer.h"
 #include "common/Threading.h"
 #include <thread>
 
@@ -136,6 +137,7 @@ void VU_Thread::Reset()
 void VU_Thread::ExecuteRingBuffer()
 {
 	Threading::SetNameOfCurrentThread("MTVU");
+	TimelineTracer::SetCurrentThreadName("MTVU");
 
 	for (;;)
 	{
@@ -143,6 +145,8 @@ void VU_Thread::ExecuteRingBuffer()
 		if (m_shutdown_flag.load(std::memory_order_acquire))
 			break;
 
+		TimelineTracer::ScopedZone zone("MTVU");
+
 		while (m_ato_read_pos.load(std::memory_order_relaxed) != GetWritePos())
 		{
 			u32 tag = Read();
@@ -150,6 +154,7 @@ void VU_Thread::ExecuteRingBuffer()
 			{
 				case MTVU_VU_EXECUTE:
 				{
+					TimelineTracer::ScopedZone execute_zone("VU1 Execute");
 					VU1.cycle = 0;
 					s32 addr = Read();
 					vifRegs.top = Read();
@@ -443,7 +448,7 @@ bool VU_Thread::IsDone()
 void VU_Thread::WaitVU()
 {
 	MTVU_LOG("MTVU - WaitVU!");
-	semaEvent.WaitForEmpty();
+	waiterSync.Wait([this]() { return semaEvent.IsEmpty(); }, [this]() { semaEvent.WaitForEmpty(); });
 }
 
 void VU_Thread::ExecuteVU(u32 vu_addr, u32 vif_top, u32 vif_itop, u32 fbrst)
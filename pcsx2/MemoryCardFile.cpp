@@ -21,6 +21,7 @@
 
 #include <array>
 #include <chrono>
+#include <vector>
 
 #include "MemoryCardFile.h"
 #include "MemoryCardFolder.h"
@@ -40,53 +41,21 @@ static const int MCD_SIZE = 1024 * 8 * 16; // Legacy PSX card default size
 
 static const int MC2_MBSIZE = 1024 * 528 * 2; // Size of a single megabyte of card data
 
+// Cards up to this size are kept in memory, and written back to the file in batches
+static const s64 MCD_MAX_IMAGE_SIZE = 64 * static_cast<s64>(MC2_MBSIZE);
+
+// Number of frames without writes before dirty parts of the image are written back to the file
+static const int MCD_FRAMES_AFTER_WRITE_UNTIL_FLUSH = 2;
+
 static const char* s_folder_mem_card_id_file = "_pcsx2_superblock";
 
 bool FileMcd_Open = false;
 
-// ECC code ported from mymc
-// https://sourceforge.net/p/mymc-opl/code/ci/master/tree/ps2mc_ecc.py
-// Public domain license
-
-static u32 CalculateECC(u8* buf)
+static u32 CalculateECC(const u8* buf)
 {
-	const u8 parity_table[256] = {0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,1,0,0,1,0,1,1,
-	0,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1,1,0,0,1,0,
-	1,1,0,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,0,1,1,
-	0,1,0,0,1,1,0,0,1,0,1,1,0,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,0,
-	1,1,0,1,0,0,1,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,
-	0,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,1,0,0,1,0,
-	1,1,0,0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0,0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1,1,0,0,
-	1,0,1,1,0};
-
-	const u8 column_parity_mask[256] = {0,7,22,17,37,34,51,52,52,51,34,37,17,22,
-	7,0,67,68,85,82,102,97,112,119,119,112,97,102,82,85,68,67,82,85,68,67,119,112,
-	97,102,102,97,112,119,67,68,85,82,17,22,7,0,52,51,34,37,37,34,51,52,0,7,22,17,
-	97,102,119,112,68,67,82,85,85,82,67,68,112,119,102,97,34,37,52,51,7,0,17,22,
-	22,17,0,7,51,52,37,34,51,52,37,34,22,17,0,7,7,0,17,22,34,37,52,51,112,119,102,
-	97,85,82,67,68,68,67,82,85,97,102,119,112,112,119,102,97,85,82,67,68,68,67,82,
-	85,97,102,119,112,51,52,37,34,22,17,0,7,7,0,17,22,34,37,52,51,34,37,52,51,7,0,
-	17,22,22,17,0,7,51,52,37,34,97,102,119,112,68,67,82,85,85,82,67,68,112,119,102,
-	97,17,22,7,0,52,51,34,37,37,34,51,52,0,7,22,17,82,85,68,67,119,112,97,102,102,
-	97,112,119,67,68,85,82,67,68,85,82,102,97,112,119,119,112,97,102,82,85,68,67,
-	0,7,22,17,37,34,51,52,52,51,34,37,17,22,7,0};
-
-	u8 column_parity = 0x77;
-	u8 line_parity_0 = 0x7F;
-	u8 line_parity_1 = 0x7F;
-
-	for (int i = 0; i < 128; i++)
-	{
-		u8 b = buf[i];
-		column_parity ^= column_parity_mask[b];
-		if (parity_table[b])
-		{
-			line_parity_0 ^= ~i;
-			line_parity_1 ^= i;
-		}
-	}
-
-	return column_parity | (line_parity_0 << 8) | (line_parity_1 << 16);
+	u8 ecc[3];
+	FolderMemoryCard::CalculateECC(ecc, buf);
+	return ecc[0] | (ecc[1] << 8) | (ecc[2] << 16);
 }
 
 static bool ConvertNoECCtoRAW(const char* file_in, const char* file_out)
@@ -162,6 +131,8 @@ static bool ConvertRAWtoNoECC(const char* file_in, const char* file_out)
 //  FileMemoryCard
 // --------------------------------------------------------------------------------------
 // Provides thread-safe direct file IO mapping.
+// Cards are loaded into memory on open, reads are served from the image and writes are
+// tracked per erase block and written back to the file once the game stops writing.
 //
 class FileMemoryCard
 {
@@ -174,6 +145,15 @@ protected:
 	bool m_ispsx[8];
 	u32 m_chkaddr;
 
+	// whole file contents, empty if the card is too large and accessed through the file directly
+	std::vector<u8> m_image[8];
+	// offset of the card data in the file, for PSX cards with a header
+	u32 m_imageOffset[8];
+	// one entry per sizeof(m_effeffs) bytes of the image
+	std::vector<bool> m_dirtyBlocks[8];
+	// if > 0, the amount of frames until dirty blocks are written back
+	int m_framesUntilFlush[8];
+
 public:
 	FileMemoryCard();
 	virtual ~FileMemoryCard() = default;
@@ -191,10 +171,19 @@ public:
 	s32 Save(uint slot, const u8* src, u32 adr, int size);
 	s32 EraseBlock(uint slot, u32 adr);
 	u64 GetCRC(uint slot);
+	void NextFrame(uint slot);
 
 protected:
 	bool Seek(std::FILE* f, u32 adr);
 	bool Create(const char* mcdFile, uint sizeInMB);
+
+	u32 GetDataOffset(s64 size) const;
+	void LoadImage(uint slot);
+	bool ReadData(uint slot, u8* dest, u32 adr, int size);
+	bool WriteData(uint slot, const u8* src, u32 adr, int size);
+
+	// writes the dirty blocks of the image back to the file
+	void Flush(uint slot);
 };
 
 uint FileMcd_GetMtapPort(uint slot)
@@ -261,6 +250,12 @@ FileMemoryCard::FileMemoryCard()
 	: m_chkaddr(0)
 {
 	memset8<0xff>(m_effeffs);
+
+	for (int slot = 0; slot < 8; ++slot)
+	{
+		m_imageOffset[slot] = 0;
+		m_framesUntilFlush[slot] = 0;
+	}
 }
 
 void FileMemoryCard::Open()
@@ -368,6 +363,8 @@ void FileMemoryCard::Open()
 				if (read_result == 0)
 					Host::ReportFormattedErrorAsync("Memory Card", "Error reading memcard.\n");
 			}
+
+			LoadImage(slot);
 		}
 	}
 }
@@ -379,6 +376,10 @@ void FileMemoryCard::Close()
 		if (!m_file[slot])
 			continue;
 
+		Flush(slot);
+		m_image[slot] = {};
+		m_dirtyBlocks[slot] = {};
+
 		// Store checksum
 		if (!m_ispsx[slot] && FileSystem::FSeek64(m_file[slot], m_chkaddr, SEEK_SET) == 0)
 			std::fwrite(&m_chksum[slot], sizeof(m_chksum[slot]), 1, m_file[slot]);
@@ -400,8 +401,11 @@ void FileMemoryCard::Close()
 // Returns FALSE if the seek failed (is outside the bounds of the file).
 bool FileMemoryCard::Seek(std::FILE* f, u32 adr)
 {
-	const s64 size = FileSystem::FSize64(f);
+	return (FileSystem::FSeek64(f, adr + GetDataOffset(FileSystem::FSize64(f)), SEEK_SET) == 0);
+}
 
+u32 FileMemoryCard::GetDataOffset(s64 size) const
+{
 	// If anyone knows why this filesize logic is here (it appears to be related to legacy PSX
 	// cards, perhaps hacked support for some special emulator-specific memcard formats that
 	// had header info?), then please replace this comment with something useful.  Thanks!  -- air
@@ -417,7 +421,115 @@ bool FileMemoryCard::Seek(std::FILE* f, u32 adr)
 		// perform sanity checks here?
 	}
 
-	return (FileSystem::FSeek64(f, adr + offset, SEEK_SET) == 0);
+	return offset;
+}
+
+void FileMemoryCard::LoadImage(uint slot)
+{
+	m_image[slot] = {};
+	m_dirtyBlocks[slot] = {};
+	m_framesUntilFlush[slot] = 0;
+
+	const s64 size = FileSystem::FSize64(m_file[slot]);
+	m_imageOffset[slot] = GetDataOffset(size);
+	if (size <= 0 || size > MCD_MAX_IMAGE_SIZE)
+		return;
+
+	std::vector<u8> image(static_cast<size_t>(size));
+	if (FileSystem::FSeek64(m_file[slot], 0, SEEK_SET) != 0 || std::fread(image.data(), image.size(), 1, m_file[slot]) != 1)
+	{
+		Console.Warning("(FileMcd) Failed to load slot %u into memory, using direct file access.", slot);
+		return;
+	}
+
+	m_image[slot] = std::move(image);
+	m_dirtyBlocks[slot].resize((m_image[slot].size() + sizeof(m_effeffs) - 1) / sizeof(m_effeffs));
+}
+
+bool FileMemoryCard::ReadData(uint slot, u8* dest, u32 adr, int size)
+{
+	std::vector<u8>& image = m_image[slot];
+	if (image.empty())
+		return Seek(m_file[slot], adr) && std::fread(dest, size, 1, m_file[slot]) == 1;
+
+	const u64 start = static_cast<u64>(adr) + m_imageOffset[slot];
+	if (start + size > image.size())
+		return false;
+
+	std::memcpy(dest, &image[start], size);
+	return true;
+}
+
+bool FileMemoryCard::WriteData(uint slot, const u8* src, u32 adr, int size)
+{
+	std::vector<u8>& image = m_image[slot];
+	if (image.empty())
+		return Seek(m_file[slot], adr) && std::fwrite(src, size, 1, m_file[slot]) == 1;
+
+	// writing past the end grows the file
+	const u64 start = static_cast<u64>(adr) + m_imageOffset[slot];
+	if (start + size > image.size())
+	{
+		if (start + size > static_cast<u64>(MCD_MAX_IMAGE_SIZE))
+		{
+			Flush(slot);
+			image = {};
+			m_dirtyBlocks[slot] = {};
+			return WriteData(slot, src, adr, size);
+		}
+
+		image.resize(start + size, 0);
+		m_dirtyBlocks[slot].resize((image.size() + sizeof(m_effeffs) - 1) / sizeof(m_effeffs));
+	}
+
+	std::memcpy(&image[start], src, size);
+
+	const size_t firstBlock = start / sizeof(m_effeffs);
+	const size_t lastBlock = (start + size - 1) / sizeof(m_effeffs);
+	for (size_t block = firstBlock; block <= lastBlock; block++)
+		m_dirtyBlocks[slot][block] = true;
+
+	m_framesUntilFlush[slot] = MCD_FRAMES_AFTER_WRITE_UNTIL_FLUSH;
+	return true;
+}
+
+void FileMemoryCard::Flush(uint slot)
+{
+	std::vector<u8>& image = m_image[slot];
+	std::vector<bool>& dirty = m_dirtyBlocks[slot];
+	m_framesUntilFlush[slot] = 0;
+
+	// write consecutive dirty blocks in one go
+	bool written = false;
+	for (size_t block = 0; block < dirty.size();)
+	{
+		if (!dirty[block])
+		{
+			block++;
+			continue;
+		}
+
+		size_t end = block + 1;
+		while (end < dirty.size() && dirty[end])
+			end++;
+
+		const size_t start = block * sizeof(m_effeffs);
+		const size_t length = std::min(end * sizeof(m_effeffs), image.size()) - start;
+		if (FileSystem::FSeek64(m_file[slot], static_cast<s64>(start), SEEK_SET) != 0 ||
+			std::fwrite(&image[start], length, 1, m_file[slot]) != 1)
+		{
+			Console.Error("(FileMcd) Failed to write slot %u back to the file.", slot);
+			return;
+		}
+
+		for (; block < end; block++)
+			dirty[block] = false;
+
+		written = true;
+	}
+
+	if (written)
+		std::fflush(m_file[slot]);
 }
 
 // returns FALSE if an error occurred (either permission denied or disk full)
@@ -451,7 +563,10 @@ void FileMemoryCard::GetSizeInfo(uint slot, McdSizeInfo& outways)
 	outways.Xor = 18;                     // 0x12, XOR 02 00 00 10
 
 	if (pxAssert(m_file[slot]))
-		outways.McdSizeInSectors = static_cast<u32>(FileSystem::FSize64(m_file[slot])) / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+	{
+		const s64 size = m_image[slot].empty() ? FileSystem::FSize64(m_file[slot]) : static_cast<s64>(m_image[slot].size());
+		outways.McdSizeInSectors = static_cast<u32>(size) / (outways.SectorSize + outways.EraseBlockSizeInSectors);
+	}
 	else
 		outways.McdSizeInSectors = 0x4000;
 
@@ -473,9 +588,7 @@ s32 FileMemoryCard::Read(uint slot, u8* dest, u32 adr, int size)
 		memset(dest, 0, size);
 		return 1;
 	}
-	if (!Seek(mcfp, adr))
-		return 0;
-	return std::fread(dest, size, 1, mcfp) == 1;
+	return ReadData(slot, dest, adr, size);
 }
 
 s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
@@ -496,12 +609,9 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 	}
 	else
 	{
-		if (!Seek(mcfp, adr))
-			return 0;
 		m_currentdata.MakeRoomFor(size);
 
-		const size_t read_result = std::fread(m_currentdata.GetPtr(), size, 1, mcfp);
-		if (read_result == 0)
+		if (!ReadData(slot, m_currentdata.GetPtr(), adr, size))
 			Host::ReportFormattedErrorAsync("Memory Card", "Error reading memcard.\n");
 
 		for (int i = 0; i < size; i++)
@@ -524,10 +634,7 @@ s32 FileMemoryCard::Save(uint slot, const u8* src, u32 adr, int size)
 		}
 	}
 
-	if (!Seek(mcfp, adr))
-		return 0;
-
-	if (std::fwrite(m_currentdata.GetPtr(), size, 1, mcfp) == 1)
+	if (WriteData(slot, m_currentdata.GetPtr(), adr, size))
 	{
 		static auto last = std::chrono::time_point<std::chrono::system_clock>();
 
@@ -554,9 +661,7 @@ s32 FileMemoryCard::EraseBlock(uint slot, u32 adr)
 		return 1;
 	}
 
-	if (!Seek(mcfp, adr))
-		return 0;
-	return std::fwrite(m_effeffs, sizeof(m_effeffs), 1, mcfp) == 1;
+	return WriteData(slot, m_effeffs, adr, sizeof(m_effeffs));
 }
 
 u64 FileMemoryCard::GetCRC(uint slot)
@@ -569,10 +674,7 @@ u64 FileMemoryCard::GetCRC(uint slot)
 
 	if (m_ispsx[slot])
 	{
-		if (!Seek(mcfp, 0))
-			return 0;
-
-		const s64 mcfpsize = FileSystem::FSize64(mcfp);
+		const s64 mcfpsize = m_image[slot].empty() ? FileSystem::FSize64(mcfp) : static_cast<s64>(m_image[slot].size());
 		if (mcfpsize < 0)
 			return 0;
 
@@ -581,9 +683,9 @@ u64 FileMemoryCard::GetCRC(uint slot)
 		u64 buffer[528 * 8]; // use 528 (sector size), ensures even divisibility
 
 		const uint filesize = static_cast<uint>(mcfpsize) / sizeof(buffer);
-		for (uint i = filesize; i; --i)
+		for (uint i = 0; i < filesize; ++i)
 		{
-			if (std::fread(buffer, sizeof(buffer), 1, mcfp) != 1)
+			if (!ReadData(slot, reinterpret_cast<u8*>(buffer), i * sizeof(buffer), sizeof(buffer)))
 				return 0;
 
 			for (uint t = 0; t < std::size(buffer); ++t)
@@ -598,6 +700,12 @@ u64 FileMemoryCard::GetCRC(uint slot)
 	return retval;
 }
 
+void FileMemoryCard::NextFrame(uint slot)
+{
+	if (m_framesUntilFlush[slot] > 0 && --m_framesUntilFlush[slot] == 0)
+		Flush(slot);
+}
+
 // --------------------------------------------------------------------------------------
 //  MemoryCard Component API Bindings
 // --------------------------------------------------------------------------------------
@@ -759,9 +867,9 @@ void FileMcd_NextFrame(uint port, uint slot)
 	const uint combinedSlot = FileMcd_ConvertToSlot(port, slot);
 	switch (EmuConfig.Mcd[combinedSlot].Type)
 	{
-		//case MemoryCardType::MemoryCard_File:
-		//	Mcd::impl.NextFrame( combinedSlot );
-		//	break;
+		case MemoryCardType::File:
+			Mcd::impl.NextFrame(combinedSlot);
+			break;
 		case MemoryCardType::Folder:
 			Mcd::implFolder.NextFrame(combinedSlot);
 			break;
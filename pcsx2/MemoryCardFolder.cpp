@@ -135,8 +135,16 @@ FolderMemoryCard::FolderMemoryCard()
 {
 }
 
+FolderMemoryCard::~FolderMemoryCard()
+{
+	StopFlushThread();
+}
+
 void FolderMemoryCard::InitializeInternalData()
 {
+	// don't pull the caches out from under a flush which is still writing
+	WaitForFlush();
+
 	memset(&m_superBlock, 0xFF, sizeof(m_superBlock));
 	memset(&m_indirectFat, 0xFF, sizeof(m_indirectFat));
 	memset(&m_fat, 0xFF, sizeof(m_fat));
@@ -144,6 +152,10 @@ void FolderMemoryCard::InitializeInternalData()
 	memset(&m_backupBlock2, 0xFF, sizeof(m_backupBlock2));
 	m_cache.clear();
 	m_oldDataCache.clear();
+	m_flushCache.clear();
+	m_flushOldDataCache.clear();
+	m_pendingPages.clear();
+	m_sizeInClusters = TotalClusters;
 	m_lastAccessedFile.CloseAll();
 	m_fileMetadataQuickAccess.clear();
 	m_timeLastWritten = 0;
@@ -224,6 +236,9 @@ void FolderMemoryCard::Close(bool flush)
 		return;
 	}
 
+	// let any background flush finish first, its data has already been committed by the game
+	StopFlushThread();
+
 	if (flush)
 	{
 		Flush();
@@ -254,6 +269,9 @@ bool FolderMemoryCard::ReIndex(bool enableFiltering, const std::string& filter)
 
 void FolderMemoryCard::LoadMemoryCardData(const u32 sizeInClusters, const bool enableFiltering, const std::string& filter)
 {
+	// the caches and the superblock are swapped out below, a flush still writing them has to finish first
+	WaitForFlush();
+
 	bool formatted = false;
 
 	// read superblock if it exists
@@ -267,10 +285,17 @@ void FolderMemoryCard::LoadMemoryCardData(const u32 sizeInClusters, const bool e
 		}
 	}
 
-	if (sizeInClusters > 0 && sizeInClusters != GetSizeInClusters())
+	m_sizeInClusters = ReadSizeInClusters();
+	if (sizeInClusters > 0 && sizeInClusters != m_sizeInClusters)
 	{
 		SetSizeInClusters(sizeInClusters);
+
+		// apply the new superblock to the internal data right away
+		m_flushCache = std::move(m_cache);
+		m_cache.clear();
 		FlushBlock(0);
+		m_cache = std::move(m_flushCache);
+		m_flushCache.clear();
 	}
 
 	// if superblock was valid, load folders and files
@@ -984,8 +1009,14 @@ s32 FolderMemoryCard::Read(u8* dest, u32 adr, int size)
 		{
 			memcpy(dest, &it->second.raw[offset], dataLength);
 		}
+		else if (auto pendingIt = m_pendingPages.find(page); pendingIt != m_pendingPages.end())
+		{
+			memcpy(dest, &pendingIt->second.raw[offset], dataLength);
+		}
 		else
 		{
+			// the flush thread may be modifying the internal data or the files
+			WaitForFlush();
 			ReadDataWithoutCache(dest, adr, dataLength);
 		}
 	}
@@ -1062,9 +1093,23 @@ s32 FolderMemoryCard::Save(const u8* src, u32 adr, int size)
 		MemoryCardPage* cachePage;
 		if (it == m_cache.end())
 		{
+			auto pendingIt = m_pendingPages.find(page);
+			if (pendingIt == m_pendingPages.end())
+			{
+				// the flush thread may be modifying the internal data or the files
+				WaitForFlush();
+			}
+
 			cachePage = &m_cache[page];
-			const u32 adrLoad = page * PageSizeRaw;
-			ReadDataWithoutCache(&cachePage->raw[0], adrLoad, PageSize);
+			if (pendingIt != m_pendingPages.end())
+			{
+				memcpy(&cachePage->raw[0], &pendingIt->second.raw[0], PageSize);
+			}
+			else
+			{
+				const u32 adrLoad = page * PageSizeRaw;
+				ReadDataWithoutCache(&cachePage->raw[0], adrLoad, PageSize);
+			}
 			memcpy(&m_oldDataCache[page].raw[0], &cachePage->raw[0], PageSize);
 		}
 		else
@@ -1083,19 +1128,135 @@ s32 FolderMemoryCard::Save(const u8* src, u32 adr, int size)
 
 void FolderMemoryCard::NextFrame()
 {
+	// pick up a background flush which has finished writing
+	if (m_flushQueued && !m_flushWriting.load(std::memory_order_acquire))
+	{
+		WaitForFlush();
+	}
+
 	if (m_framesUntilFlush > 0 && --m_framesUntilFlush == 0)
 	{
-		Flush();
+		if (m_flushQueued)
+		{
+			// previous flush is still writing, try again next frame instead of stalling
+			m_framesUntilFlush = 1;
+		}
+		else
+		{
+			FlushInBackground();
+		}
 	}
 }
 
 void FolderMemoryCard::Flush()
 {
+	WaitForFlush();
+	if (m_cache.empty())
+	{
+		return;
+	}
+
+	SnapshotCache();
+	WriteFlushCache();
+	FinishFlush();
+}
+
+void FolderMemoryCard::FlushInBackground()
+{
+	WaitForFlush();
 	if (m_cache.empty())
 	{
 		return;
 	}
 
+	if (!m_flushThread.Joinable())
+	{
+		m_flushSema.Reset();
+		m_flushThreadShutdown.store(false, std::memory_order_release);
+		m_flushThread.Start([this]() { FlushThreadEntryPoint(); });
+	}
+
+	SnapshotCache();
+	m_pendingPages = m_flushCache;
+	m_flushQueued = true;
+	m_flushWriting.store(true, std::memory_order_release);
+	m_flushSema.NotifyOfWork();
+}
+
+void FolderMemoryCard::SnapshotCache()
+{
+	pxAssert(m_flushCache.empty() && m_flushOldDataCache.empty());
+	m_flushCache = std::move(m_cache);
+	m_flushOldDataCache = std::move(m_oldDataCache);
+	m_cache.clear();
+	m_oldDataCache.clear();
+}
+
+void FolderMemoryCard::WaitForFlush()
+{
+	if (!m_flushQueued)
+	{
+		return;
+	}
+
+	m_flushSema.WaitForEmpty();
+	FinishFlush();
+}
+
+void FolderMemoryCard::FinishFlush()
+{
+	// Pages are left over if the flush was aborted, keep them around for the next one.
+	// Anything saved again since the snapshot is newer, but the old data still has to be the one from before the snapshot.
+	for (const auto& [page, data] : m_flushCache)
+	{
+		m_cache.try_emplace(page, data);
+
+		auto oldIt = m_flushOldDataCache.find(page);
+		if (oldIt != m_flushOldDataCache.end())
+		{
+			m_oldDataCache[page] = oldIt->second;
+		}
+	}
+
+	m_flushCache.clear();
+	m_flushOldDataCache.clear();
+	m_pendingPages.clear();
+	m_flushQueued = false;
+}
+
+void FolderMemoryCard::StopFlushThread()
+{
+	WaitForFlush();
+
+	if (!m_flushThread.Joinable())
+	{
+		return;
+	}
+
+	m_flushThreadShutdown.store(true, std::memory_order_release);
+	m_flushSema.NotifyOfWork();
+	m_flushThread.Join();
+}
+
+void FolderMemoryCard::FlushThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread(fmt::format("FolderMcd Slot {}", m_slot).c_str());
+
+	for (;;)
+	{
+		m_flushSema.WaitForWork();
+		if (m_flushThreadShutdown.load(std::memory_order_acquire))
+		{
+			break;
+		}
+
+		WriteFlushCache();
+		m_flushWriting.store(false, std::memory_order_release);
+	}
+}
+
+void FolderMemoryCard::WriteFlushCache()
+{
 #ifdef DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
 	WriteToFile(m_folderName.GetFullPath().RemoveLast() + L"-debug_" + wxDateTime::Now().Format(L"%Y-%m-%d-%H-%M-%S") + L"_pre-flush.ps2");
 #endif
@@ -1126,7 +1287,7 @@ void FolderMemoryCard::Flush()
 		return;
 	}
 
-	const u32 clusterCount = GetSizeInClusters();
+	const u32 clusterCount = ReadSizeInClusters();
 	const u32 pageCount = clusterCount * 2;
 
 	// then write the indirect FAT
@@ -1159,14 +1320,16 @@ void FolderMemoryCard::Flush()
 	FlushDeletedFilesAndRemoveUnchangedDataFromCache(oldFileEntryTree);
 
 	// and finally, flush everything that hasn't been flushed yet
-	for (uint i = 0; i < pageCount; ++i)
+	// going through the snapshot in page order keeps the writes to each file sequential, so consecutive pages end up in one buffered write
+	for (auto it = m_flushCache.begin(); it != m_flushCache.end() && it->first < pageCount;)
 	{
-		FlushPage(i);
+		WriteWithoutCache(&it->second.raw[0], it->first * PageSizeRaw, PageSize);
+		it = m_flushCache.erase(it);
 	}
 
 	m_lastAccessedFile.FlushAll();
 	m_lastAccessedFile.ClearMetadataWriteState();
-	m_oldDataCache.clear();
+	m_flushOldDataCache.clear();
 
 	Console.WriteLn("(FolderMcd) Done! Took %.2f ms.", timeFlushStart.GetTimeMilliseconds());
 
@@ -1177,11 +1340,11 @@ void FolderMemoryCard::Flush()
 
 bool FolderMemoryCard::FlushPage(const u32 page)
 {
-	auto it = m_cache.find(page);
-	if (it != m_cache.end())
+	auto it = m_flushCache.find(page);
+	if (it != m_flushCache.end())
 	{
 		WriteWithoutCache(&it->second.raw[0], page * PageSizeRaw, PageSize);
-		m_cache.erase(it);
+		m_flushCache.erase(it);
 		return true;
 	}
 	return false;
@@ -1431,7 +1594,7 @@ void FolderMemoryCard::FlushDeletedFilesAndRemoveUnchangedDataFromCache(const st
 			}
 			else if (entry->IsFile())
 			{
-				// still exists and is a file, see if we can remove unchanged data from m_cache
+				// still exists and is a file, see if we can remove unchanged data from m_flushCache
 				RemoveUnchangedDataFromCache(entry, newEntry);
 			}
 		}
@@ -1457,20 +1620,20 @@ void FolderMemoryCard::RemoveUnchangedDataFromCache(const MemoryCardFileEntry* c
 		for (int i = 0; i < 2; ++i)
 		{
 			const u32 page = (cluster + alloc_offset) * 2 + i;
-			auto newIt = m_cache.find(page);
-			if (newIt == m_cache.end())
+			auto newIt = m_flushCache.find(page);
+			if (newIt == m_flushCache.end())
 			{
 				continue;
 			}
-			auto oldIt = m_oldDataCache.find(page);
-			if (oldIt == m_oldDataCache.end())
+			auto oldIt = m_flushOldDataCache.find(page);
+			if (oldIt == m_flushOldDataCache.end())
 			{
 				continue;
 			}
 
 			if (memcmp(&oldIt->second.raw[0], &newIt->second.raw[0], PageSize) == 0)
 			{
-				m_cache.erase(newIt);
+				m_flushCache.erase(newIt);
 			}
 		}
 
@@ -1682,6 +1845,11 @@ void FolderMemoryCard::SetSlot(uint slot)
 }
 
 u32 FolderMemoryCard::GetSizeInClusters() const
+{
+	return m_sizeInClusters;
+}
+
+u32 FolderMemoryCard::ReadSizeInClusters() const
 {
 	const u32 clusters = m_superBlock.data.clusters_per_card;
 	if (clusters > 0 && clusters < 0xFFFFFFFFu)
@@ -1700,6 +1868,7 @@ void FolderMemoryCard::SetSizeInClusters(u32 clusters)
 	memcpy(&newSuperBlock.raw[0], &m_superBlock.raw[0], sizeof(newSuperBlock.raw));
 
 	newSuperBlock.data.clusters_per_card = clusters;
+	m_sizeInClusters = clusters;
 
 	const u32 alloc_offset = clusters / 0x100 + 9;
 	newSuperBlock.data.alloc_offset = alloc_offset;
@@ -1926,50 +2095,73 @@ void FolderMemoryCard::DeleteFromIndex(const std::string& filePath, const std::s
 	}
 }
 
+static __fi u32 Parity16(u32 v)
+{
+	v ^= v >> 8;
+	v ^= v >> 4;
+	v ^= v >> 2;
+	v ^= v >> 1;
+	return v & 1;
+}
+
 // from http://www.oocities.org/siliconvalley/station/8269/sma02/sma02.html#ECC
 void FolderMemoryCard::CalculateECC(u8* ecc, const u8* data)
 {
-	static const u8 Table[] = {
-		0x00, 0x87, 0x96, 0x11, 0xa5, 0x22, 0x33, 0xb4, 0xb4, 0x33, 0x22, 0xa5, 0x11, 0x96, 0x87, 0x00,
-		0xc3, 0x44, 0x55, 0xd2, 0x66, 0xe1, 0xf0, 0x77, 0x77, 0xf0, 0xe1, 0x66, 0xd2, 0x55, 0x44, 0xc3,
-		0xd2, 0x55, 0x44, 0xc3, 0x77, 0xf0, 0xe1, 0x66, 0x66, 0xe1, 0xf0, 0x77, 0xc3, 0x44, 0x55, 0xd2,
-		0x11, 0x96, 0x87, 0x00, 0xb4, 0x33, 0x22, 0xa5, 0xa5, 0x22, 0x33, 0xb4, 0x00, 0x87, 0x96, 0x11,
-		0xe1, 0x66, 0x77, 0xf0, 0x44, 0xc3, 0xd2, 0x55, 0x55, 0xd2, 0xc3, 0x44, 0xf0, 0x77, 0x66, 0xe1,
-		0x22, 0xa5, 0xb4, 0x33, 0x87, 0x00, 0x11, 0x96, 0x96, 0x11, 0x00, 0x87, 0x33, 0xb4, 0xa5, 0x22,
-		0x33, 0xb4, 0xa5, 0x22, 0x96, 0x11, 0x00, 0x87, 0x87, 0x00, 0x11, 0x96, 0x22, 0xa5, 0xb4, 0x33,
-		0xf0, 0x77, 0x66, 0xe1, 0x55, 0xd2, 0xc3, 0x44, 0x44, 0xc3, 0xd2, 0x55, 0xe1, 0x66, 0x77, 0xf0,
-		0xf0, 0x77, 0x66, 0xe1, 0x55, 0xd2, 0xc3, 0x44, 0x44, 0xc3, 0xd2, 0x55, 0xe1, 0x66, 0x77, 0xf0,
-		0x33, 0xb4, 0xa5, 0x22, 0x96, 0x11, 0x00, 0x87, 0x87, 0x00, 0x11, 0x96, 0x22, 0xa5, 0xb4, 0x33,
-		0x22, 0xa5, 0xb4, 0x33, 0x87, 0x00, 0x11, 0x96, 0x96, 0x11, 0x00, 0x87, 0x33, 0xb4, 0xa5, 0x22,
-		0xe1, 0x66, 0x77, 0xf0, 0x44, 0xc3, 0xd2, 0x55, 0x55, 0xd2, 0xc3, 0x44, 0xf0, 0x77, 0x66, 0xe1,
-		0x11, 0x96, 0x87, 0x00, 0xb4, 0x33, 0x22, 0xa5, 0xa5, 0x22, 0x33, 0xb4, 0x00, 0x87, 0x96, 0x11,
-		0xd2, 0x55, 0x44, 0xc3, 0x77, 0xf0, 0xe1, 0x66, 0x66, 0xe1, 0xf0, 0x77, 0xc3, 0x44, 0x55, 0xd2,
-		0xc3, 0x44, 0x55, 0xd2, 0x66, 0xe1, 0xf0, 0x77, 0x77, 0xf0, 0xe1, 0x66, 0xd2, 0x55, 0x44, 0xc3,
-		0x00, 0x87, 0x96, 0x11, 0xa5, 0x22, 0x33, 0xb4, 0xb4, 0x33, 0x22, 0xa5, 0x11, 0x96, 0x87, 0x00};
-
-	ecc[0] = ecc[1] = ecc[2] = 0;
+	// The column parity is linear over the data bits, so it only depends on the XOR of all bytes.
+	static constexpr u8 ColumnParity[8] = {0x07, 0x16, 0x25, 0x34, 0x43, 0x52, 0x61, 0x70};
 
-	for (int i = 0; i < 0x80; i++)
+	// The line parity is the XOR of the indices of all bytes with an odd number of bits set,
+	// so build a bitmask of those bytes 16 at a time and count the bits at each index bit instead.
+	__m128i xorBytes = _mm_setzero_si128();
+	u32 oddBytes[8];
+	for (int i = 0; i < 8; i++)
 	{
-		const int c = Table[data[i]];
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16));
+		xorBytes = _mm_xor_si128(xorBytes, v);
+
+		// fold the parity of each byte into its lowest bit, then move it to the top for movemask
+		__m128i parity = _mm_xor_si128(v, _mm_srli_epi16(v, 4));
+		parity = _mm_xor_si128(parity, _mm_srli_epi16(parity, 2));
+		parity = _mm_xor_si128(parity, _mm_srli_epi16(parity, 1));
+		oddBytes[i] = static_cast<u32>(_mm_movemask_epi8(_mm_slli_epi16(parity, 7)));
+	}
+
+	xorBytes = _mm_xor_si128(xorBytes, _mm_srli_si128(xorBytes, 8));
+	xorBytes = _mm_xor_si128(xorBytes, _mm_srli_si128(xorBytes, 4));
+	u32 folded = static_cast<u32>(_mm_cvtsi128_si32(xorBytes));
+	folded ^= folded >> 16;
+	folded ^= folded >> 8;
 
-		ecc[0] ^= c;
-		if (c & 0x80)
+	u8 column = 0;
+	for (int bit = 0; bit < 8; bit++)
+	{
+		if (folded & (1u << bit))
 		{
-			ecc[1] ^= ~i;
-			ecc[2] ^= i;
+			column ^= ColumnParity[bit];
 		}
 	}
-	ecc[0] = ~ecc[0];
-	ecc[0] &= 0x77;
 
-	ecc[1] = ~ecc[1];
-	ecc[1] &= 0x7f;
+	u32 allOdd = 0;
+	u32 line = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		allOdd ^= oddBytes[i];
+		if (Parity16(oddBytes[i]))
+		{
+			line ^= i << 4;
+		}
+	}
+	line |= Parity16(allOdd & 0xAAAAu) << 0;
+	line |= Parity16(allOdd & 0xCCCCu) << 1;
+	line |= Parity16(allOdd & 0xF0F0u) << 2;
+	line |= Parity16(allOdd & 0xFF00u) << 3;
 
-	ecc[2] = ~ecc[2];
-	ecc[2] &= 0x7f;
+	// the parity of all bytes also tells whether an odd number of bytes had their inverted index XORed in
+	const u8 lineInverted = Parity16(allOdd) ? static_cast<u8>(~line) : static_cast<u8>(line);
 
-	return;
+	ecc[0] = ~column & 0x77;
+	ecc[1] = ~lineInverted & 0x7f;
+	ecc[2] = ~line & 0x7f;
 }
 
 void FolderMemoryCard::WriteToFile(const std::string& filename)
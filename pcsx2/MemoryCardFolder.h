@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <string_view>
@@ -22,6 +23,8 @@
 
 #include "Config.h"
 
+#include "common/Threading.h"
+
 #include "fmt/core.h"
 
 //#define DEBUG_WRITE_FOLDER_CARD_IN_MEMORY_TO_FILE_ON_CHANGE
@@ -295,6 +298,12 @@ protected:
 	// used to reduce the amount of disk I/O by not re-writing unchanged data that just happened to be
 	// touched in memory due to how actual physical memory cards have to erase and rewrite in blocks
 	std::map<u32, MemoryCardPage> m_oldDataCache;
+	// snapshot of m_cache and m_oldDataCache taken when a flush starts, only touched by the flush itself
+	std::map<u32, MemoryCardPage> m_flushCache;
+	std::map<u32, MemoryCardPage> m_flushOldDataCache;
+	// read-only copy of the pages being written by a background flush, so Read() and Save() don't have
+	// to wait for the file system when accessing data that was just saved
+	std::map<u32, MemoryCardPage> m_pendingPages;
 	// if > 0, the amount of frames until data is flushed to the file system
 	// reset to FramesAfterWriteUntilFlush on each write
 	int m_framesUntilFlush;
@@ -304,6 +313,18 @@ protected:
 	// remembers and keeps the last accessed file open for further access
 	FileAccessHelper m_lastAccessedFile;
 
+	// writes flushed data to the host file system, started on the first background flush
+	Threading::Thread m_flushThread;
+	Threading::WorkSema m_flushSema;
+	std::atomic_bool m_flushThreadShutdown{false};
+	// set while the flush thread is writing, cleared by the flush thread when it's done
+	std::atomic_bool m_flushWriting{false};
+	// set when a background flush was started and its leftovers haven't been picked up yet
+	bool m_flushQueued = false;
+	// card size taken from the superblock when the card is opened or resized, so size queries
+	// don't have to wait for the flush thread which may be writing m_superBlock
+	u32 m_sizeInClusters = TotalClusters;
+
 	// path to the folder that contains the files of this memory card
 	std::string m_folderName;
 
@@ -321,7 +342,7 @@ protected:
 
 public:
 	FolderMemoryCard();
-	virtual ~FolderMemoryCard() = default;
+	virtual ~FolderMemoryCard();
 
 	void Lock();
 	void Unlock();
@@ -480,9 +501,33 @@ protected:
 	bool WriteToFile(const u8* src, u32 adr, u32 dataLength);
 
 
-	// flush the whole cache to the internal data and/or host file system
+	// flush the whole cache to the internal data and/or host file system, waits until done
 	void Flush();
 
+	// start flushing the whole cache on the flush thread, Read() and Save() can continue while it runs
+	void FlushInBackground();
+
+	// move m_cache and m_oldDataCache into m_flushCache and m_flushOldDataCache
+	void SnapshotCache();
+
+	// write m_flushCache to the internal data and/or host file system, runs on the flush thread for background flushes
+	void WriteFlushCache();
+
+	// wait for a running background flush to complete, then call FinishFlush()
+	void WaitForFlush();
+
+	// reads the card size from the superblock, callers outside of the flush must WaitForFlush() first,
+	// everything else uses the size cached by LoadMemoryCardData()
+	u32 ReadSizeInClusters() const;
+
+	// hand any pages the flush couldn't write back to m_cache and drop m_pendingPages
+	void FinishFlush();
+
+	// wait for any background flush and shut down the flush thread
+	void StopFlushThread();
+
+	void FlushThreadEntryPoint();
+
 	// flush a single page of the cache to the internal data and/or host file system
 	bool FlushPage(const u32 page);
 
@@ -511,7 +556,7 @@ protected:
 	// - dirPath: Path to the current directory relative to the root of the memcard. Must be identical for both entries.
 	void FlushDeletedFilesAndRemoveUnchangedDataFromCache(const std::vector<MemoryCardFileEntryTreeNode>& oldFileEntries, const u32 newCluster, const u32 newFileCount, const std::string& dirPath);
 
-	// try and remove unchanged data from m_cache
+	// try and remove unchanged data from m_flushCache
 	// oldEntry and newEntry should be equivalent entries found by FindEquivalent()
 	void RemoveUnchangedDataFromCache(const MemoryCardFileEntry* const oldEntry, const MemoryCardFileEntry* const newEntry);
 
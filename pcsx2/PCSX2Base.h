@@ -20,7 +20,9 @@
 
 #include "common/Pcsx2Defs.h"
 
-#if defined(__AVX2__)
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(__AVX512DQ__) && defined(__AVX2__)
+	#define _M_SSE 0x600
+#elif defined(__AVX2__)
 	#define _M_SSE 0x501
 #elif defined(__AVX__)
 	#define _M_SSE 0x500
@@ -15,8 +15,6 @@
 
 #include "PrecompiledHeader.h"
 
-#ifdef PCSX2_LEFTOVER_FROM_WX
-
 #include <stdio.h>
 #include <stdlib.h>
 #include <thread>
@@ -25,6 +23,7 @@
 #define read_portable(a, b, c) (recv(a, b, c, 0))
 #define write_portable(a, b, c) (send(a, b, c, 0))
 #define close_portable(a) (closesocket(a))
+#define shutdown_portable(a) (shutdown(a, SD_BOTH))
 #define bzero(b, len) (memset((b), '\0', (len)), (void)0)
 #include <WinSock2.h>
 #include <windows.h>
@@ -32,21 +31,35 @@
 #define read_portable(a, b, c) (read(a, b, c))
 #define write_portable(a, b, c) (write(a, b, c))
 #define close_portable(a) (close(a))
+#define shutdown_portable(a) (shutdown(a, SHUT_RDWR))
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <unistd.h>
 #endif
 
+#include "common/Threading.h"
+#include "fmt/core.h"
+
 #include "Common.h"
+#include "Counters.h"
+#include "Host.h"
 #include "Memory.h"
-#include "gui/AppSaveStates.h"
-#include "gui/AppCoreThread.h"
-#include "gui/SysThreads.h"
+#include "System.h"
+#include "VMManager.h"
 #include "svnrev.h"
 #include "PINE.h"
 
-PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
-	: pxThread("PINE_Server")
+PINEServer::PINEServer() = default;
+
+PINEServer::~PINEServer()
+{
+	Deinitialize();
+}
+
+bool PINEServer::Initialize(int slot)
 {
+	m_end = false;
+
 #ifdef _WIN32
 	WSADATA wsa;
 	struct sockaddr_in server;
@@ -55,14 +68,15 @@ PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
 	if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
 	{
 		Console.WriteLn(Color_Red, "PINE: Cannot initialize winsock! Shutting down...");
-		return;
+		return false;
 	}
 
 	m_sock = socket(AF_INET, SOCK_STREAM, 0);
 	if ((m_sock == INVALID_SOCKET) || slot > 65536)
 	{
 		Console.WriteLn(Color_Red, "PINE: Cannot open socket! Shutting down...");
-		return;
+		Deinitialize();
+		return false;
 	}
 
 	// yes very good windows s/sun/sin/g sure is fine
@@ -74,7 +88,8 @@ PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
 	if (bind(m_sock, (struct sockaddr*)&server, sizeof(server)) == SOCKET_ERROR)
 	{
 		Console.WriteLn(Color_Red, "PINE: Error while binding to socket! Shutting down...");
-		return;
+		Deinitialize();
+		return false;
 	}
 
 #else
@@ -103,7 +118,8 @@ PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
 	if (m_sock < 0)
 	{
 		Console.WriteLn(Color_Red, "PINE: Cannot open socket! Shutting down...");
-		return;
+		Deinitialize();
+		return false;
 	}
 	server.sun_family = AF_UNIX;
 	strcpy(server.sun_path, m_socket_name.c_str());
@@ -114,7 +130,8 @@ PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
 	if (bind(m_sock, (struct sockaddr*)&server, sizeof(struct sockaddr_un)))
 	{
 		Console.WriteLn(Color_Red, "PINE: Error while binding to socket! Shutting down...");
-		return;
+		Deinitialize();
+		return false;
 	}
 #endif
 
@@ -123,11 +140,69 @@ PINEServer::PINEServer(SysCoreThread* vm, unsigned int slot)
 	// that a "reasonable" value is 5, which is not.
 	listen(m_sock, 4096);
 
-	// we save a handle of the main vm object
-	m_vm = vm;
+	// we allocate once buffers to not have to do mallocs for each IPC
+	// request, as malloc is expansive when we optimize for µs.
+	m_ret_buffer = new char[MAX_IPC_RETURN_SIZE];
+	m_ipc_buffer = new char[MAX_IPC_SIZE];
+
+	m_slot = slot;
 
 	// we start the thread
-	Start();
+	m_thread = std::thread(&PINEServer::ExecuteTaskInThread, this);
+	return true;
+}
+
+void PINEServer::Deinitialize()
+{
+	m_end = true;
+	m_slot = 0;
+
+	// shutting the sockets down wakes the server thread up from accept()/read()
+#ifdef _WIN32
+	if (m_msgsock != INVALID_SOCKET)
+	{
+		shutdown_portable(m_msgsock);
+		close_portable(m_msgsock);
+		m_msgsock = INVALID_SOCKET;
+	}
+	if (m_sock != INVALID_SOCKET)
+	{
+		shutdown_portable(m_sock);
+		close_portable(m_sock);
+		m_sock = INVALID_SOCKET;
+	}
+#else
+	if (m_msgsock >= 0)
+	{
+		shutdown_portable(m_msgsock);
+		close_portable(m_msgsock);
+		m_msgsock = -1;
+	}
+	if (m_sock >= 0)
+	{
+		shutdown_portable(m_sock);
+		close_portable(m_sock);
+		m_sock = -1;
+	}
+	if (!m_socket_name.empty())
+	{
+		unlink(m_socket_name.c_str());
+		m_socket_name.clear();
+	}
+#endif
+
+	if (m_thread.joinable())
+		m_thread.join();
+
+#ifdef _WIN32
+	WSACleanup();
+#endif
+
+	delete[] m_ret_buffer;
+	m_ret_buffer = nullptr;
+	delete[] m_ipc_buffer;
+	m_ipc_buffer = nullptr;
+	m_watch_list.clear();
 }
 
 char* PINEServer::MakeOkIPC(char* ret_buffer, uint32_t size = 5)
@@ -146,10 +221,17 @@ char* PINEServer::MakeFailIPC(char* ret_buffer, uint32_t size = 5)
 
 int PINEServer::StartSocket()
 {
+	if (m_end)
+		return -1;
+
 	m_msgsock = accept(m_sock, 0, 0);
 
 	if (m_msgsock == -1)
 	{
+		// we're being shut down, accept() failing is expected.
+		if (m_end)
+			return -1;
+
 		// everything else is non recoverable in our scope
 		// we also mark as recoverable socket errors where it would block a
 		// non blocking socket, even though our socket is blocking, in case
@@ -172,17 +254,12 @@ int PINEServer::StartSocket()
 
 void PINEServer::ExecuteTaskInThread()
 {
-	m_end = false;
-
-	// we allocate once buffers to not have to do mallocs for each IPC
-	// request, as malloc is expansive when we optimize for µs.
-	m_ret_buffer = new char[MAX_IPC_RETURN_SIZE];
-	m_ipc_buffer = new char[MAX_IPC_SIZE];
+	Threading::SetNameOfCurrentThread("PINE Server");
 
 	if (StartSocket() < 0)
 		return;
 
-	while (true)
+	while (!m_end)
 	{
 		// either int or ssize_t depending on the platform, so we have to
 		// use a bunch of auto
@@ -237,27 +314,21 @@ void PINEServer::ExecuteTaskInThread()
 			}
 		}
 	}
-	return;
 }
 
-PINEServer::~PINEServer()
+u64 PINEServer::ReadWatch(u32 address, u8 width)
 {
-	m_end = true;
-#ifdef _WIN32
-	WSACleanup();
-#else
-	unlink(m_socket_name.c_str());
-#endif
-	close_portable(m_sock);
-	close_portable(m_msgsock);
-	delete[] m_ret_buffer;
-	delete[] m_ipc_buffer;
-	// destroy the thread
-	try
+	switch (width)
 	{
-		pxThread::Cancel();
+		case 1:
+			return memRead8(address);
+		case 2:
+			return memRead16(address);
+		case 4:
+			return memRead32(address);
+		default:
+			return memRead64(address);
 	}
-	DESTRUCTOR_CATCHALL
 }
 
 PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32 buf_size)
@@ -285,7 +356,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 		{
 			case MsgRead8:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 1, buf_size))
 					goto error;
@@ -298,7 +369,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgRead16:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 2, buf_size))
 					goto error;
@@ -311,7 +382,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgRead32:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 4, buf_size))
 					goto error;
@@ -324,7 +395,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgRead64:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 8, buf_size))
 					goto error;
@@ -337,7 +408,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgWrite8:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 1 + 4, ret_cnt, 0, buf_size))
 					goto error;
@@ -348,7 +419,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgWrite16:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 2 + 4, ret_cnt, 0, buf_size))
 					goto error;
@@ -359,7 +430,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgWrite32:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 4 + 4, ret_cnt, 0, buf_size))
 					goto error;
@@ -370,7 +441,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgWrite64:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 8 + 4, ret_cnt, 0, buf_size))
 					goto error;
@@ -381,7 +452,7 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgVersion:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				char version[256] = {};
 				if (GIT_TAGGED_COMMIT) // Nightly builds
@@ -406,90 +477,82 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 			}
 			case MsgSaveState:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 1, ret_cnt, 0, buf_size))
 					goto error;
-				StateCopy_SaveToSlot(FromArray<u8>(&buf[buf_cnt], 0));
+				const s32 slot = FromArray<u8>(&buf[buf_cnt], 0);
+				Host::RunOnCPUThread([slot]() { VMManager::SaveStateToSlot(slot); });
 				buf_cnt += 1;
 				break;
 			}
 			case MsgLoadState:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
 				if (!SafetyChecks(buf_cnt, 1, ret_cnt, 0, buf_size))
 					goto error;
-				StateCopy_LoadFromSlot(FromArray<u8>(&buf[buf_cnt], 0), false);
+				const s32 slot = FromArray<u8>(&buf[buf_cnt], 0);
+				Host::RunOnCPUThread([slot]() { VMManager::LoadStateFromSlot(slot); });
 				buf_cnt += 1;
 				break;
 			}
 			case MsgTitle:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
-				char* title = new char[GameInfo::gameName.size() + 1];
-				sprintf(title, "%s", GameInfo::gameName.ToUTF8().data());
-				const u32 size = strlen(title) + 1;
-				title[size] = 0x00;
+				const std::string title(VMManager::GetGameName());
+				const u32 size = static_cast<u32>(title.size()) + 1;
 				if (!SafetyChecks(buf_cnt, 0, ret_cnt, size + 4, buf_size))
 					goto error;
 				ToArray(ret_buffer, size, ret_cnt);
 				ret_cnt += 4;
-				memcpy(&ret_buffer[ret_cnt], title, size);
+				memcpy(&ret_buffer[ret_cnt], title.c_str(), size);
 				ret_cnt += size;
-				delete[] title;
 				break;
 			}
 			case MsgID:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
-				char* title = new char[GameInfo::gameSerial.size() + 1];
-				sprintf(title, "%s", GameInfo::gameSerial.ToUTF8().data());
-				const u32 size = strlen(title) + 1;
-				title[size] = 0x00;
+				const std::string title(VMManager::GetGameSerial());
+				const u32 size = static_cast<u32>(title.size()) + 1;
 				if (!SafetyChecks(buf_cnt, 0, ret_cnt, size + 4, buf_size))
 					goto error;
 				ToArray(ret_buffer, size, ret_cnt);
 				ret_cnt += 4;
-				memcpy(&ret_buffer[ret_cnt], title, size);
+				memcpy(&ret_buffer[ret_cnt], title.c_str(), size);
 				ret_cnt += size;
-				delete[] title;
 				break;
 			}
 			case MsgUUID:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
 					goto error;
-				char* title = new char[GameInfo::gameCRC.size() + 1];
-				sprintf(title, "%s", GameInfo::gameCRC.ToUTF8().data());
-				const u32 size = strlen(title) + 1;
-				title[size] = 0x00;
+				const std::string title(fmt::format("{:08x}", VMManager::GetGameCRC()));
+				const u32 size = static_cast<u32>(title.size()) + 1;
 				if (!SafetyChecks(buf_cnt, 0, ret_cnt, size + 4, buf_size))
 					goto error;
 				ToArray(ret_buffer, size, ret_cnt);
 				ret_cnt += 4;
-				memcpy(&ret_buffer[ret_cnt], title, size);
+				memcpy(&ret_buffer[ret_cnt], title.c_str(), size);
 				ret_cnt += size;
-				delete[] title;
 				break;
 			}
 			case MsgGameVersion:
 			{
-				if (!m_vm->HasActiveMachine())
+				if (!VMManager::HasValidVM())
+					goto error;
+				const std::string version(VMManager::GetGameVersion());
+				if (version.empty())
 					goto error;
-				char* title = new char[GameInfo::gameVersion.size() + 1];
-				sprintf(title, "%s", GameInfo::gameVersion.ToUTF8().data());
-				const u32 size = strlen(title) + 1;
-				title[size] = 0x00;
+				const u32 size = static_cast<u32>(version.size()) + 1;
 				if (!SafetyChecks(buf_cnt, 0, ret_cnt, size + 4, buf_size))
 					goto error;
 				ToArray(ret_buffer, size, ret_cnt);
 				ret_cnt += 4;
-				memcpy(&ret_buffer[ret_cnt], title, size);
+				memcpy(&ret_buffer[ret_cnt], version.c_str(), size);
 				ret_cnt += size;
-				delete[] title;
 				break;
 			}
 			case MsgStatus:
@@ -497,20 +560,155 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 				if (!SafetyChecks(buf_cnt, 0, ret_cnt, 4, buf_size))
 					goto error;
 				EmuStatus status;
-				if (m_vm->HasActiveMachine())
+				switch (VMManager::GetState())
 				{
-					if (GetCoreThread().IsClosing())
-						status = Paused;
-					else
+					case VMState::Running:
 						status = Running;
+						break;
+					case VMState::Paused:
+						status = Paused;
+						break;
+					default:
+						status = Shutdown;
+						break;
 				}
-				else
+				ToArray(ret_buffer, status, ret_cnt);
+				ret_cnt += 4;
+				break;
+			}
+			case MsgReadN:
+			{
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+					goto error;
+				u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+				const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+				if (size > MAX_IPC_RETURN_SIZE || !SafetyChecks(buf_cnt, 8, ret_cnt, size, buf_size))
+					goto error;
+				// one vtlb lookup per doubleword rather than one IPC round trip per value
+				u32 i = 0;
+				for (; i < size && (a & 7) != 0; i++, a++)
+					ret_buffer[ret_cnt + i] = memRead8(a);
+				for (; (size - i) >= 8; i += 8, a += 8)
+					ToArray(ret_buffer, memRead64(a), ret_cnt + i);
+				for (; i < size; i++, a++)
+					ret_buffer[ret_cnt + i] = memRead8(a);
+				ret_cnt += size;
+				buf_cnt += 8;
+				break;
+			}
+			case MsgWriteN:
+			{
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 8, ret_cnt, 0, buf_size))
+					goto error;
+				u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+				const u32 size = FromArray<u32>(&buf[buf_cnt], 4);
+				if (size > MAX_IPC_SIZE || !SafetyChecks(buf_cnt, 8 + size, ret_cnt, 0, buf_size))
+					goto error;
+				const char* data = &buf[buf_cnt + 8];
+				u32 i = 0;
+				for (; i < size && (a & 7) != 0; i++, a++)
+					memWrite8(a, static_cast<u8>(data[i]));
+				for (; (size - i) >= 8; i += 8, a += 8)
 				{
-					status = Shutdown;
+					u64 value;
+					memcpy(&value, &data[i], sizeof(value));
+					memWrite64(a, value);
 				}
-				ToArray(ret_buffer, status, ret_cnt);
+				for (; i < size; i++, a++)
+					memWrite8(a, static_cast<u8>(data[i]));
+				buf_cnt += 8 + size;
+				break;
+			}
+			case MsgWatchSet:
+			{
+				// format: count (4 bytes), then count * (address (4 bytes), width (1 byte))
+				// reply: the current value of every entry, 8 bytes each, so that
+				// MsgWatchPoll only has to send what changed afterwards
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 4, ret_cnt, 0, buf_size))
+					goto error;
+				const u32 count = FromArray<u32>(&buf[buf_cnt], 0);
+				if (count > MAX_IPC_WATCHES || !SafetyChecks(buf_cnt, 4 + count * 5, ret_cnt, count * 8, buf_size))
+					goto error;
+				buf_cnt += 4;
+
+				std::vector<WatchEntry> watches;
+				watches.reserve(count);
+				for (u32 i = 0; i < count; i++)
+				{
+					const u32 a = FromArray<u32>(&buf[buf_cnt], 0);
+					const u8 width = FromArray<u8>(&buf[buf_cnt], 4);
+					if (width != 1 && width != 2 && width != 4 && width != 8)
+						goto error;
+					const u64 value = ReadWatch(a, width);
+					watches.push_back({a, width, value});
+					ToArray(ret_buffer, value, ret_cnt);
+					ret_cnt += 8;
+					buf_cnt += 5;
+				}
+				m_watch_list = std::move(watches);
+				break;
+			}
+			case MsgWatchPoll:
+			{
+				// reply: frame count (4 bytes), changed count (4 bytes), then
+				// changed count * (watch index (4 bytes), value (8 bytes))
+				// clients poll this once per frame instead of re-reading everything,
+				// the frame count lets them tell whether a vsync happened in between
+				if (!VMManager::HasValidVM())
+					goto error;
+				if (!SafetyChecks(buf_cnt, 0, ret_cnt, 8 + static_cast<int>(m_watch_list.size()) * 12, buf_size))
+					goto error;
+				ToArray<u32>(ret_buffer, g_FrameCount, ret_cnt);
+				const u32 count_pos = ret_cnt + 4;
+				ret_cnt += 8;
+
+				u32 changed = 0;
+				for (u32 i = 0; i < static_cast<u32>(m_watch_list.size()); i++)
+				{
+					WatchEntry& entry = m_watch_list[i];
+					const u64 value = ReadWatch(entry.address, entry.width);
+					if (value == entry.last_value)
+						continue;
+
+					entry.last_value = value;
+					ToArray(ret_buffer, i, ret_cnt);
+					ToArray(ret_buffer, value, ret_cnt + 4);
+					ret_cnt += 12;
+					changed++;
+				}
+				ToArray(ret_buffer, changed, count_pos);
+				break;
+			}
+			case MsgSharedMemory:
+			{
+				// reply: name size (4 bytes), name, offset of EE RAM (4 bytes), size of EE RAM (4 bytes)
+				// local clients can map the object themselves and read EE RAM without any IPC.
+				if (!VMManager::HasValidVM())
+					goto error;
+#ifdef _WIN32
+				const std::string name(HostSys::GetFileMappingName("pcsx2"));
+				const u32 size = static_cast<u32>(name.size()) + 1;
+				if (!SafetyChecks(buf_cnt, 0, ret_cnt, size + 12, buf_size))
+					goto error;
+				ToArray(ret_buffer, size, ret_cnt);
 				ret_cnt += 4;
+				memcpy(&ret_buffer[ret_cnt], name.c_str(), size);
+				ret_cnt += size;
+				ToArray<u32>(ret_buffer, HostMemoryMap::EEmemOffset + offsetof(EEVM_MemoryAllocMess, Main), ret_cnt);
+				ToArray<u32>(ret_buffer, Ps2MemSize::MainRam, ret_cnt + 4);
+				ret_cnt += 8;
 				break;
+#else
+				// the POSIX shared memory object is unlinked as soon as it is mapped,
+				// so there is nothing other processes could open.
+				goto error;
+#endif
 			}
 			default:
 			{
@@ -521,5 +719,3 @@ PINEServer::IPCBuffer PINEServer::ParseCommand(char* buf, char* ret_buffer, u32
 	}
 	return IPCBuffer{(int)ret_cnt, MakeOkIPC(ret_buffer, ret_cnt)};
 }
-
-#endif
\ No newline at end of file
@@ -18,8 +18,6 @@
 
 #pragma once
 
-#ifdef PCSX2_LEFTOVER_FROM_WX
-
 // PINE uses a concept of "slot" to be able to communicate with multiple
 // emulators at the same time, each slot should be unique to each emulator to
 // allow PnP and configurable by the end user so that several runs don't
@@ -27,23 +25,17 @@
 #define PINE_DEFAULT_SLOT 28011
 #define PINE_EMULATOR_NAME "pcsx2"
 
-#include "gui/PersistentThread.h"
-#include "gui/SysThreads.h"
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 #ifdef _WIN32
 #include <WinSock2.h>
 #include <windows.h>
 #endif
 
-using namespace Threading;
-
-class SysCoreThread;
-
-class PINEServer : public pxThread
+class PINEServer
 {
-	// parent thread
-	typedef pxThread _parent;
-
 protected:
 #ifdef _WIN32
 	// windows claim to have support for AF_UNIX sockets but that is a blatant lie,
@@ -54,9 +46,9 @@ protected:
 #else
 	// absolute path of the socket. Stored in XDG_RUNTIME_DIR, if unset /tmp
 	std::string m_socket_name;
-	int m_sock = 0;
+	int m_sock = -1;
 	// the message socket used in thread's accept().
-	int m_msgsock = 0;
+	int m_msgsock = -1;
 #endif
 
 
@@ -77,13 +69,13 @@ protected:
 	 * A preallocated buffer used to store all IPC replies.
 	 * to the size of 50.000 MsgWrite64 IPC calls.
 	 */
-	char* m_ret_buffer;
+	char* m_ret_buffer = nullptr;
 
 	/**
 	 * IPC messages buffer.
 	 * A preallocated buffer used to store all IPC messages.
 	 */
-	char* m_ipc_buffer;
+	char* m_ipc_buffer = nullptr;
 
 	/**
 	 * IPC Command messages opcodes.
@@ -109,6 +101,11 @@ protected:
 		MsgUUID = 0xD, /**< Returns the game UUID. */
 		MsgGameVersion = 0xE, /**< Returns the game verion. */
 		MsgStatus = 0xF, /**< Returns the emulator status. */
+		MsgReadN = 0x10, /**< Read a range of bytes from memory. */
+		MsgWriteN = 0x11, /**< Write a range of bytes to memory. */
+		MsgWatchSet = 0x12, /**< Replaces the list of watched addresses. */
+		MsgWatchPoll = 0x13, /**< Returns the watched values which changed since the last poll. */
+		MsgSharedMemory = 0x14, /**< Returns the shared memory object backing EE RAM. */
 		MsgUnimplemented = 0xFF /**< Unimplemented IPC message. */
 	};
 
@@ -145,8 +142,35 @@ protected:
 		IPC_FAIL = 0xFF /**< IPC command failed to complete. */
 	};
 
-	// handle to the main vm thread
-	SysCoreThread* m_vm;
+	/**
+	 * Watched memory location.
+	 * Polled by MsgWatchPoll, which only replies with entries whose value
+	 * changed since they were last sent to the client.
+	 */
+	struct WatchEntry
+	{
+		u32 address; /**< Address of the value. */
+		u8 width; /**< Width of the value in bytes, 1, 2, 4 or 8. */
+		u64 last_value; /**< Value last sent to the client. */
+	};
+
+	/**
+	 * Maximum number of watched locations.
+	 * A poll reply where everything changed has to fit in MAX_IPC_RETURN_SIZE.
+	 */
+#define MAX_IPC_WATCHES 32768
+
+	// locations watched by the client, only touched by the server thread
+	std::vector<WatchEntry> m_watch_list;
+
+	// thread used to relay IPC commands.
+	std::thread m_thread;
+
+	// slot the server is listening on, 0 when it isn't running.
+	int m_slot = 0;
+
+	// Whether the socket processing thread should stop executing/is stopped.
+	std::atomic_bool m_end{true};
 
 	// Thread used to relay IPC commands.
 	void ExecuteTaskInThread();
@@ -204,6 +228,14 @@ protected:
 		return *(T*)(arr + i);
 	}
 
+	/**
+	 * Reads a watched value of the given width.
+	 * address: address of the value
+	 * width: size of the value in bytes
+	 * return value: the value, zero extended
+	 */
+	static u64 ReadWatch(u32 address, u8 width);
+
 	/**
 	 * Ensures an IPC message isn't too big.
 	 * return value: false if checks failed, true otherwise.
@@ -218,13 +250,23 @@ protected:
 	}
 
 public:
-	// Whether the socket processing thread should stop executing/is stopped.
-	bool m_end = true;
-
 	/* Initializers */
-	PINEServer(SysCoreThread* vm, unsigned int slot = PINE_DEFAULT_SLOT);
-	virtual ~PINEServer();
+	PINEServer();
+	~PINEServer();
 
-}; // class SocketIPC
+	/**
+	 * Opens the socket and starts the server thread.
+	 * slot: slot to listen on.
+	 * return value: false if the socket couldn't be opened.
+	 */
+	bool Initialize(int slot = PINE_DEFAULT_SLOT);
 
-#endif
+	/**
+	 * Closes the socket and waits for the server thread to exit.
+	 */
+	void Deinitialize();
+
+	bool IsInitialized() const { return m_slot != 0; }
+	int GetSlot() const { return m_slot; }
+
+}; // class SocketIPC
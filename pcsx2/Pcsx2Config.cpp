@@ -181,6 +181,7 @@ void Pcsx2Config::SpeedhackOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(vuFlagHack);
 	SettingsWrapBitBool(vuThread);
 	SettingsWrapBitBool(vu1Instant);
+	SettingsWrapBitBool(ipuThread);
 }
 
 void Pcsx2Config::ProfilerOptions::LoadSave(SettingsWrapper& wrap)
@@ -192,6 +193,10 @@ void Pcsx2Config::ProfilerOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(RecBlocks_IOP);
 	SettingsWrapBitBool(RecBlocks_VU0);
 	SettingsWrapBitBool(RecBlocks_VU1);
+	SettingsWrapBitBool(PerfJitDump);
+	SettingsWrapBitBool(TimelineTracer);
+	SettingsWrapEntry(TraceFrames);
+	SettingsWrapEntry(TraceSpikeThreshold);
 }
 
 Pcsx2Config::RecompilerOptions::RecompilerOptions()
@@ -211,6 +216,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 	EnableFastmem = true;
 	EnableFullTLB = false;
 	PauseOnTLBMiss = false;
+	EnableWarmStart = false;
+	EnableEESuperblocks = false;
 
 	// vu and fpu clamping default to standard overflow.
 	vu0Overflow = true;
@@ -290,6 +297,8 @@ void Pcsx2Config::RecompilerOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(EnableFastmem);
 	SettingsWrapBitBool(EnableFullTLB);
 	SettingsWrapBitBool(PauseOnTLBMiss);
+	SettingsWrapBitBool(EnableWarmStart);
+	SettingsWrapBitBool(EnableEESuperblocks);
 
 	SettingsWrapBitBool(vu0Overflow);
 	SettingsWrapBitBool(vu0ExtraOverflow);
@@ -457,6 +466,8 @@ bool Pcsx2Config::GSOptions::operator==(const GSOptions& right) const
 	return (
 		OpEqu(SynchronousMTGS) &&
 		OpEqu(VsyncQueueSize) &&
+		OpEqu(MTGSRingBufferSize) &&
+		OpEqu(MTGSGrowRingBuffer) &&
 
 		OpEqu(FrameLimitEnable) &&
 
@@ -576,6 +587,8 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapEntry(SynchronousMTGS);
 #endif
 	SettingsWrapEntry(VsyncQueueSize);
+	SettingsWrapEntry(MTGSRingBufferSize);
+	SettingsWrapEntry(MTGSGrowRingBuffer);
 
 	SettingsWrapEntry(FrameLimitEnable);
 	wrap.EnumEntry(CURRENT_SETTINGS_SECTION, "VsyncEnable", VsyncEnable, NULL, VsyncEnable);
@@ -1311,6 +1324,7 @@ void Pcsx2Config::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(InhibitScreensaver);
 	SettingsWrapBitBool(ConsoleToStdio);
 	SettingsWrapBitBool(HostFs);
+	SettingsWrapBitBool(HugePages);
 
 	SettingsWrapBitBool(BackupSavestate);
 	SettingsWrapBitBool(SavestateZstdCompression);
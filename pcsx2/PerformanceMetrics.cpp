@@ -69,6 +69,12 @@ static float s_vu_thread_time = 0.0f;
 static float s_capture_thread_usage = 0.0f;
 static float s_capture_thread_time = 0.0f;
 
+static constexpr u32 NUM_STALL_REASONS = static_cast<u32>(PerformanceMetrics::StallReason::Count);
+static std::array<u32, NUM_STALL_REASONS> s_last_stall_counts = {};
+static std::array<u64, NUM_STALL_REASONS> s_last_stall_times = {};
+static std::array<float, NUM_STALL_REASONS> s_stalls_per_frame = {};
+static std::array<float, NUM_STALL_REASONS> s_stall_time_per_frame = {};
+
 static PerformanceMetrics::FrameTimeHistory s_frame_time_history;
 static u32 s_frame_time_history_pos = 0;
 
@@ -86,6 +92,22 @@ static float s_accumulated_gpu_time = 0.0f;
 static float s_gpu_usage = 0.0f;
 static u32 s_presents_since_last_update = 0;
 
+static const Threading::AdaptiveWaiter& GetStallWaiter(PerformanceMetrics::StallReason reason)
+{
+	switch (reason)
+	{
+		case PerformanceMetrics::StallReason::GSRingFull:
+			return GetMTGS().m_ring_waiter;
+		case PerformanceMetrics::StallReason::GSSync:
+			return GetMTGS().m_sync_waiter;
+		case PerformanceMetrics::StallReason::VUXGKick:
+			return GetMTGS().m_xgkick_waiter;
+		case PerformanceMetrics::StallReason::VUSync:
+		default:
+			return vu1Thread.waiterSync;
+	}
+}
+
 void PerformanceMetrics::Clear()
 {
 	Reset();
@@ -109,6 +131,9 @@ void PerformanceMetrics::Clear()
 	s_average_gpu_time = 0.0f;
 	s_gpu_usage = 0.0f;
 
+	s_stalls_per_frame.fill(0.0f);
+	s_stall_time_per_frame.fill(0.0f);
+
 	s_frame_number = 0;
 
 	s_frame_time_history.fill(0.0f);
@@ -139,6 +164,13 @@ void PerformanceMetrics::Reset()
 
 	for (GSSWThreadStats& stat : s_gs_sw_threads)
 		stat.last_cpu_time = stat.handle.GetCPUTime();
+
+	for (u32 i = 0; i < NUM_STALL_REASONS; i++)
+	{
+		const Threading::AdaptiveWaiter& waiter = GetStallWaiter(static_cast<StallReason>(i));
+		s_last_stall_counts[i] = waiter.GetWaitCount();
+		s_last_stall_times[i] = waiter.GetWaitTimeNS();
+	}
 }
 
 void PerformanceMetrics::Update(bool gs_register_write, bool fb_blit, bool is_skipping_present)
@@ -236,6 +268,18 @@ void PerformanceMetrics::Update(bool gs_register_write, bool fb_blit, bool is_sk
 		thread.time = static_cast<double>(delta) * time_divider;
 	}
 
+	for (u32 i = 0; i < NUM_STALL_REASONS; i++)
+	{
+		const Threading::AdaptiveWaiter& waiter = GetStallWaiter(static_cast<StallReason>(i));
+		const u32 count = waiter.GetWaitCount();
+		const u64 wait_time = waiter.GetWaitTimeNS();
+		s_stalls_per_frame[i] = static_cast<float>(count - s_last_stall_counts[i]) / static_cast<float>(s_frames_since_last_update);
+		s_stall_time_per_frame[i] = static_cast<float>(static_cast<double>(wait_time - s_last_stall_times[i]) /
+													   (1000000.0 * static_cast<double>(s_frames_since_last_update)));
+		s_last_stall_counts[i] = count;
+		s_last_stall_times[i] = wait_time;
+	}
+
 	s_frames_since_last_update = 0;
 	s_unskipped_frames_since_last_update = 0;
 	s_presents_since_last_update = 0;
@@ -372,6 +416,22 @@ double PerformanceMetrics::GetGSSWThreadAverageTime(u32 index)
 	return s_gs_sw_threads[index].time;
 }
 
+float PerformanceMetrics::GetStallsPerFrame(StallReason reason)
+{
+	return s_stalls_per_frame[static_cast<u32>(reason)];
+}
+
+float PerformanceMetrics::GetStallTimePerFrame(StallReason reason)
+{
+	return s_stall_time_per_frame[static_cast<u32>(reason)];
+}
+
+const char* PerformanceMetrics::GetStallReasonName(StallReason reason)
+{
+	static constexpr const char* names[NUM_STALL_REASONS] = {"RING", "SYNC", "XGKICK", "VU"};
+	return names[static_cast<u32>(reason)];
+}
+
 float PerformanceMetrics::GetGPUUsage()
 {
 	return s_gpu_usage;
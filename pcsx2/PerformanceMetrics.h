@@ -27,6 +27,16 @@ namespace PerformanceMetrics
 		DISPFBBlit
 	};
 
+	/// Places where the EE, GS and VU threads wait on each other.
+	enum class StallReason : u32
+	{
+		GSRingFull, ///< EE waiting for room in the MTGS ringbuffer.
+		GSSync, ///< EE waiting for the MTGS to catch up.
+		VUXGKick, ///< MTGS waiting for MTVU to finish a path1 packet.
+		VUSync, ///< EE waiting for MTVU to catch up.
+		Count
+	};
+
 	static constexpr u32 NUM_FRAME_TIME_SAMPLES = 150;
 	using FrameTimeHistory = std::array<float, NUM_FRAME_TIME_SAMPLES>;
 
@@ -70,6 +80,11 @@ namespace PerformanceMetrics
 	double GetGSSWThreadUsage(u32 index);
 	double GetGSSWThreadAverageTime(u32 index);
 
+	/// Returns how often the threads waited on each other for this reason, and how long for, per frame.
+	float GetStallsPerFrame(StallReason reason);
+	float GetStallTimePerFrame(StallReason reason);
+	const char* GetStallReasonName(StallReason reason);
+
 	float GetGPUUsage();
 	float GetGPUAverageTime();
 
@@ -24,7 +24,9 @@
 #include "ps2/pgif.h" // pgif init
 #include "VUmicro.h"
 #include "COP0.h"
+#include "Cache.h"
 #include "MTVU.h"
+#include "SubsystemProfiler.h"
 #include "VMManager.h"
 
 #include "Hardware.h"
@@ -83,6 +85,7 @@ void cpuReset()
 	memzero(cpuRegs);
 	memzero(fpuRegs);
 	memzero(tlb);
+	updateCachePageModes();
 
 	cpuRegs.pc				= 0xbfc00000; //set pc reg to stack
 	cpuRegs.CP0.n.Config	= 0x440;
@@ -454,6 +457,7 @@ __fi void _cpuEventTest_Shared()
 		//if( EEsCycle < -450 )
 		//	Console.WriteLn( " IOP ahead by: %d cycles", -EEsCycle );
 
+		SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::IOP);
 		EEsCycle = psxCpu->ExecuteBlock(EEsCycle);
 
 		iopEventAction = false;
@@ -20,13 +20,16 @@
 #include "Utilities/InputRecordingLogger.h"
 
 #include "common/FileSystem.h"
+#include "common/Threading.h"
 #include "DebugTools/Debug.h"
 #include "MemoryTypes.h"
 
 #include <fmt/format.h>
 
 #include <vector>
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 void InputRecordingFile::InputRecordingFileHeader::init() noexcept
 {
@@ -70,10 +73,15 @@ bool InputRecordingFile::close() noexcept
 	{
 		return false;
 	}
+	stopFlushThread();
+	const bool flushed = flush();
 	fclose(m_recordingFile);
 	m_recordingFile = nullptr;
 	m_filename.clear();
-	return true;
+	m_frameData = {};
+	m_dirtyStart = m_dirtyEnd = 0;
+	m_headerDirty = false;
+	return flushed;
 }
 
 const std::string& InputRecordingFile::getFilename() const noexcept
@@ -98,13 +106,9 @@ bool InputRecordingFile::fromSaveState() const noexcept
 
 void InputRecordingFile::incrementUndoCount()
 {
+	std::unique_lock lock(m_dataMutex);
 	m_undoCount++;
-	if (m_recordingFile == nullptr)
-	{
-		return;
-	}
-	fseek(m_recordingFile, s_seekpointUndoCount, SEEK_SET);
-	fwrite(&m_undoCount, 4, 1, m_recordingFile);
+	m_headerDirty = true;
 }
 
 bool InputRecordingFile::openNew(const std::string& path, bool fromSavestate)
@@ -120,6 +124,10 @@ bool InputRecordingFile::openNew(const std::string& path, bool fromSavestate)
 	m_undoCount = 0;
 	m_header.init();
 	m_savestate = fromSavestate;
+	m_frameData.clear();
+	m_dirtyStart = m_dirtyEnd = 0;
+	m_headerDirty = true;
+	startFlushThread();
 	return true;
 }
 
@@ -138,7 +146,15 @@ bool InputRecordingFile::openExisting(const std::string& path)
 		return false;
 	}
 
+	if (!readFrameData())
+	{
+		close();
+		InputRec::consoleLog("Input recording file could not be read");
+		return false;
+	}
+
 	m_filename = path;
+	startFlushThread();
 	return true;
 }
 
@@ -149,16 +165,20 @@ std::optional<PadData> InputRecordingFile::readPadData(const uint frame, const u
 		return std::nullopt;
 	}
 
-	std::array<u8, s_controllerInputBytes> data{};
+	std::array<u8, s_controllerInputBytes> data;
 
 	// TODO - slot unused, use it in the new format
-	const size_t seek = getRecordingBlockSeekPoint(frame) + s_controllerInputBytes * port;
-	if (fseek(m_recordingFile, seek, SEEK_SET) != 0 || fread(&data, 1, 18, m_recordingFile) != 1)
+	const size_t offset = getFrameDataOffset(frame) + s_controllerInputBytes * port;
 	{
-		return PadData(port, slot, data);
+		std::unique_lock lock(m_dataMutex);
+		if (offset + s_controllerInputBytes > m_frameData.size())
+		{
+			return std::nullopt;
+		}
+		std::memcpy(data.data(), &m_frameData[offset], s_controllerInputBytes);
 	}
 
-	return std::nullopt;
+	return PadData(port, slot, data);
 }
 
 void InputRecordingFile::setTotalFrames(u32 frame)
@@ -167,63 +187,63 @@ void InputRecordingFile::setTotalFrames(u32 frame)
 	{
 		return;
 	}
+	std::unique_lock lock(m_dataMutex);
 	m_totalFrames = frame;
-	fseek(m_recordingFile, s_seekpointTotalFrames, SEEK_SET);
-	fwrite(&m_totalFrames, 4, 1, m_recordingFile);
+	m_headerDirty = true;
 }
 
-bool InputRecordingFile::writeHeader() const
+bool InputRecordingFile::writeHeader()
 {
 	if (m_recordingFile == nullptr)
 	{
 		return false;
 	}
-	rewind(m_recordingFile);
-	if (fwrite(&m_header, sizeof(InputRecordingFileHeader), 1, m_recordingFile) != 1 ||
-		fwrite(&m_totalFrames, 4, 1, m_recordingFile) != 1 ||
-		fwrite(&m_undoCount, 4, 1, m_recordingFile) != 1 ||
-		fwrite(&m_savestate, 1, 1, m_recordingFile) != 1)
 	{
-		return false;
+		std::unique_lock lock(m_dataMutex);
+		m_headerDirty = true;
 	}
-	return true;
+	return flush();
 }
 
-bool InputRecordingFile::writePadData(const uint frame, const PadData data) const
+bool InputRecordingFile::writePadData(const uint frame, const PadData data)
 {
 	if (m_recordingFile == nullptr)
 	{
 		return false;
 	}
 
+	const std::array<u8, s_controllerInputBytes> bytes = {
+		data.m_compactPressFlagsGroupOne,
+		data.m_compactPressFlagsGroupTwo,
+		std::get<0>(data.m_rightAnalog),
+		std::get<1>(data.m_rightAnalog),
+		std::get<0>(data.m_leftAnalog),
+		std::get<1>(data.m_leftAnalog),
+		std::get<1>(data.m_right),
+		std::get<1>(data.m_left),
+		std::get<1>(data.m_up),
+		std::get<1>(data.m_down),
+		std::get<1>(data.m_triangle),
+		std::get<1>(data.m_circle),
+		std::get<1>(data.m_cross),
+		std::get<1>(data.m_square),
+		std::get<1>(data.m_l1),
+		std::get<1>(data.m_r1),
+		std::get<1>(data.m_l2),
+		std::get<1>(data.m_r2),
+	};
+
 	// TODO - use the slot in the future
-	const size_t seek = getRecordingBlockSeekPoint(frame) + s_controllerInputBytes * data.m_port;
-
-	// seek to the correct position and write data to the file
-	if (fseek(m_recordingFile, seek, SEEK_SET) != 0 ||
-		fwrite(&data.m_compactPressFlagsGroupOne, 1, 1, m_recordingFile) != 1 ||
-		fwrite(&data.m_compactPressFlagsGroupTwo, 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<0>(data.m_rightAnalog), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_rightAnalog), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<0>(data.m_leftAnalog), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_leftAnalog), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_right), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_left), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_up), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_down), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_triangle), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_circle), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_cross), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_square), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_l1), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_r1), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_l2), 1, 1, m_recordingFile) != 1 ||
-		fwrite(&std::get<1>(data.m_r2), 1, 1, m_recordingFile) != 1)
+	const size_t offset = getFrameDataOffset(frame) + s_controllerInputBytes * data.m_port;
+
+	std::unique_lock lock(m_dataMutex);
+	if (offset + s_controllerInputBytes > m_frameData.size())
 	{
-		return false;
+		// Skipped frames are left zeroed, as they would be when seeking past the end of the file
+		m_frameData.resize(offset + s_controllerInputBytes);
 	}
-
-	fflush(m_recordingFile);
+	std::memcpy(&m_frameData[offset], bytes.data(), s_controllerInputBytes);
+	markFrameDataDirty(offset, offset + s_controllerInputBytes);
 	return true;
 }
 
@@ -259,9 +279,9 @@ std::vector<PadData> InputRecordingFile::bulkReadPadData(u32 frameStart, u32 fra
 	return data;
 }
 
-size_t InputRecordingFile::getRecordingBlockSeekPoint(const u32 frame) const noexcept
+size_t InputRecordingFile::getFrameDataOffset(const u32 frame) const noexcept
 {
-	return s_headerSize + sizeof(bool) + frame * s_inputBytesPerFrame;
+	return static_cast<size_t>(frame) * s_inputBytesPerFrame;
 }
 
 bool InputRecordingFile::verifyRecordingFileHeader()
@@ -288,3 +308,124 @@ bool InputRecordingFile::verifyRecordingFileHeader()
 	}
 	return true;
 }
+
+bool InputRecordingFile::readFrameData()
+{
+	const s64 size = FileSystem::FSize64(m_recordingFile);
+	if (size < static_cast<s64>(s_seekpointFrameData))
+	{
+		return false;
+	}
+
+	m_frameData.resize(static_cast<size_t>(size) - s_seekpointFrameData);
+	m_dirtyStart = m_dirtyEnd = 0;
+	m_headerDirty = false;
+	return FileSystem::FSeek64(m_recordingFile, s_seekpointFrameData, SEEK_SET) == 0 &&
+		   (m_frameData.empty() || fread(m_frameData.data(), m_frameData.size(), 1, m_recordingFile) == 1);
+}
+
+void InputRecordingFile::markFrameDataDirty(size_t start, size_t end)
+{
+	if (m_dirtyStart == m_dirtyEnd)
+	{
+		m_dirtyStart = start;
+		m_dirtyEnd = end;
+	}
+	else
+	{
+		m_dirtyStart = std::min(m_dirtyStart, start);
+		m_dirtyEnd = std::max(m_dirtyEnd, end);
+	}
+}
+
+bool InputRecordingFile::flush()
+{
+	std::unique_lock file_lock(m_fileMutex);
+	if (m_recordingFile == nullptr)
+	{
+		return false;
+	}
+
+	// Copy what needs writing so the CPU thread isn't held up by the disk
+	std::array<u8, s_seekpointFrameData> header;
+	std::vector<u8> frameData;
+	bool headerDirty;
+	size_t frameDataStart;
+	{
+		std::unique_lock lock(m_dataMutex);
+		headerDirty = m_headerDirty;
+		if (headerDirty)
+		{
+			// Only the low 4 bytes of the counters are stored
+			const u32 totalFrames = static_cast<u32>(m_totalFrames);
+			const u32 undoCount = static_cast<u32>(m_undoCount);
+			std::memcpy(&header[0], &m_header, sizeof(InputRecordingFileHeader));
+			std::memcpy(&header[s_seekpointTotalFrames], &totalFrames, sizeof(totalFrames));
+			std::memcpy(&header[s_seekpointUndoCount], &undoCount, sizeof(undoCount));
+			std::memcpy(&header[s_seekpointSaveStateHeader], &m_savestate, sizeof(m_savestate));
+		}
+		frameDataStart = m_dirtyStart;
+		frameData.assign(m_frameData.begin() + m_dirtyStart, m_frameData.begin() + m_dirtyEnd);
+		m_headerDirty = false;
+		m_dirtyStart = m_dirtyEnd = 0;
+	}
+
+	if (!headerDirty && frameData.empty())
+	{
+		return true;
+	}
+
+	if ((headerDirty && (FileSystem::FSeek64(m_recordingFile, 0, SEEK_SET) != 0 ||
+							fwrite(header.data(), header.size(), 1, m_recordingFile) != 1)) ||
+		(!frameData.empty() && (FileSystem::FSeek64(m_recordingFile, s_seekpointFrameData + frameDataStart, SEEK_SET) != 0 ||
+								   fwrite(frameData.data(), frameData.size(), 1, m_recordingFile) != 1)) ||
+		fflush(m_recordingFile) != 0)
+	{
+		InputRec::consoleLog(fmt::format("Failed to write input recording file. Error - {}", strerror(errno)));
+
+		// Try again next time
+		std::unique_lock lock(m_dataMutex);
+		m_headerDirty |= headerDirty;
+		if (!frameData.empty())
+		{
+			markFrameDataDirty(frameDataStart, frameDataStart + frameData.size());
+		}
+		return false;
+	}
+
+	return true;
+}
+
+void InputRecordingFile::startFlushThread()
+{
+	m_flushThreadShutdown = false;
+	m_flushThread = std::thread(&InputRecordingFile::flushThreadEntryPoint, this);
+}
+
+void InputRecordingFile::stopFlushThread()
+{
+	if (!m_flushThread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::unique_lock lock(m_dataMutex);
+		m_flushThreadShutdown = true;
+	}
+	m_flushCV.notify_one();
+	m_flushThread.join();
+}
+
+void InputRecordingFile::flushThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("Input Recording Flush");
+
+	std::unique_lock lock(m_dataMutex);
+	while (!m_flushCV.wait_for(lock, s_flushInterval, [this]() { return m_flushThreadShutdown; }))
+	{
+		lock.unlock();
+		flush();
+		lock.lock();
+	}
+}
@@ -18,10 +18,19 @@
 #include "System.h"
 #include "PadData.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 // NOTE / TODOs for Version 2
 // - Move fromSavestate, undoCount, and total frames into the header
 
 // Handles all operations on the input recording file
+// The frame data is kept in memory while the file is open, so replaying and recording don't
+// touch the disk every frame. Changes are written back by a background thread once a second,
+// and in full when the file is closed.
 class InputRecordingFile
 {
 	struct InputRecordingFileHeader
@@ -68,9 +77,9 @@ public:
 	// Updates the total frame counter and commit it to the recording file
 	void setTotalFrames(u32 frames);
 	// Persist the input recording file header's current state to the file
-	bool writeHeader() const;
+	bool writeHeader();
 	// Writes the current frame's input data to the file so it can be replayed
-	bool writePadData(const uint frame, const PadData data) const;
+	bool writePadData(const uint frame, const PadData data);
 
 
 	// Retrieve the input recording's filename (not the path)
@@ -93,6 +102,8 @@ private:
 	static constexpr size_t s_seekpointTotalFrames = sizeof(InputRecordingFileHeader);
 	static constexpr size_t s_seekpointUndoCount = sizeof(InputRecordingFileHeader) + 4;
 	static constexpr size_t s_seekpointSaveStateHeader = s_seekpointUndoCount + 4;
+	static constexpr size_t s_seekpointFrameData = s_seekpointSaveStateHeader + s_recordingSavestateHeaderSize;
+	static constexpr std::chrono::seconds s_flushInterval{1};
 
 	std::string m_filename = "";
 	FILE* m_recordingFile = nullptr;
@@ -102,7 +113,27 @@ private:
 	unsigned long m_totalFrames = 0;
 	unsigned long m_undoCount = 0;
 
-	// Calculates the position of the current frame in the input recording
-	size_t getRecordingBlockSeekPoint(const u32 frame) const noexcept;
+	// Everything after the header, as it should be on disk
+	std::vector<u8> m_frameData;
+	// Range of m_frameData which hasn't been written back yet
+	size_t m_dirtyStart = 0;
+	size_t m_dirtyEnd = 0;
+	bool m_headerDirty = false;
+	bool m_flushThreadShutdown = false;
+	// Guards the in-memory copy, m_dataMutex must not be taken before m_fileMutex
+	std::mutex m_dataMutex;
+	std::mutex m_fileMutex;
+	std::condition_variable m_flushCV;
+	std::thread m_flushThread;
+
+	// Calculates the position of the current frame in m_frameData
+	size_t getFrameDataOffset(const u32 frame) const noexcept;
 	bool verifyRecordingFileHeader();
+	bool readFrameData();
+	void markFrameDataDirty(size_t start, size_t end);
+	// Writes back any changes which have been made since the last flush
+	bool flush();
+	void startFlushThread();
+	void stopFlushThread();
+	void flushThreadEntryPoint();
 };
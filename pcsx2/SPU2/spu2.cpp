@@ -21,6 +21,7 @@
 #include "GS.h"
 #include "GS/GSCapture.h"
 #include "R3000A.h"
+#include "SubsystemProfiler.h"
 
 namespace SPU2
 {
@@ -272,6 +273,7 @@ bool SPU2::IsRunningPSXMode()
 
 void SPU2async(u32 cycles)
 {
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::SPU2);
 	TimeUpdate(psxRegs.cycle);
 }
 
@@ -0,0 +1,93 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "SubsystemProfiler.h"
+
+#include "common/Assertions.h"
+#include "common/Timer.h"
+
+#include <array>
+
+namespace SubsystemProfiler
+{
+	static constexpr u32 MAX_DEPTH = 8;
+	static constexpr u32 NUM_SUBSYSTEMS = static_cast<u32>(Subsystem::Count);
+
+	// Each thread charges whichever component is on top of its own stack.
+	struct ThreadState
+	{
+		std::array<Subsystem, MAX_DEPTH> stack;
+		u32 depth = 0;
+		Common::Timer::Value last = 0;
+	};
+
+	static void Charge(const ThreadState& ts, Common::Timer::Value now);
+
+	std::atomic_bool Internal::g_enabled{false};
+
+	static std::array<std::atomic<Common::Timer::Value>, NUM_SUBSYSTEMS> s_totals = {};
+	static thread_local ThreadState s_thread_state;
+} // namespace SubsystemProfiler
+
+void SubsystemProfiler::Charge(const ThreadState& ts, Common::Timer::Value now)
+{
+	s_totals[static_cast<u32>(ts.stack[ts.depth - 1])].fetch_add(now - ts.last, std::memory_order_relaxed);
+}
+
+u32 SubsystemProfiler::Internal::Enter(Subsystem sub)
+{
+	ThreadState& ts = s_thread_state;
+	const Common::Timer::Value now = Common::Timer::GetCurrentValue();
+	if (ts.depth > 0)
+		Charge(ts, now);
+
+	pxAssert(ts.depth < MAX_DEPTH);
+	ts.stack[ts.depth] = sub;
+	ts.last = now;
+	return ts.depth++;
+}
+
+void SubsystemProfiler::Internal::Leave(u32 depth)
+{
+	ThreadState& ts = s_thread_state;
+	const Common::Timer::Value now = Common::Timer::GetCurrentValue();
+	Charge(ts, now);
+	ts.depth = depth;
+	ts.last = now;
+}
+
+void SubsystemProfiler::SetEnabled(bool enabled)
+{
+	if (enabled)
+	{
+		for (std::atomic<Common::Timer::Value>& total : s_totals)
+			total.store(0, std::memory_order_relaxed);
+	}
+
+	Internal::g_enabled.store(enabled, std::memory_order_release);
+}
+
+double SubsystemProfiler::GetTime(Subsystem sub)
+{
+	return Common::Timer::ConvertValueToSeconds(s_totals[static_cast<u32>(sub)].load(std::memory_order_relaxed));
+}
+
+const char* SubsystemProfiler::GetName(Subsystem sub)
+{
+	static constexpr const char* names[NUM_SUBSYSTEMS] = {"EE", "IOP", "VU0", "VU1", "GS", "SPU2"};
+	return names[static_cast<u32>(sub)];
+}
@@ -0,0 +1,81 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <atomic>
+
+// Totals up the time spent in each emulated component, for benchmarking. Timers nest, and
+// only the innermost one is charged, so e.g. SPU2 time doesn't count towards the IOP which
+// called it. Everything on the CPU thread which isn't in another component counts as EE.
+namespace SubsystemProfiler
+{
+	enum class Subsystem : u32
+	{
+		EE,
+		IOP,
+		VU0,
+		VU1,
+		GS,
+		SPU2,
+		Count
+	};
+
+	namespace Internal
+	{
+		extern std::atomic_bool g_enabled;
+
+		u32 Enter(Subsystem sub);
+		void Leave(u32 depth);
+	} // namespace Internal
+
+	static __fi bool IsEnabled() { return Internal::g_enabled.load(std::memory_order_relaxed); }
+
+	/// Starts or stops collecting. Enabling clears the totals.
+	void SetEnabled(bool enabled);
+
+	/// Returns the time spent in the component since collection was enabled, in seconds.
+	double GetTime(Subsystem sub);
+
+	const char* GetName(Subsystem sub);
+
+	/// Charges the enclosing scope to a component.
+	class ScopedTimer
+	{
+	public:
+		__fi explicit ScopedTimer(Subsystem sub)
+			: m_depth(IsEnabled() ? Internal::Enter(sub) : INACTIVE)
+		{
+		}
+
+		// Restores the depth rather than popping, so timers skipped by a longjmp out of the
+		// recompilers don't leave the stack unbalanced.
+		__fi ~ScopedTimer()
+		{
+			if (m_depth != INACTIVE)
+				Internal::Leave(m_depth);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		static constexpr u32 INACTIVE = 0xFFFFFFFFu;
+
+		u32 m_depth;
+	};
+} // namespace SubsystemProfiler
@@ -125,6 +125,7 @@ void SysLogMachineCaps()
 
 	if (x86caps.hasAVX)  features += "AVX ";
 	if (x86caps.hasAVX2) features += "AVX2 ";
+	if (x86caps.hasAVX512) features += "AVX512 ";
 
 	StringUtil::StripWhitespace(&features);
 
@@ -254,6 +255,42 @@ void SysMainMemory::Release()
 	m_vu.Release();
 }
 
+void SysMainMemory::AdviseHugePages()
+{
+	if (m_huge_pages_advised)
+		return;
+
+	m_huge_pages_advised = true;
+
+	// EE RAM is left out, the recompiler write-protects it a 4KB page at a time and that splits any huge page up.
+	// The rest of main memory is shared memory, so it only gets huge pages if /dev/shm is mounted with huge=.
+	// The code caches are anonymous memory, which is where transparent huge pages actually apply by default.
+	u8* const main_base = m_mainMemory->GetBase() + HostMemoryMap::IOPmemOffset;
+	u8* const code_base = m_codeMemory->GetBase();
+	if (!HostSys::AdviseHugePages(main_base, m_mainMemory->GetEnd() - main_base) ||
+		!HostSys::AdviseHugePages(code_base, m_codeMemory->GetEnd() - code_base))
+	{
+		Console.Warning("Huge pages are not supported on this system.");
+		m_huge_pages_advised = false;
+	}
+}
+
+void SysMainMemory::LogHugePageUsage() const
+{
+	if (!m_huge_pages_advised)
+		return;
+
+	// Pages are only faulted in as they're used, so the code caches will grow into theirs.
+	const auto log_usage = [](const char* name, const u8* base, const u8* end) {
+		const size_t size = end - base;
+		Console.WriteLn("  %s: %zu of %zu MB in huge pages", name, HostSys::GetHugePageMappedSize(base, size) / _1mb, size / _1mb);
+	};
+
+	Console.WriteLn(Color_StrongBlue, "Huge page usage:");
+	log_usage("Main memory (excluding EE RAM)", m_mainMemory->GetBase() + HostMemoryMap::IOPmemOffset, m_mainMemory->GetEnd());
+	log_usage("Code memory", m_codeMemory->GetBase(), m_codeMemory->GetEnd());
+}
+
 
 // --------------------------------------------------------------------------------------
 //  SysCpuProviderPack  (implementations)
@@ -107,6 +107,8 @@ protected:
 	iopMemoryReserve m_iop;
 	vuMemoryReserve m_vu;
 
+	bool m_huge_pages_advised = false;
+
 public:
 	SysMainMemory();
 	~SysMainMemory();
@@ -123,6 +125,12 @@ public:
 	bool Allocate();
 	void Reset();
 	void Release();
+
+	/// Asks for main memory (other than EE RAM) and the code caches to be backed by huge pages. Can't be undone.
+	void AdviseHugePages();
+
+	/// Logs how much of the advised memory ended up in huge pages.
+	void LogHugePageUsage() const;
 };
 
 // --------------------------------------------------------------------------------------
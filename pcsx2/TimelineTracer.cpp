@@ -0,0 +1,299 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "TimelineTracer.h"
+#include "Config.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace TimelineTracer
+{
+	struct Event
+	{
+		const char* name;
+		Common::Timer::Value start;
+		Common::Timer::Value end;
+		s64 arg;
+	};
+
+	// Written only by its owning thread, read (under s_threads_mutex) when saving.
+	struct ThreadBuffer
+	{
+		static constexpr u32 CAPACITY = 65536; // must be a power of two
+
+		std::unique_ptr<Event[]> events;
+		std::atomic<u64> write_pos{0};
+		std::string name;
+		u32 tid = 0;
+		bool in_use = false;
+	};
+
+	// Releases the thread's buffer when it exits, so worker threads which come and go
+	// (e.g. GS-SW on a renderer switch) don't leak a ring each time.
+	struct ThreadBufferOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+		~ThreadBufferOwner();
+	};
+
+	struct ThreadSnapshot
+	{
+		std::string name;
+		u32 tid;
+		std::vector<Event> events;
+	};
+
+	static constexpr u32 MAX_TRACE_FRAMES = 600;
+
+	static ThreadBuffer* GetThreadBuffer(const char* name);
+	static void WriteTrace(std::string filename, std::vector<ThreadSnapshot> threads, Common::Timer::Value base);
+
+	std::atomic_bool Internal::g_enabled{false};
+
+	static std::mutex s_threads_mutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+	static u32 s_next_tid = 1;
+	static thread_local ThreadBufferOwner s_thread_buffer;
+
+	// CPU thread only.
+	static std::array<Common::Timer::Value, MAX_TRACE_FRAMES> s_frame_starts;
+	static u64 s_frame_count = 0;
+	static Common::Timer::Value s_last_vsync = 0;
+	static u64 s_last_auto_save_frame = 0;
+	static std::thread s_save_thread;
+} // namespace TimelineTracer
+
+TimelineTracer::ThreadBufferOwner::~ThreadBufferOwner()
+{
+	if (!buffer)
+		return;
+
+	std::unique_lock lock(s_threads_mutex);
+	buffer->in_use = false;
+}
+
+TimelineTracer::ThreadBuffer* TimelineTracer::GetThreadBuffer(const char* name)
+{
+	if (s_thread_buffer.buffer)
+		return s_thread_buffer.buffer;
+
+	std::unique_lock lock(s_threads_mutex);
+
+	auto it = std::find_if(s_threads.begin(), s_threads.end(), [](const auto& buf) { return !buf->in_use; });
+	ThreadBuffer* buf;
+	if (it != s_threads.end())
+	{
+		// Drop whatever the previous owner recorded, its tid is gone.
+		buf = it->get();
+		buf->write_pos.store(0, std::memory_order_relaxed);
+	}
+	else
+	{
+		buf = s_threads.emplace_back(std::make_unique<ThreadBuffer>()).get();
+	}
+
+	buf->tid = s_next_tid++;
+	buf->name = name ? name : fmt::format("Thread {}", buf->tid);
+	buf->in_use = true;
+	s_thread_buffer.buffer = buf;
+	return buf;
+}
+
+void TimelineTracer::Internal::AddZone(const char* name, Common::Timer::Value start, Common::Timer::Value end, s64 arg)
+{
+	ThreadBuffer* buf = GetThreadBuffer(nullptr);
+	if (!buf->events)
+	{
+		std::unique_lock lock(s_threads_mutex);
+		buf->events = std::make_unique<Event[]>(ThreadBuffer::CAPACITY);
+	}
+
+	const u64 pos = buf->write_pos.load(std::memory_order_relaxed);
+	buf->events[pos & (ThreadBuffer::CAPACITY - 1)] = {name, start, end, arg};
+	buf->write_pos.store(pos + 1, std::memory_order_release);
+}
+
+void TimelineTracer::UpdateSettings()
+{
+	const bool enabled = EmuConfig.Profiler.TimelineTracer;
+	if (Internal::g_enabled.load(std::memory_order_relaxed) == enabled)
+		return;
+
+	Console.WriteLn(enabled ? "Timeline tracer enabled." : "Timeline tracer disabled.");
+	ResetFrameTiming();
+	Internal::g_enabled.store(enabled, std::memory_order_release);
+}
+
+void TimelineTracer::Shutdown()
+{
+	if (s_save_thread.joinable())
+		s_save_thread.join();
+}
+
+void TimelineTracer::SetCurrentThreadName(const char* name)
+{
+	if (ThreadBuffer* buf = s_thread_buffer.buffer)
+	{
+		std::unique_lock lock(s_threads_mutex);
+		buf->name = name;
+		return;
+	}
+
+	GetThreadBuffer(name);
+}
+
+void TimelineTracer::OnVSync()
+{
+	if (!IsEnabled())
+		return;
+
+	const Common::Timer::Value now = Common::Timer::GetCurrentValue();
+	const Common::Timer::Value last = std::exchange(s_last_vsync, now);
+	s_frame_starts[s_frame_count % MAX_TRACE_FRAMES] = now;
+	s_frame_count++;
+	if (last == 0)
+		return;
+
+	Internal::AddZone("Frame", last, now, static_cast<s64>(s_frame_count - 1));
+
+	// Let the window fill up again before saving another one.
+	const float threshold = EmuConfig.Profiler.TraceSpikeThreshold;
+	const u64 frames = std::clamp<u64>(EmuConfig.Profiler.TraceFrames, 1, MAX_TRACE_FRAMES);
+	if (threshold > 0.0f && (s_frame_count - s_last_auto_save_frame) > frames &&
+		Common::Timer::ConvertValueToMilliseconds(now - last) > threshold)
+	{
+		s_last_auto_save_frame = s_frame_count;
+		const std::string filename = SaveTrace();
+		Console.Warning("Frame took %.2f ms, saved timeline trace to '%s'.",
+			Common::Timer::ConvertValueToMilliseconds(now - last), filename.c_str());
+	}
+}
+
+void TimelineTracer::ResetFrameTiming()
+{
+	s_last_vsync = 0;
+}
+
+std::string TimelineTracer::SaveTrace()
+{
+	// Include the frame in progress, so a hotkey press shows what just happened.
+	const u64 frames = std::min<u64>(std::clamp<u64>(EmuConfig.Profiler.TraceFrames, 1, MAX_TRACE_FRAMES), s_frame_count);
+	const Common::Timer::Value window_start =
+		(frames > 0) ? s_frame_starts[(s_frame_count - frames) % MAX_TRACE_FRAMES] : 0;
+
+	std::vector<ThreadSnapshot> threads;
+	{
+		std::unique_lock lock(s_threads_mutex);
+		threads.reserve(s_threads.size());
+
+		for (const std::unique_ptr<ThreadBuffer>& buf : s_threads)
+		{
+			ThreadSnapshot& ts = threads.emplace_back();
+			ts.name = buf->name;
+			ts.tid = buf->tid;
+			if (!buf->events)
+				continue;
+
+			const u64 end = buf->write_pos.load(std::memory_order_acquire);
+			const u64 begin = (end > ThreadBuffer::CAPACITY) ? (end - ThreadBuffer::CAPACITY) : 0;
+			ts.events.reserve(end - begin);
+			for (u64 pos = begin; pos < end; pos++)
+				ts.events.push_back(buf->events[pos & (ThreadBuffer::CAPACITY - 1)]);
+
+			// The owner kept running while we copied, anything it could have overwritten
+			// (including the slot it may be writing right now) is dropped.
+			const u64 new_end = buf->write_pos.load(std::memory_order_acquire);
+			if ((new_end + 1) > (begin + ThreadBuffer::CAPACITY))
+			{
+				const u64 overwritten = std::min<u64>((new_end + 1) - (begin + ThreadBuffer::CAPACITY), ts.events.size());
+				ts.events.erase(ts.events.begin(), ts.events.begin() + overwritten);
+			}
+
+			ts.events.erase(std::remove_if(ts.events.begin(), ts.events.end(),
+								[window_start](const Event& ev) { return ev.end < window_start; }),
+				ts.events.end());
+		}
+	}
+
+	const time_t cur_time = time(nullptr);
+	char local_time[16];
+	if (!strftime(local_time, sizeof(local_time), "%Y%m%d%H%M%S", localtime(&cur_time)))
+		local_time[0] = 0;
+
+	std::string filename(Path::Combine(EmuFolders::Logs, fmt::format("pcsx2_trace_{}_{}.json", local_time, s_frame_count)));
+
+	if (s_save_thread.joinable())
+		s_save_thread.join();
+	s_save_thread = std::thread(&WriteTrace, filename, std::move(threads), window_start);
+
+	return filename;
+}
+
+void TimelineTracer::WriteTrace(std::string filename, std::vector<ThreadSnapshot> threads, Common::Timer::Value base)
+{
+	auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "wb");
+	if (!fp)
+	{
+		Console.Error("Failed to open timeline trace '%s' for writing.", filename.c_str());
+		return;
+	}
+
+	// Zones which started before the window keep their real start, so base on the earliest.
+	for (const ThreadSnapshot& ts : threads)
+	{
+		for (const Event& ev : ts.events)
+			base = std::min(base, ev.start);
+	}
+
+	const auto to_us = [base](Common::Timer::Value value) {
+		return Common::Timer::ConvertValueToNanoseconds(value - base) / 1000.0;
+	};
+
+	std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp.get());
+
+	bool first = true;
+	for (const ThreadSnapshot& ts : threads)
+	{
+		fmt::print(fp.get(), "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+			first ? "" : ",\n", ts.tid, ts.name);
+		first = false;
+
+		for (const Event& ev : ts.events)
+		{
+			fmt::print(fp.get(), ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+				ev.name, ts.tid, to_us(ev.start), to_us(ev.end) - to_us(ev.start));
+			if (ev.arg != NO_ARG)
+				fmt::print(fp.get(), ",\"args\":{{\"arg\":{}}}", ev.arg);
+			std::fputc('}', fp.get());
+		}
+	}
+
+	std::fputs("\n]}\n", fp.get());
+}
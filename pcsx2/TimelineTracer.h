@@ -0,0 +1,85 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+#include "common/Timer.h"
+
+#include <atomic>
+#include <string>
+
+// Records timed zones from every emulator thread into per-thread rings, so a single hitch
+// can be looked at after the fact. The last few frames can be saved as a Chrome/Perfetto
+// JSON trace, either from a hotkey or automatically when a frame takes too long.
+namespace TimelineTracer
+{
+	/// Zone argument which isn't written to the trace.
+	static constexpr s64 NO_ARG = -1;
+
+	namespace Internal
+	{
+		extern std::atomic_bool g_enabled;
+
+		void AddZone(const char* name, Common::Timer::Value start, Common::Timer::Value end, s64 arg);
+	} // namespace Internal
+
+	static __fi bool IsEnabled() { return Internal::g_enabled.load(std::memory_order_relaxed); }
+
+	/// Picks up EmuConfig.Profiler changes.
+	void UpdateSettings();
+
+	/// Waits for any trace which is being written out.
+	void Shutdown();
+
+	/// Names the calling thread in saved traces. Threads which don't call this get a number.
+	void SetCurrentThreadName(const char* name);
+
+	/// Called on the CPU thread at vsync. Records the frame, and saves a trace on a spike.
+	void OnVSync();
+
+	/// Forgets the last vsync, so time spent paused isn't seen as a spike.
+	void ResetFrameTiming();
+
+	/// Saves the last TraceFrames frames to the logs directory, from the CPU thread.
+	/// The file is written in the background, the name is returned straight away.
+	std::string SaveTrace();
+
+	/// Times the enclosing scope. The name must outlive the tracer, i.e. be a string literal.
+	class ScopedZone
+	{
+	public:
+		__fi explicit ScopedZone(const char* name, s64 arg = NO_ARG)
+			: m_name(name)
+			, m_arg(arg)
+			, m_start(IsEnabled() ? Common::Timer::GetCurrentValue() : 0)
+		{
+		}
+
+		__fi ~ScopedZone()
+		{
+			if (m_start != 0)
+				Internal::AddZone(m_name, m_start, Common::Timer::GetCurrentValue(), m_arg);
+		}
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+
+	private:
+		const char* m_name;
+		s64 m_arg;
+		Common::Timer::Value m_start;
+	};
+} // namespace TimelineTracer
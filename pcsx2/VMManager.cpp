@@ -23,6 +23,7 @@
 
 #include "common/Console.h"
 #include "common/FileSystem.h"
+#include "common/Perf.h"
 #include "common/ScopedGuard.h"
 #include "common/StringUtil.h"
 #include "common/SettingsWrapper.h"
@@ -44,17 +45,22 @@
 #include "HostSettings.h"
 #include "INISettingsInterface.h"
 #include "IopBios.h"
+#include "IPU/IPU_Thread.h"
 #include "MTVU.h"
 #include "MemoryCardFile.h"
 #include "Patch.h"
 #include "PerformanceMetrics.h"
+#include "PINE.h"
 #include "R5900.h"
 #include "SPU2/spu2.h"
 #include "DEV9/DEV9.h"
 #include "USB/USB.h"
 #include "PAD/Host/PAD.h"
 #include "Sio.h"
+#include "SubsystemProfiler.h"
+#include "TimelineTracer.h"
 #include "ps2/BiosTools.h"
+#include "x86/RecWarmStart.h"
 #include "Recording/InputRecordingControls.h"
 
 #include "DebugTools/MIPSAnalyst.h"
@@ -86,6 +92,7 @@ namespace VMManager
 	static void CheckForPatchConfigChanges(const Pcsx2Config& old_config);
 	static void CheckForDEV9ConfigChanges(const Pcsx2Config& old_config);
 	static void CheckForMemoryCardConfigChanges(const Pcsx2Config& old_config);
+	static void UpdatePINEServer();
 	static void EnforceAchievementsChallengeModeSettings();
 	static void LogUnsafeSettingsToConsole(const std::string& messages);
 	static void WarnAboutUnsafeSettings();
@@ -111,6 +118,7 @@ namespace VMManager
 	static void SetHardwareDependentDefaultSettings(SettingsInterface& si);
 	static void EnsureCPUInfoInitialized();
 	static void SetEmuThreadAffinities();
+	static void SetPerfJitDumpEnabled(bool enabled);
 } // namespace VMManager
 
 static std::unique_ptr<SysMainMemory> s_vm_memory;
@@ -125,12 +133,15 @@ static Threading::ThreadHandle s_vm_thread_handle;
 static std::deque<std::thread> s_save_state_threads;
 static std::mutex s_save_state_threads_mutex;
 
+static PINEServer s_pine_server;
+
 static std::recursive_mutex s_info_mutex;
 static std::string s_disc_path;
 static u32 s_game_crc;
 static u32 s_patches_crc;
 static std::string s_game_serial;
 static std::string s_game_name;
+static std::string s_game_version;
 static std::string s_elf_override;
 static std::string s_input_profile_name;
 static u32 s_active_game_fixes = 0;
@@ -201,6 +212,7 @@ void VMManager::SetState(VMState state)
 		else
 		{
 			PerformanceMetrics::Reset();
+			TimelineTracer::ResetFrameTiming();
 			frameLimitReset();
 		}
 
@@ -242,6 +254,12 @@ std::string VMManager::GetGameName()
 	return s_game_name;
 }
 
+std::string VMManager::GetGameVersion()
+{
+	std::unique_lock lock(s_info_mutex);
+	return s_game_version;
+}
+
 bool VMManager::Internal::InitializeGlobals()
 {
 	// On Win32, we have a bunch of things which use COM (e.g. SDL, XAudio2, etc).
@@ -285,6 +303,7 @@ bool VMManager::Internal::InitializeGlobals()
 
 void VMManager::Internal::ReleaseGlobals()
 {
+	s_pine_server.Deinitialize();
 	USBshutdown();
 	SPU2::Shutdown();
 	GSshutdown();
@@ -366,6 +385,8 @@ void VMManager::LoadSettings()
 
 		ApplyGameFixes();
 	}
+
+	UpdatePINEServer();
 }
 
 void VMManager::ApplyGameFixes()
@@ -691,11 +712,14 @@ void VMManager::UpdateRunningGame(bool resetting, bool game_starting)
 	// settings as if the game is already running (title, loadeding patches, etc).
 	u32 new_crc;
 	std::string new_serial;
+	std::string new_version;
 	if (!GSDumpReplayer::IsReplayingDump())
 	{
 		const bool ingame = (ElfCRC && (g_GameLoading || g_GameStarted));
 		new_crc = ingame ? ElfCRC : 0;
 		new_serial = ingame ? SysGetDiscID() : SysGetBiosDiscID();
+		if (ingame)
+			new_version = DiscVersion;
 	}
 	else
 	{
@@ -703,12 +727,13 @@ void VMManager::UpdateRunningGame(bool resetting, bool game_starting)
 		new_serial = GSDumpReplayer::GetDumpSerial();
 	}
 
-	if (!resetting && s_game_crc == new_crc && s_game_serial == new_serial)
+	if (!resetting && s_game_crc == new_crc && s_game_serial == new_serial && s_game_version == new_version)
 		return;
 
 	{
 		std::unique_lock lock(s_info_mutex);
 		s_game_serial = std::move(new_serial);
+		s_game_version = std::move(new_version);
 		s_game_crc = new_crc;
 		s_game_name.clear();
 
@@ -745,6 +770,9 @@ void VMManager::UpdateRunningGame(bool resetting, bool game_starting)
 	UpdateGameSettingsLayer();
 	ApplySettings();
 
+	// After the settings, so a per-game warm start setting is honoured.
+	RecWarmStart::GameChanged(s_game_serial, s_game_crc);
+
 	// Clear the memory card eject notification again when booting for the first time, or starting.
 	// Otherwise, games think the card was removed on boot.
 	if (game_starting || resetting)
@@ -1043,6 +1071,10 @@ bool VMManager::Initialize(VMBootParameters boot_params)
 #endif
 
 	s_cpu_implementation_changed = false;
+	SetPerfJitDumpEnabled(EmuConfig.Profiler.PerfJitDump);
+	TimelineTracer::UpdateSettings();
+	if (EmuConfig.HugePages)
+		s_vm_memory->AdviseHugePages();
 	s_cpu_provider_pack->ApplyConfig();
 	SetCPUState(EmuConfig.Cpu.sseMXCSR, EmuConfig.Cpu.sseVU0MXCSR, EmuConfig.Cpu.sseVU1MXCSR);
 	SysClearExecutionCache();
@@ -1053,6 +1085,7 @@ bool VMManager::Initialize(VMBootParameters boot_params)
 	frameLimitReset();
 	cpuReset();
 
+	s_vm_memory->LogHugePageUsage();
 	Console.WriteLn("VM subsystems initialized in %.2f ms", init_timer.GetTimeMilliseconds());
 	s_state.store(VMState::Paused, std::memory_order_release);
 	Host::OnVMStarted();
@@ -1087,8 +1120,11 @@ void VMManager::Shutdown(bool save_resume_state)
 	// sync everything
 	if (THREAD_VU1)
 		vu1Thread.WaitVU();
+	ipu_thread.WaitIdle();
 	GetMTGS().WaitGS();
 
+	RecWarmStart::Shutdown();
+
 	if (!GSDumpReplayer::IsReplayingDump() && save_resume_state)
 	{
 		std::string resume_file_name(GetCurrentSaveStateFileName(-1));
@@ -1103,6 +1139,7 @@ void VMManager::Shutdown(bool save_resume_state)
 	{
 		LastELF.clear();
 		DiscSerial.clear();
+		DiscVersion.clear();
 		ElfCRC = 0;
 		ElfEntry = 0;
 		ElfTextRange = {};
@@ -1114,6 +1151,7 @@ void VMManager::Shutdown(bool save_resume_state)
 		s_patches_crc = 0;
 		s_game_serial.clear();
 		s_game_name.clear();
+		s_game_version.clear();
 		Host::OnGameChanged(s_disc_path, s_elf_override, s_game_serial, s_game_name, 0);
 	}
 	s_active_game_fixes = 0;
@@ -1140,6 +1178,7 @@ void VMManager::Shutdown(bool save_resume_state)
 	DoCDVDclose();
 	FWclose();
 	FileMcd_EmuClose();
+	ipu_thread.Close();
 
 	// If the fullscreen UI is running, do a hardware reset on the GS
 	// so that the texture cache and targets are all cleared.
@@ -1155,6 +1194,8 @@ void VMManager::Shutdown(bool save_resume_state)
 
 	PADshutdown();
 	DEV9shutdown();
+	SetPerfJitDumpEnabled(false);
+	TimelineTracer::Shutdown();
 
 	s_state.store(VMState::Shutdown, std::memory_order_release);
 	Host::OnVMDestroyed();
@@ -1253,6 +1294,8 @@ bool VMManager::DoLoadState(const char* filename)
 	if (GSDumpReplayer::IsReplayingDump())
 		return false;
 
+	TimelineTracer::ScopedZone zone("Load State");
+
 	try
 	{
 		Host::OnSaveStateLoading(filename);
@@ -1279,6 +1322,7 @@ bool VMManager::DoSaveState(const char* filename, s32 slot_for_message, bool zip
 	if (GSDumpReplayer::IsReplayingDump())
 		return false;
 
+	TimelineTracer::ScopedZone zone("Save State");
 	std::string osd_key(fmt::format("SaveStateSlot{}", slot_for_message));
 
 	try
@@ -1325,6 +1369,7 @@ void VMManager::ZipSaveState(std::unique_ptr<ArchiveEntryList> elist,
 	std::unique_ptr<SaveStateScreenshotData> screenshot, std::string osd_key,
 	const char* filename, s32 slot_for_message)
 {
+	TimelineTracer::ScopedZone zone("Zip Save State");
 	Common::Timer timer;
 
 	if (SaveState_ZipToDisk(std::move(elist), std::move(screenshot), filename))
@@ -1573,6 +1618,8 @@ void VMManager::Execute()
 	}
 
 	// Execute until we're asked to stop.
+	TimelineTracer::SetCurrentThreadName("EE");
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::EE);
 	Cpu->Execute();
 }
 
@@ -1631,6 +1678,7 @@ void VMManager::Internal::VSyncOnCPUThread()
 	}
 
 	Host::CPUThreadVSync();
+	TimelineTracer::OnVSync();
 
 	if (EmuConfig.EnableRecordingTools)
 	{
@@ -1662,11 +1710,15 @@ void VMManager::CheckForCPUConfigChanges(const Pcsx2Config& old_config)
 
 	Console.WriteLn("Updating CPU configuration...");
 	SetCPUState(EmuConfig.Cpu.sseMXCSR, EmuConfig.Cpu.sseVU0MXCSR, EmuConfig.Cpu.sseVU1MXCSR);
+	SetPerfJitDumpEnabled(EmuConfig.Profiler.PerfJitDump);
 	SysClearExecutionCache();
 	memBindConditionalHandlers();
 
-	if (EmuConfig.Cpu.Recompiler.EnableFastmem != old_config.Cpu.Recompiler.EnableFastmem)
+	if (EmuConfig.Cpu.Recompiler.EnableFastmem != old_config.Cpu.Recompiler.EnableFastmem ||
+		EmuConfig.Cpu.Recompiler.EnableEECache != old_config.Cpu.Recompiler.EnableEECache)
+	{
 		vtlb_ResetFastmem();
+	}
 
 	if (EmuConfig.Cpu.Recompiler.EnableFullTLB != old_config.Cpu.Recompiler.EnableFullTLB)
 		RemapAllTLBs();
@@ -1685,6 +1737,14 @@ void VMManager::CheckForCPUConfigChanges(const Pcsx2Config& old_config)
 	{
 		SetEmuThreadAffinities();
 	}
+
+	if (EmuConfig.Speedhacks.ipuThread != old_config.Speedhacks.ipuThread)
+	{
+		if (EmuConfig.Speedhacks.ipuThread)
+			ipu_thread.Open();
+		else
+			ipu_thread.Close();
+	}
 }
 
 void VMManager::CheckForGSConfigChanges(const Pcsx2Config& old_config)
@@ -1786,6 +1846,24 @@ void VMManager::CheckForMemoryCardConfigChanges(const Pcsx2Config& old_config)
 	sioSetGameSerial(sioSerial);
 }
 
+void VMManager::UpdatePINEServer()
+{
+	// Runs independently of the VM, so clients can query the status while nothing is running.
+	if (EmuConfig.EnablePINE == s_pine_server.IsInitialized())
+		return;
+
+	if (EmuConfig.EnablePINE)
+	{
+		Console.WriteLn("Starting PINE server on slot %d", PINE_DEFAULT_SLOT);
+		s_pine_server.Initialize();
+	}
+	else
+	{
+		Console.WriteLn("Stopping PINE server");
+		s_pine_server.Deinitialize();
+	}
+}
+
 void VMManager::CheckForConfigChanges(const Pcsx2Config& old_config)
 {
 	if (HasValidVM())
@@ -1811,6 +1889,8 @@ void VMManager::CheckForConfigChanges(const Pcsx2Config& old_config)
 	if (HasValidVM() || GetMTGS().IsOpen())
 		CheckForGSConfigChanges(old_config);
 
+	TimelineTracer::UpdateSettings();
+
 	Host::CheckForSettingsChanges(old_config);
 }
 
@@ -2234,6 +2314,25 @@ void VMManager::SetEmuThreadAffinities()
 	GetMTGS().GetThreadHandle().SetAffinity(gs_affinity);
 }
 
+void VMManager::SetPerfJitDumpEnabled(bool enabled)
+{
+	if (enabled == Perf::IsJitDumpOpen())
+		return;
+
+	if (!enabled)
+	{
+		Perf::CloseJitDump();
+		Console.WriteLn("Closed perf jitdump.");
+		return;
+	}
+
+	// Callers clear the execution cache afterwards, so every block gets written out.
+	if (Perf::OpenJitDump())
+		Console.WriteLn(Color_StrongGreen, "Writing perf jitdump for recompiled code.");
+	else
+		Console.Error("Failed to open perf jitdump (only supported on Linux).");
+}
+
 void VMManager::SetHardwareDependentDefaultSettings(SettingsInterface& si)
 {
 	SetMTVUAndAffinityControlDefault(si);
@@ -80,6 +80,9 @@ namespace VMManager
 	/// Returns the name of the disc/executable currently running.
 	std::string GetGameName();
 
+	/// Returns the version from the running disc's SYSTEM.CNF, or an empty string if it has none.
+	std::string GetGameVersion();
+
 	/// Loads global settings (i.e. EmuConfig).
 	void LoadSettings();
 
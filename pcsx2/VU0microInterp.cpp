@@ -18,6 +18,7 @@
 #include "Common.h"
 
 #include "VUmicro.h"
+#include "SubsystemProfiler.h"
 
 #include <cfenv>
 
@@ -267,6 +268,7 @@ void InterpVU0::Step()
 
 void InterpVU0::Execute(u32 cycles)
 {
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::VU0);
 	const int originalRounding = fegetround();
 	fesetround(g_sseVU0MXCSR.RoundingControl << 8);
 
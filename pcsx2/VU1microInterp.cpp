@@ -21,6 +21,7 @@
 #include "GS.h"
 #include "Gif_Unit.h"
 #include "MTVU.h"
+#include "SubsystemProfiler.h"
 
 #include <cfenv>
 
@@ -272,6 +273,7 @@ void InterpVU1::Step()
 
 void InterpVU1::Execute(u32 cycles)
 {
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::VU1);
 	const int originalRounding = fegetround();
 	fesetround(g_sseVU1MXCSR.RoundingControl << 8);
 
@@ -102,6 +102,10 @@ static std::vector<u32> s_fastmem_virtual_mapping; // maps vaddr -> mainmem offs
 static std::unordered_multimap<u32, u32> s_fastmem_physical_mapping; // maps mainmem offset -> vaddr
 static std::unordered_map<uptr, LoadstoreBackpatchInfo> s_fastmem_backpatch_info;
 static std::unordered_set<u32> s_fastmem_faulting_pcs;
+static std::vector<std::pair<u32, u32>> s_fastmem_watch_ranges; // vaddr ranges with memchecks
+static std::unordered_set<u32> s_fastmem_watched_offsets; // mainmem offsets hidden from fastmem for them
+static std::vector<std::pair<u32, u32>> s_fastmem_cache_ranges; // vtlb page ranges marked in cachePageModes
+static std::unordered_set<u32> s_fastmem_cached_pages; // vtlb pages hidden from fastmem while the cache is emulated
 
 vtlb_private::VTLBPhysical vtlb_private::VTLBPhysical::fromPointer(sptr ptr)
 {
@@ -139,6 +143,10 @@ __inline int CheckCache(u32 addr)
 		return false; //
 	}
 
+	const u8 mode = cachePageModes[addr >> VTLB_PAGE_BITS];
+	if (mode != CACHE_PAGE_PARTIAL)
+		return mode == CACHE_PAGE_CACHED;
+
 	for (int i = 1; i < 48; i++)
 	{
 		if (((tlb[i].EntryLo1 & 0x38) >> 3) == 0x3)
@@ -177,27 +185,24 @@ DataType vtlb_memRead(u32 addr)
 
 	if (!vmv.isHandler(addr))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(addr))
 		{
-			if (CHECK_CACHE && CheckCache(addr))
+			switch (DataSize)
 			{
-				switch (DataSize)
-				{
-					case 8:
-						return readCache8(addr);
-						break;
-					case 16:
-						return readCache16(addr);
-						break;
-					case 32:
-						return readCache32(addr);
-						break;
-					case 64:
-						return readCache64(addr);
-						break;
-
-						jNO_DEFAULT;
-				}
+				case 8:
+					return readCache8(addr);
+					break;
+				case 16:
+					return readCache16(addr);
+					break;
+				case 32:
+					return readCache32(addr);
+					break;
+				case 64:
+					return readCache64(addr);
+					break;
+
+					jNO_DEFAULT;
 			}
 		}
 
@@ -232,12 +237,9 @@ RETURNS_R128 vtlb_memRead128(u32 mem)
 
 	if (!vmv.isHandler(mem))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(mem))
 		{
-			if (CHECK_CACHE && CheckCache(mem))
-			{
-				return readCache128(mem);
-			}
+			return readCache128(mem);
 		}
 
 		return r128_load(reinterpret_cast<const void*>(vmv.assumePtr(mem)));
@@ -260,25 +262,22 @@ void vtlb_memWrite(u32 addr, DataType data)
 
 	if (!vmv.isHandler(addr))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(addr))
 		{
-			if (CHECK_CACHE && CheckCache(addr))
+			switch (DataSize)
 			{
-				switch (DataSize)
-				{
-					case 8:
-						writeCache8(addr, data);
-						return;
-					case 16:
-						writeCache16(addr, data);
-						return;
-					case 32:
-						writeCache32(addr, data);
-						return;
-					case 64:
-						writeCache64(addr, data);
-						return;
-				}
+				case 8:
+					writeCache8(addr, data);
+					return;
+				case 16:
+					writeCache16(addr, data);
+					return;
+				case 32:
+					writeCache32(addr, data);
+					return;
+				case 64:
+					writeCache64(addr, data);
+					return;
 			}
 		}
 
@@ -299,14 +298,11 @@ void TAKES_R128 vtlb_memWrite128(u32 mem, r128 value)
 
 	if (!vmv.isHandler(mem))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(mem))
 		{
-			if (CHECK_CACHE && CheckCache(mem))
-			{
-				alignas(16) const u128 r = r128_to_u128(value);
-				writeCache128(mem, &r);
-				return;
-			}
+			alignas(16) const u128 r = r128_to_u128(value);
+			writeCache128(mem, &r);
+			return;
 		}
 
 		r128_store_unaligned((void*)vmv.assumePtr(mem), value);
@@ -849,6 +845,61 @@ static bool vtlb_IsHostCoalesced(u32 page)
 	}
 }
 
+// Returns true if the host page containing this vtlb page is left unmapped in the fastmem area,
+// because it backs memory which has a memcheck on it.
+static bool vtlb_IsFastmemWatched(u32 page)
+{
+	if (s_fastmem_watched_offsets.empty())
+		return false;
+
+	if constexpr (!vtlb_MismatchedHostPageSize())
+	{
+		return (s_fastmem_watched_offsets.find(s_fastmem_virtual_mapping[page]) != s_fastmem_watched_offsets.end());
+	}
+	else
+	{
+		static constexpr u32 count = (1u << (__pageshift - VTLB_PAGE_BITS));
+		const u32 base = page & ~(count - 1);
+		for (u32 i = 0; i < count; i++)
+		{
+			if (s_fastmem_watched_offsets.find(s_fastmem_virtual_mapping[base + i]) != s_fastmem_watched_offsets.end())
+				return true;
+		}
+
+		return false;
+	}
+}
+
+// Returns true if the host page containing this vtlb page is left unmapped in the fastmem area,
+// because it's cached and the access has to go through the cache emulation instead.
+static bool vtlb_IsFastmemCached(u32 page)
+{
+	if (s_fastmem_cached_pages.empty())
+		return false;
+
+	if constexpr (!vtlb_MismatchedHostPageSize())
+	{
+		return (s_fastmem_cached_pages.find(page) != s_fastmem_cached_pages.end());
+	}
+	else
+	{
+		static constexpr u32 count = (1u << (__pageshift - VTLB_PAGE_BITS));
+		const u32 base = page & ~(count - 1);
+		for (u32 i = 0; i < count; i++)
+		{
+			if (s_fastmem_cached_pages.find(base + i) != s_fastmem_cached_pages.end())
+				return true;
+		}
+
+		return false;
+	}
+}
+
+static bool vtlb_IsFastmemHidden(u32 page)
+{
+	return vtlb_IsFastmemWatched(page) || vtlb_IsFastmemCached(page);
+}
+
 static bool vtlb_GetMainMemoryOffsetFromPtr(uptr ptr, u32* mainmem_offset, u32* mainmem_size, PageProtectionMode* prot)
 {
 	const uptr page_end = ptr + VTLB_PAGE_SIZE;
@@ -920,7 +971,7 @@ static void vtlb_CreateFastmemMapping(u32 vaddr, u32 mainmem_offset, const PageP
 	if (s_fastmem_virtual_mapping[page] != NO_FASTMEM_MAPPING)
 	{
 		// current mapping needs to be removed
-		const bool was_coalesced = vtlb_IsHostCoalesced(page);
+		const bool was_coalesced = vtlb_IsHostCoalesced(page) && !vtlb_IsFastmemHidden(page);
 
 		s_fastmem_virtual_mapping[page] = NO_FASTMEM_MAPPING;
 		if (was_coalesced && !s_fastmem_area->Unmap(s_fastmem_area->PagePointer(vtlb_HostPage(page)), __pagesize))
@@ -937,7 +988,7 @@ static void vtlb_CreateFastmemMapping(u32 vaddr, u32 mainmem_offset, const PageP
 	}
 
 	s_fastmem_virtual_mapping[page] = mainmem_offset;
-	if (vtlb_IsHostCoalesced(page))
+	if (vtlb_IsHostCoalesced(page) && !vtlb_IsFastmemHidden(page))
 	{
 		const u32 host_page = vtlb_HostPage(page);
 		const u32 host_offset = vtlb_HostAlignOffset(mainmem_offset);
@@ -961,7 +1012,7 @@ static void vtlb_RemoveFastmemMapping(u32 vaddr)
 		return;
 
 	const u32 mainmem_offset = s_fastmem_virtual_mapping[page];
-	const bool was_coalesced = vtlb_IsHostCoalesced(page);
+	const bool was_coalesced = vtlb_IsHostCoalesced(page) && !vtlb_IsFastmemHidden(page);
 	FASTMEM_LOG("Remove fastmem mapping @ vaddr %08X mainmem %08X", vaddr, mainmem_offset);
 	s_fastmem_virtual_mapping[page] = NO_FASTMEM_MAPPING;
 
@@ -1001,9 +1052,10 @@ static void vtlb_RemoveFastmemMappings()
 		if (s_fastmem_virtual_mapping[page] == NO_FASTMEM_MAPPING)
 			continue;
 
+		const bool was_hidden = vtlb_IsFastmemHidden(page);
 		s_fastmem_virtual_mapping[page] = NO_FASTMEM_MAPPING;
 
-		if (!vtlb_IsHostAligned(page << VTLB_PAGE_BITS))
+		if (!vtlb_IsHostAligned(page << VTLB_PAGE_BITS) || was_hidden)
 			continue;
 
 		if (!s_fastmem_area->Unmap(s_fastmem_area->PagePointer(vtlb_HostPage(page)), __pagesize))
@@ -1011,6 +1063,8 @@ static void vtlb_RemoveFastmemMappings()
 	}
 
 	s_fastmem_physical_mapping.clear();
+	s_fastmem_watched_offsets.clear();
+	s_fastmem_cached_pages.clear();
 }
 
 bool vtlb_ResolveFastmemMapping(uptr* addr)
@@ -1073,12 +1127,140 @@ void vtlb_UpdateFastmemProtection(u32 paddr, u32 size, const PageProtectionMode&
 		{
 			FASTMEM_LOG("  valias %08X (size %u)", it->second, VTLB_PAGE_SIZE);
 
-			if (vtlb_IsHostAligned(it->second))
+			if (vtlb_IsHostAligned(it->second) && !vtlb_IsFastmemHidden(it->second / VTLB_PAGE_SIZE))
 				HostSys::MemProtect(s_fastmem_area->OffsetPointer(it->second), __pagesize, prot);
 		}
 	}
 }
 
+// Maps or unmaps each page in the fastmem area whose hidden state differs from the one it had before.
+static void vtlb_UpdateFastmemHiddenPages(const std::unordered_map<u32, bool>& pages)
+{
+	for (const auto& [page, was_hidden] : pages)
+	{
+		const bool hidden = vtlb_IsFastmemHidden(page);
+		if (hidden == was_hidden || s_fastmem_virtual_mapping[page] == NO_FASTMEM_MAPPING || !vtlb_IsHostCoalesced(page))
+			continue;
+
+		const u32 vaddr = page * VTLB_PAGE_SIZE;
+		const u32 mainmem_offset = s_fastmem_virtual_mapping[page];
+		if (hidden)
+		{
+			FASTMEM_LOG("Hiding fastmem mapping @ vaddr %08X", vaddr);
+			if (!s_fastmem_area->Unmap(s_fastmem_area->PagePointer(vtlb_HostPage(page)), __pagesize))
+				Console.Error("Failed to unmap vaddr %08X", vtlb_HostAlignOffset(vaddr));
+		}
+		else
+		{
+			u32 unused_offset, unused_size;
+			PageProtectionMode mode;
+			if (!vtlb_GetMainMemoryOffsetFromPtr((uptr)GetVmMemory().MainMemory()->GetBase() + mainmem_offset,
+					&unused_offset, &unused_size, &mode))
+			{
+				continue;
+			}
+
+			FASTMEM_LOG("Restoring fastmem mapping @ vaddr %08X", vaddr);
+			if (!s_fastmem_area->Map(GetVmMemory().MainMemory()->GetFileHandle(), vtlb_HostAlignOffset(mainmem_offset),
+					s_fastmem_area->PagePointer(vtlb_HostPage(page)), __pagesize, mode))
+			{
+				Console.Error("Failed to map vaddr %08X to mainmem offset %08X", vtlb_HostAlignOffset(vaddr), mainmem_offset);
+			}
+		}
+	}
+}
+
+static void vtlb_UpdateFastmemWatches()
+{
+	if (s_fastmem_virtual_mapping.empty())
+	{
+		// not initialized yet, vtlb_ResetFastmem() will pick the ranges up
+		s_fastmem_watched_offsets.clear();
+		return;
+	}
+
+	// Watch the backing memory rather than the virtual range, so every alias of it (uncached
+	// mirrors, kseg0/1, TLB mappings created later) faults as well.
+	std::unordered_set<u32> offsets;
+	for (const auto& [start, end] : s_fastmem_watch_ranges)
+	{
+		const u32 last_page = (std::max(end, start + 1) - 1) / VTLB_PAGE_SIZE;
+		for (u32 page = start / VTLB_PAGE_SIZE; page <= last_page; page++)
+		{
+			if (s_fastmem_virtual_mapping[page] != NO_FASTMEM_MAPPING)
+				offsets.insert(s_fastmem_virtual_mapping[page]);
+		}
+	}
+
+	if (offsets == s_fastmem_watched_offsets)
+		return;
+
+	// Everything mapping to the old or new set might change state.
+	std::unordered_map<u32, bool> pages;
+	for (const std::unordered_set<u32>* set : {&s_fastmem_watched_offsets, &offsets})
+	{
+		for (const u32 offset : *set)
+		{
+			auto range = s_fastmem_physical_mapping.equal_range(offset);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				const u32 page = it->second / VTLB_PAGE_SIZE;
+				pages.emplace(page, vtlb_IsFastmemHidden(page));
+			}
+		}
+	}
+
+	s_fastmem_watched_offsets = std::move(offsets);
+	vtlb_UpdateFastmemHiddenPages(pages);
+}
+
+void vtlb_SetFastmemWatchRanges(std::vector<std::pair<u32, u32>> ranges)
+{
+	s_fastmem_watch_ranges = std::move(ranges);
+	vtlb_UpdateFastmemWatches();
+}
+
+static void vtlb_UpdateFastmemCachedPages()
+{
+	if (s_fastmem_virtual_mapping.empty())
+	{
+		// not initialized yet, vtlb_ResetFastmem() will pick the ranges up
+		s_fastmem_cached_pages.clear();
+		return;
+	}
+
+	// Cached pages fault on their first access, and get backpatched to the slow path which checks the cache.
+	std::unordered_set<u32> cached_pages;
+	if (CHECK_CACHE)
+	{
+		for (const auto& [start_page, end_page] : s_fastmem_cache_ranges)
+		{
+			for (u32 page = start_page; page <= end_page; page++)
+				cached_pages.insert(page);
+		}
+	}
+
+	if (cached_pages == s_fastmem_cached_pages)
+		return;
+
+	std::unordered_map<u32, bool> pages;
+	for (const std::unordered_set<u32>* set : {&s_fastmem_cached_pages, &cached_pages})
+	{
+		for (const u32 page : *set)
+			pages.emplace(page, vtlb_IsFastmemHidden(page));
+	}
+
+	s_fastmem_cached_pages = std::move(cached_pages);
+	vtlb_UpdateFastmemHiddenPages(pages);
+}
+
+void vtlb_SetFastmemCacheRanges(std::vector<std::pair<u32, u32>> page_ranges)
+{
+	s_fastmem_cache_ranges = std::move(page_ranges);
+	if (CHECK_FASTMEM)
+		vtlb_UpdateFastmemCachedPages();
+}
+
 void vtlb_ClearLoadStoreInfo()
 {
 	s_fastmem_backpatch_info.clear();
@@ -1110,6 +1292,13 @@ bool vtlb_BackpatchLoadStore(uptr code_address, uptr fault_address)
 
 	const LoadstoreBackpatchInfo& info = iter->second;
 	const u32 guest_addr = static_cast<u32>(fault_address - fastmem_start);
+
+	// This access won't go through the memcheck the recompiled block gets, so check it here.
+	// Handler pages (e.g. hardware registers) were never in fastmem, so they fault without being
+	// hidden for the memcheck, and the page alone can't tell us whether the access is watched.
+	if (!s_fastmem_watch_ranges.empty())
+		vtlb_DynMemcheckFault(info.guest_pc, guest_addr, info.size_in_bits, !info.is_load);
+
 	vtlb_DynBackpatchLoadStore(code_address, info.code_size, info.guest_pc, guest_addr,
 		info.gpr_bitmask, info.fpr_bitmask, info.address_register, info.data_register,
 		info.size_in_bits, info.is_signed, info.is_load, info.is_fpr);
@@ -1151,6 +1340,10 @@ void vtlb_VMap(u32 vaddr, u32 paddr, u32 size, bool writable)
 			else
 				vtlb_RemoveFastmemMapping(current_vaddr);
 		}
+
+		// watched ranges may be backed by different memory now
+		if (!s_fastmem_watch_ranges.empty())
+			vtlb_UpdateFastmemWatches();
 	}
 
 	while (size > 0)
@@ -1397,6 +1590,9 @@ void vtlb_ResetFastmem()
 		if (vtlb_GetMainMemoryOffsetFromPtr(vm.assumePtr(vaddr), &mainmem_offset, &mainmem_size, &prot))
 			vtlb_CreateFastmemMapping(vaddr, mainmem_offset, prot);
 	}
+
+	vtlb_UpdateFastmemWatches();
+	vtlb_UpdateFastmemCachedPages();
 }
 
 static constexpr size_t VMAP_SIZE = sizeof(VTLBVirtual) * VTLB_VMAP_ITEMS;
@@ -1663,6 +1859,10 @@ bool vtlb_private::PageFaultHandler(const PageFaultInfo& info)
 		// this was inside the fastmem area. check if it's a code page
 		// fprintf(stderr, "Fault on fastmem %p vaddr %08X\n", info.addr, vaddr);
 
+		// watched and cached pages aren't mapped at all, it's not a code write even if the page is protected
+		if (vtlb_IsFastmemHidden(vaddr / VTLB_PAGE_SIZE))
+			return vtlb_BackpatchLoadStore(info.pc, info.addr);
+
 		uptr ptr = (uptr)PSM(vaddr);
 		uptr offset = (ptr - (uptr)eeMem->Main);
 		if (ptr && m_PageProtectInfo[offset >> __pageshift].Mode == ProtMode_Write)
@@ -92,11 +92,14 @@ extern bool vtlb_ResolveFastmemMapping(uptr* addr);
 extern bool vtlb_GetGuestAddress(uptr host_addr, u32* guest_addr);
 extern void vtlb_UpdateFastmemProtection(u32 paddr, u32 size, const PageProtectionMode& prot);
 extern bool vtlb_BackpatchLoadStore(uptr code_address, uptr fault_address);
+extern void vtlb_SetFastmemWatchRanges(std::vector<std::pair<u32, u32>> ranges);
+extern void vtlb_SetFastmemCacheRanges(std::vector<std::pair<u32, u32>> page_ranges);
 
 extern void vtlb_ClearLoadStoreInfo();
 extern void vtlb_AddLoadStoreInfo(uptr code_address, u32 code_size, u32 guest_pc, u32 gpr_bitmask, u32 fpr_bitmask, u8 address_register, u8 data_register, u8 size_in_bits, bool is_signed, bool is_load, bool is_fpr);
 extern void vtlb_DynBackpatchLoadStore(uptr code_address, u32 code_size, u32 guest_pc, u32 guest_addr, u32 gpr_bitmask, u32 fpr_bitmask, u8 address_register, u8 data_register, u8 size_in_bits, bool is_signed, bool is_load, bool is_fpr);
 extern bool vtlb_IsFaultingPC(u32 guest_pc);
+extern void vtlb_DynMemcheckFault(u32 guest_pc, u32 guest_addr, u32 size_in_bits, bool is_store);
 
 //Memory functions
 
@@ -0,0 +1,272 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+
+#include "RecWarmStart.h"
+#include "Config.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+
+#include "fmt/format.h"
+
+#define XXH_STATIC_LINKING_ONLY 1
+#define XXH_INLINE_ALL 1
+#include <xxhash.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace RecWarmStart
+{
+	static constexpr u32 PROFILE_MAGIC = 0x50535752; // RWSP
+	// Bump when the recompilers change in a way which makes old blocks meaningless,
+	// e.g. the layout of microRegInfo.
+	static constexpr u32 PROFILE_VERSION = 1;
+
+	// Keeps a game which streams in lots of code from growing the profile forever.
+	static constexpr size_t MAX_EE_BLOCKS = 131072;
+	static constexpr size_t MAX_VU_PROGRAMS = 4096;
+	static constexpr size_t MAX_VU_BLOCKS_PER_PROGRAM = 256;
+
+	struct ProfileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 vu_state_size;
+		u32 num_ee_blocks;
+		u32 num_vu_blocks;
+	};
+
+	struct VUFileEntry
+	{
+		u32 vu;
+		u32 start_pc;
+		u64 prog_hash;
+		u8 state[VU_STATE_SIZE];
+	};
+
+	using VUProgramMap = std::unordered_map<u64, std::vector<VUBlock>>;
+
+	static void Load();
+	static void Save();
+	static void Clear();
+
+	static std::string s_filename;
+	static std::atomic_bool s_active{false};
+	static bool s_dirty = false;
+
+	// CPU thread only.
+	static std::unordered_map<u32, EEBlock> s_ee_blocks;
+	static std::vector<EEBlock> s_pending_ee_blocks;
+
+	// Shared with the MTVU thread.
+	static std::mutex s_vu_mutex;
+	static VUProgramMap s_vu_programs[2];
+	static bool s_vu_dirty = false;
+} // namespace RecWarmStart
+
+bool RecWarmStart::IsEnabled()
+{
+	return EmuConfig.Cpu.Recompiler.EnableWarmStart && s_active.load(std::memory_order_relaxed);
+}
+
+void RecWarmStart::GameChanged(const std::string& serial, u32 crc)
+{
+	Save();
+	Clear();
+
+	if (!EmuConfig.Cpu.Recompiler.EnableWarmStart || serial.empty() || crc == 0)
+		return;
+
+	s_filename = Path::Combine(EmuFolders::Cache, fmt::format("rec_profile_{}_{:08X}.bin", serial, crc));
+	Load();
+	s_active.store(true, std::memory_order_release);
+}
+
+void RecWarmStart::Shutdown()
+{
+	Save();
+	Clear();
+}
+
+void RecWarmStart::Clear()
+{
+	s_active.store(false, std::memory_order_release);
+	s_filename.clear();
+	s_dirty = false;
+	s_ee_blocks.clear();
+	s_pending_ee_blocks.clear();
+
+	std::unique_lock lock(s_vu_mutex);
+	for (VUProgramMap& programs : s_vu_programs)
+		programs.clear();
+	s_vu_dirty = false;
+}
+
+void RecWarmStart::Load()
+{
+	std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(s_filename.c_str()));
+	if (!data.has_value())
+		return;
+
+	ProfileHeader header = {};
+	if (data->size() >= sizeof(header))
+		std::memcpy(&header, data->data(), sizeof(header));
+	if (header.magic != PROFILE_MAGIC || header.version != PROFILE_VERSION || header.vu_state_size != VU_STATE_SIZE ||
+		data->size() != (sizeof(header) + header.num_ee_blocks * sizeof(EEBlock) + header.num_vu_blocks * sizeof(VUFileEntry)))
+	{
+		Console.Warning("Ignoring invalid recompiler profile '%s'", s_filename.c_str());
+		return;
+	}
+
+	const u8* ptr = data->data() + sizeof(header);
+	s_pending_ee_blocks.resize(header.num_ee_blocks);
+	std::memcpy(s_pending_ee_blocks.data(), ptr, header.num_ee_blocks * sizeof(EEBlock));
+	ptr += header.num_ee_blocks * sizeof(EEBlock);
+	for (const EEBlock& block : s_pending_ee_blocks)
+		s_ee_blocks.emplace(block.pc, block);
+
+	std::unique_lock lock(s_vu_mutex);
+	for (u32 i = 0; i < header.num_vu_blocks; i++, ptr += sizeof(VUFileEntry))
+	{
+		VUFileEntry entry;
+		std::memcpy(&entry, ptr, sizeof(entry));
+		if (entry.vu > 1)
+			continue;
+
+		VUBlock& block = s_vu_programs[entry.vu][entry.prog_hash].emplace_back();
+		block.start_pc = entry.start_pc;
+		std::memcpy(block.state.data(), entry.state, VU_STATE_SIZE);
+	}
+
+	DevCon.WriteLn("Loaded %u EE blocks and %u microVU blocks from '%s'", header.num_ee_blocks, header.num_vu_blocks,
+		s_filename.c_str());
+}
+
+void RecWarmStart::Save()
+{
+	if (s_filename.empty())
+		return;
+
+	std::vector<VUFileEntry> vu_entries;
+	{
+		std::unique_lock lock(s_vu_mutex);
+		if (!s_dirty && !s_vu_dirty)
+			return;
+
+		for (u32 vu = 0; vu < std::size(s_vu_programs); vu++)
+		{
+			for (const auto& [prog_hash, blocks] : s_vu_programs[vu])
+			{
+				for (const VUBlock& block : blocks)
+				{
+					VUFileEntry& entry = vu_entries.emplace_back();
+					entry.vu = vu;
+					entry.start_pc = block.start_pc;
+					entry.prog_hash = prog_hash;
+					std::memcpy(entry.state, block.state.data(), VU_STATE_SIZE);
+				}
+			}
+		}
+	}
+
+	std::vector<EEBlock> ee_blocks;
+	ee_blocks.reserve(s_ee_blocks.size());
+	for (const auto& it : s_ee_blocks)
+		ee_blocks.push_back(it.second);
+	std::sort(ee_blocks.begin(), ee_blocks.end(), [](const EEBlock& lhs, const EEBlock& rhs) { return lhs.pc < rhs.pc; });
+
+	auto fp = FileSystem::OpenManagedCFile(s_filename.c_str(), "wb");
+	const ProfileHeader header = {PROFILE_MAGIC, PROFILE_VERSION, VU_STATE_SIZE,
+		static_cast<u32>(ee_blocks.size()), static_cast<u32>(vu_entries.size())};
+	if (!fp || std::fwrite(&header, sizeof(header), 1, fp.get()) != 1 ||
+		std::fwrite(ee_blocks.data(), sizeof(EEBlock), ee_blocks.size(), fp.get()) != ee_blocks.size() ||
+		std::fwrite(vu_entries.data(), sizeof(VUFileEntry), vu_entries.size(), fp.get()) != vu_entries.size())
+	{
+		Console.Error("Failed to write recompiler profile '%s'", s_filename.c_str());
+		return;
+	}
+
+	DevCon.WriteLn("Saved %zu EE blocks and %zu microVU blocks to '%s'", ee_blocks.size(), vu_entries.size(),
+		s_filename.c_str());
+}
+
+u64 RecWarmStart::HashCode(const void* data, size_t size)
+{
+	return XXH3_64bits(data, size);
+}
+
+void RecWarmStart::RecordEEBlock(u32 pc, u32 size, u64 hash)
+{
+	if (s_ee_blocks.size() >= MAX_EE_BLOCKS && s_ee_blocks.find(pc) == s_ee_blocks.end())
+		return;
+
+	EEBlock& block = s_ee_blocks[pc];
+	if (block.pc == pc && block.size == size && block.hash == hash)
+		return;
+
+	block = {pc, size, hash};
+	s_dirty = true;
+}
+
+std::vector<RecWarmStart::EEBlock>& RecWarmStart::GetPendingEEBlocks()
+{
+	return s_pending_ee_blocks;
+}
+
+void RecWarmStart::RecordVUBlock(u32 vu, u64 prog_hash, u32 start_pc, const void* state)
+{
+	std::unique_lock lock(s_vu_mutex);
+
+	VUProgramMap& programs = s_vu_programs[vu];
+	auto it = programs.find(prog_hash);
+	if (it == programs.end())
+	{
+		if (programs.size() >= MAX_VU_PROGRAMS)
+			return;
+		it = programs.emplace(prog_hash, std::vector<VUBlock>()).first;
+	}
+
+	std::vector<VUBlock>& blocks = it->second;
+	if (blocks.size() >= MAX_VU_BLOCKS_PER_PROGRAM)
+		return;
+
+	for (const VUBlock& block : blocks)
+	{
+		if (block.start_pc == start_pc && std::memcmp(block.state.data(), state, VU_STATE_SIZE) == 0)
+			return;
+	}
+
+	VUBlock& block = blocks.emplace_back();
+	block.start_pc = start_pc;
+	std::memcpy(block.state.data(), state, VU_STATE_SIZE);
+	s_vu_dirty = true;
+}
+
+std::vector<RecWarmStart::VUBlock> RecWarmStart::GetVUBlocks(u32 vu, u64 prog_hash)
+{
+	std::unique_lock lock(s_vu_mutex);
+
+	const VUProgramMap& programs = s_vu_programs[vu];
+	const auto it = programs.find(prog_hash);
+	return (it != programs.end()) ? it->second : std::vector<VUBlock>();
+}
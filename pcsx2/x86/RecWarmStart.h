@@ -0,0 +1,70 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2023  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Remembers which EE blocks and microVU blocks a game compiled, so the next boot can
+// compile them ahead of time instead of stalling the first time each one is reached.
+// Nothing is trusted from the file: EE blocks are only compiled when the code in memory
+// hashes the same, and microVU blocks are only compiled for a program with the same hash.
+namespace RecWarmStart
+{
+	/// Size of the microVU pipeline state (microRegInfo) a block was compiled with.
+	static constexpr u32 VU_STATE_SIZE = 160;
+
+	struct EEBlock
+	{
+		u32 pc;
+		u32 size; // in instructions
+		u64 hash;
+	};
+
+	struct VUBlock
+	{
+		u32 start_pc;
+		std::array<u8, VU_STATE_SIZE> state;
+	};
+
+	/// Returns true if blocks should be recorded and warmed up.
+	bool IsEnabled();
+
+	/// Saves the profile of the previous game and loads the one for the new game. CPU thread.
+	void GameChanged(const std::string& serial, u32 crc);
+
+	/// Saves the profile of the running game, and forgets it. CPU thread, with MTVU idle.
+	void Shutdown();
+
+	/// Returns a hash of the given code, as stored in the profile.
+	u64 HashCode(const void* data, size_t size);
+
+	// EE recompiler, CPU thread only.
+	void RecordEEBlock(u32 pc, u32 size, u64 hash);
+
+	/// Blocks from the loaded profile which haven't been compiled yet. The recompiler
+	/// removes entries as it compiles them, or once they're no longer worth trying.
+	std::vector<EEBlock>& GetPendingEEBlocks();
+
+	// microVU recompilers, VU1 may be on the MTVU thread.
+	void RecordVUBlock(u32 vu, u64 prog_hash, u32 start_pc, const void* state);
+
+	/// Returns the blocks previously compiled for the microprogram with this hash.
+	std::vector<VUBlock> GetVUBlocks(u32 vu, u64 prog_hash);
+} // namespace RecWarmStart
@@ -76,6 +76,8 @@ void LoadBranchState();
 void recompileNextInstruction(bool delayslot, bool swapped_delay_slot);
 void SetBranchReg(u32 reg);
 void SetBranchImm(u32 imm);
+// Falls through to the next instruction instead when the branch is a superblock side exit.
+void SetBranchImmOrContinue(u32 imm);
 
 void iFlushCall(int flushtype);
 void recBranchCall(void (*func)());
@@ -23,6 +23,7 @@
 #include "iR5900.h"
 #include "iR5900Analysis.h"
 #include "BaseblockEx.h"
+#include "RecWarmStart.h"
 #include "VirtualMemory.h"
 #include "vtlb.h"
 
@@ -32,6 +33,7 @@
 #include "Elfheader.h"
 #include "Host.h"
 #include "COP0.h"
+#include "Counters.h"
 
 #include "DebugTools/Breakpoints.h"
 #include "Patch.h"
@@ -41,11 +43,13 @@
 #include "common/FastJmp.h"
 #include "common/MemsetFast.inl"
 #include "common/Perf.h"
+#include "common/Timer.h"
 
 // Only for MOVQ workaround.
 #include "common/emitter/internal.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include "fmt/format.h"
 
 //#define DUMP_BLOCKS 1
@@ -68,7 +72,9 @@ static bool eeRecIsReset = false;
 static bool eeRecNeedsReset = false;
 static bool eeCpuExecuting = false;
 static bool eeRecExitRequested = false;
+static bool eeMemcheckFaultHit = false;
 static bool g_resetEeScalingStats = false;
+static uint s_warmStartNextFrame = 0;
 
 #define PC_GETBLOCK(x) PC_GETBLOCK_(x, recLUT)
 
@@ -114,6 +120,37 @@ static BASEBLOCKEX* s_pCurBlockEx = NULL;
 u32 s_nEndBlock = 0; // what pc the current block ends
 u32 s_branchTo;
 static bool s_nBlockFF;
+static u32 s_nStartBlock; // what pc the current block starts
+
+// Superblocks: a block which ends in a conditional branch counts how often it runs, and once it's
+// hot, it's recompiled to carry on through the not-taken side of that branch and the ones after it.
+// The taken sides become exits from the middle of the block, everything else stays in registers.
+static constexpr u32 SUPERBLOCK_HOT_COUNT = 1024;
+static constexpr u32 SUPERBLOCK_MAX_EXITS = 8;
+static constexpr u32 SUPERBLOCK_MAX_COUNTERS = 16384;
+
+alignas(64) static u32 s_superblockCounters[SUPERBLOCK_MAX_COUNTERS];
+static u32 s_superblockCountersUsed = 0;
+static std::unordered_map<u32, u32> s_superblockCounterSlots; // physical block start -> counter index
+static std::vector<u32> s_superblockFreeCounters; // counters of cleared blocks, reused before new ones
+static std::unordered_set<u32> s_superblockPCs; // physical start addresses of hot blocks
+static bool s_superblocksCompiled = false; // blocks can contain other blocks, see recClear()
+static bool s_nBlockSuper; // current block is being compiled as a superblock
+static bool s_nBlockSuperCandidate; // current block should count its runs
+static u32 s_superblockExits[SUPERBLOCK_MAX_EXITS]; // branches in the middle of the current block
+static u32 s_nSuperblockExits;
+
+// Gives the counter of a block which is being cleared back, so SMC doesn't use them all up.
+// Stale code from the old block can still decrement it, which at worst promotes a block early.
+static void recFreeSuperblockCounter(u32 startpc)
+{
+	const auto it = s_superblockCounterSlots.find(startpc);
+	if (it == s_superblockCounterSlots.end())
+		return;
+
+	s_superblockFreeCounters.push_back(it->second);
+	s_superblockCounterSlots.erase(it);
+}
 
 // save states for branches
 GPR_reg64 s_saveConstRegs[32];
@@ -389,6 +426,7 @@ void recCall(void (*func)())
 static void recRecompile(const u32 startpc);
 static void dyna_block_discard(u32 start, u32 sz);
 static void dyna_page_reset(u32 start, u32 sz);
+static void dyna_block_promote(u32 start);
 
 // Recompiled code buffer for EE recompiler dispatchers!
 alignas(__pagesize) static u8 eeRecDispatchers[__pagesize];
@@ -403,16 +441,30 @@ static DynGenFunc* EnterRecompiledCode = nullptr;
 static DynGenFunc* ExitRecompiledCode = nullptr;
 static DynGenFunc* DispatchBlockDiscard = nullptr;
 static DynGenFunc* DispatchPageReset = nullptr;
+static DynGenFunc* DispatchBlockPromote = nullptr;
+
+static void recWarmStartCompile();
 
 static void recEventTest()
 {
 	_cpuEventTest_Shared();
 
+	if (eeMemcheckFaultHit)
+	{
+		eeMemcheckFaultHit = false;
+		CBreakPoints::SetBreakpointTriggered(true);
+		VMManager::SetPaused(true);
+		recExitExecution();
+	}
+
 	if (eeRecExitRequested)
 	{
 		eeRecExitRequested = false;
 		recExitExecution();
 	}
+
+	if (g_FrameCount >= s_warmStartNextFrame && RecWarmStart::IsEnabled())
+		recWarmStartCompile();
 }
 
 // The address for all cleared blocks.  It recompiles the current pc and then
@@ -515,6 +567,14 @@ static DynGenFunc* _DynGen_DispatchPageReset()
 	return (DynGenFunc*)retval;
 }
 
+static DynGenFunc* _DynGen_DispatchBlockPromote()
+{
+	u8* retval = xGetPtr();
+	xFastCall((void*)dyna_block_promote);
+	xJMP((void*)ExitRecompiledCode);
+	return (DynGenFunc*)retval;
+}
+
 static void _DynGen_Dispatchers()
 {
 	// In case init gets called multiple times:
@@ -535,6 +595,7 @@ static void _DynGen_Dispatchers()
 	EnterRecompiledCode = _DynGen_EnterRecompiledCode();
 	DispatchBlockDiscard = _DynGen_DispatchBlockDiscard();
 	DispatchPageReset = _DynGen_DispatchPageReset();
+	DispatchBlockPromote = _DynGen_DispatchBlockPromote();
 	
 	HostSys::MemProtectStatic(eeRecDispatchers, PageAccess_ExecOnly());
 
@@ -672,6 +733,12 @@ static void recResetRaw()
 
 	g_branch = 0;
 	g_resetEeScalingStats = true;
+	s_warmStartNextFrame = 0;
+	s_superblockCountersUsed = 0;
+	s_superblockCounterSlots.clear();
+	s_superblockFreeCounters.clear();
+	s_superblockPCs.clear();
+	s_superblocksCompiled = false;
 	eeRecIsReset = true;
 }
 
@@ -800,6 +867,22 @@ void recClear(u32 addr, u32 size)
 	if (blockidx == -1)
 		return;
 
+	// Normally blocks which start earlier also end earlier, so the search below stops at the first
+	// block which ends before the range. A superblock can carry on past blocks which start inside
+	// it though, so pull the range back over any block in the same page which still reaches into it.
+	if (s_superblocksCompiled)
+	{
+		const u32 end = addr + size * 4;
+		const u32 page = addr & ~0xfffu;
+		BASEBLOCKEX* pexblock;
+		for (int i = blockidx; (pexblock = recBlocks[i]) && pexblock->startpc >= page; i--)
+		{
+			if (pexblock->startpc < addr && (pexblock->startpc + pexblock->size * 4) > addr)
+				addr = pexblock->startpc;
+		}
+		size = (end - addr) / 4;
+	}
+
 	u32 lowerextent = (u32)-1, upperextent = 0, ceiling = (u32)-1;
 
 	BASEBLOCKEX* pexblock = recBlocks[blockidx + 1];
@@ -835,6 +918,7 @@ void recClear(u32 addr, u32 size)
 		// This might end up inside a block that doesn't contain the clearing range,
 		// so set it to recompile now.  This will become JITCompile if we clear it.
 		pblock->SetFnptr((uptr)JITCompileInBlock);
+		recFreeSuperblockCounter(blockstart);
 
 		blockidx--;
 	}
@@ -952,6 +1036,33 @@ void SetBranchImm(u32 imm)
 	iBranchTest(imm);
 }
 
+static bool recIsSuperblockExit(u32 branchpc)
+{
+	for (u32 i = 0; i < s_nSuperblockExits; i++)
+	{
+		if (s_superblockExits[i] == branchpc)
+			return true;
+	}
+
+	return false;
+}
+
+void SetBranchImmOrContinue(u32 imm)
+{
+	// pc is past the delay slot here, so the branch is two instructions back.
+	if (imm != pc || pc >= s_nEndBlock || !recIsSuperblockExit(pc - 8))
+	{
+		SetBranchImm(imm);
+		return;
+	}
+
+	// Carry on with the next instruction, the branch state (register allocation, constants)
+	// is already what it is on the not-taken side. Likely branches skip the delay slot here,
+	// so resync the instruction info rather than relying on the last one compiled.
+	g_branch = 0;
+	g_pCurInstInfo = s_pInstCache + (pc - s_nStartBlock) / 4;
+}
+
 u8* recBeginThunk()
 {
 	// if recPtr reached the mem limit reset whole mem
@@ -1242,6 +1353,7 @@ void SaveBranchState()
 	s_saveFlushedConstReg = g_cpuFlushedConstReg;
 	s_psaveInstInfo = g_pCurInstInfo;
 
+	memcpy(s_saveX86regs, x86regs, sizeof(x86regs));
 	memcpy(s_saveXMMregs, xmmregs, sizeof(xmmregs));
 }
 
@@ -1254,6 +1366,7 @@ void LoadBranchState()
 	g_cpuFlushedConstReg = s_saveFlushedConstReg;
 	g_pCurInstInfo = s_psaveInstInfo;
 
+	memcpy(x86regs, s_saveX86regs, sizeof(x86regs));
 	memcpy(xmmregs, s_saveXMMregs, sizeof(xmmregs));
 }
 
@@ -1614,6 +1727,37 @@ void dynarecMemLogcheck(u32 start, bool store)
 		DevCon.WriteLn("Hit load breakpoint @0x%x", start);
 }
 
+// Called from the page fault handler when a fastmem access faults while there are memchecks.
+// The access is backpatched to the slow path, and the block it's in will get the usual checks
+// when it's recompiled, so only this one access needs checking here. We can't
+// jump out of the block from a fault, so breaks are raised at the end of the block instead.
+void vtlb_DynMemcheckFault(u32 guest_pc, u32 guest_addr, u32 size_in_bits, bool is_store)
+{
+	const u32 start = standardizeBreakpointAddress(guest_addr);
+	const u32 end = start + size_in_bits / 8;
+
+	for (const MemCheck& check : CBreakPoints::GetMemChecks(BREAKPOINT_EE))
+	{
+		if (check.result == 0)
+			continue;
+		if ((check.cond & MEMCHECK_WRITE) == 0 && is_store)
+			continue;
+		if ((check.cond & MEMCHECK_READ) == 0 && !is_store)
+			continue;
+		if (start >= standardizeBreakpointAddress(check.end) || standardizeBreakpointAddress(check.start) >= end)
+			continue;
+
+		if (check.result & MEMCHECK_LOG)
+			dynarecMemLogcheck(start, is_store);
+		if ((check.result & MEMCHECK_BREAK) && CBreakPoints::CheckSkipFirst(BREAKPOINT_EE, guest_pc) == 0)
+		{
+			eeMemcheckFaultHit = true;
+			if (!eeEventTestIsActive)
+				cpuRegs.nextEventCycle = 0;
+		}
+	}
+}
+
 void recMemcheck(u32 op, u32 bits, bool store)
 {
 	iFlushCall(FLUSH_EVERYTHING | FLUSH_PC);
@@ -1634,15 +1778,28 @@ void recMemcheck(u32 op, u32 bits, bool store)
 	// edx = access address+size
 
 	auto checks = CBreakPoints::GetMemChecks(BREAKPOINT_EE);
-	for (size_t i = 0; i < checks.size(); i++)
+	checks.erase(std::remove_if(checks.begin(), checks.end(), [store](const MemCheck& check) {
+		return (check.result == 0 || ((check.cond & MEMCHECK_WRITE) == 0 && store) ||
+				((check.cond & MEMCHECK_READ) == 0 && !store));
+	}), checks.end());
+	if (checks.empty())
+		return;
+
+	// Most accesses miss every check, so test against the bounds of all of them first.
+	u32 lowest_start = 0xFFFFFFFFu, highest_end = 0;
+	for (const MemCheck& check : checks)
 	{
-		if (checks[i].result == 0)
-			continue;
-		if ((checks[i].cond & MEMCHECK_WRITE) == 0 && store)
-			continue;
-		if ((checks[i].cond & MEMCHECK_READ) == 0 && !store)
-			continue;
+		lowest_start = std::min(lowest_start, standardizeBreakpointAddress(check.start));
+		highest_end = std::max(highest_end, standardizeBreakpointAddress(check.end));
+	}
+
+	xCMP(ecx, highest_end);
+	xForwardJAE32 skip_all_high;
+	xCMP(edx, lowest_start);
+	xForwardJBE32 skip_all_low;
 
+	for (size_t i = 0; i < checks.size(); i++)
+	{
 		// logic: memAddress < bpEnd && bpStart < memAddress+memSize
 
 		xMOV(eax, standardizeBreakpointAddress(checks[i].end));
@@ -1667,6 +1824,9 @@ void recMemcheck(u32 op, u32 bits, bool store)
 		next1.SetTarget();
 		next2.SetTarget();
 	}
+
+	skip_all_high.SetTarget();
+	skip_all_low.SetTarget();
 }
 
 void encodeBreakpoint()
@@ -1685,6 +1845,17 @@ void encodeMemcheck()
 		return;
 
 	u32 op = memRead32(needed == 2 ? pc + 4 : pc);
+
+	// With fastmem, the pages backing each memcheck are unmapped from the fastmem area, so an
+	// access can only hit one if it has faulted before (and now uses the slow path), or if it
+	// doesn't go through fastmem because the address is constant (a link in the branch before a
+	// delay slot access can make $ra constant after we've looked). Load/stores are tracked by
+	// the pc at the time they're compiled, which is one past the access, so pc + 8 in a delay slot.
+	const u32 rs = (op >> 21) & 0x1F;
+	const u32 access_pc = (needed == 2) ? (pc + 8) : (pc + 4);
+	if (CHECK_FASTMEM && !vtlb_IsFaultingPC(access_pc) && !GPR_IS_CONST1(rs) && !(needed == 2 && rs == 31))
+		return;
+
 	const OPCODE& opcode = GetInstruction(op);
 
 	bool store = (opcode.flags & IS_STORE) != 0;
@@ -2067,6 +2238,123 @@ void dyna_page_reset(u32 start, u32 sz)
 	mmap_MarkCountedRamPage(start);
 }
 
+// Called when a superblock candidate has run SUPERBLOCK_HOT_COUNT times. The block is thrown
+// away, and recompiled as a superblock when execution resumes at its start.
+void dyna_block_promote(u32 start)
+{
+	eeRecPerfLog.Write("Promoting block @ 0x%08X to a superblock", start);
+	s_superblockPCs.insert(HWADDR(start));
+	recClear(start, 1);
+}
+
+// Counts runs of a block which can be turned into a superblock, see dyna_block_promote().
+static void recEmitSuperblockCounter(u32 startpc)
+{
+	u32 slot;
+	if (const auto it = s_superblockCounterSlots.find(HWADDR(startpc)); it != s_superblockCounterSlots.end())
+	{
+		slot = it->second;
+	}
+	else if (!s_superblockFreeCounters.empty())
+	{
+		slot = s_superblockFreeCounters.back();
+		s_superblockFreeCounters.pop_back();
+	}
+	else if (s_superblockCountersUsed < SUPERBLOCK_MAX_COUNTERS)
+	{
+		slot = s_superblockCountersUsed++;
+	}
+	else
+	{
+		return;
+	}
+
+	s_superblockCounterSlots[HWADDR(startpc)] = slot;
+	u32* counter = &s_superblockCounters[slot];
+	*counter = SUPERBLOCK_HOT_COUNT;
+
+	xSUB(ptr32[counter], 1);
+	xForwardJNZ8 skip;
+	xMOV(arg1regd, startpc);
+	xJMP((void*)DispatchBlockPromote);
+	skip.SetTarget();
+}
+
+static bool recIsCOP2Instruction(u32 code)
+{
+	const u32 op = code >> 26;
+	return (op == 022 || op == 066 || op == 076); // COP2, LQC2, SQC2
+}
+
+static bool recIsBranchInstruction(u32 code)
+{
+	const u32 op = code >> 26;
+	const u32 rs = (code >> 21) & 0x1f;
+	const u32 rt = (code >> 16) & 0x1f;
+	const u32 funct = code & 0x3f;
+	switch (op)
+	{
+		case 0: // JR, JALR
+			return (funct == 8 || funct == 9);
+		case 1: // REGIMM branches
+			return (rt < 4 || (rt >= 16 && rt < 20));
+		case 16: // BC0x, BC1x, BC2x
+		case 17:
+		case 18:
+			return (rs == 8);
+		case 2: // J, JAL, branches
+		case 3:
+		case 4:
+		case 5:
+		case 6:
+		case 7:
+		case 20:
+		case 21:
+		case 22:
+		case 23:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Called by the block scan at a conditional branch with a delay slot. Returns true if the block
+// should carry on through the not-taken side of it, rather than ending after the delay slot.
+static bool recExtendSuperblock(u32 branchpc, bool has_cop2)
+{
+	// COP2 is left alone, the flag analysis passes don't know about exits. Blocks don't cross pages.
+	const u32 next = branchpc + 8;
+	const u32 delay = *(u32*)PSM(branchpc + 4);
+	if (has_cop2 || (next & 0xffc) == 0 || recIsCOP2Instruction(delay) || recIsBranchInstruction(delay))
+		return false;
+
+	if (!s_nBlockSuper)
+	{
+		s_nBlockSuperCandidate = CHECK_EESUPERBLOCKS && HWADDR(s_nStartBlock) < Ps2MemSize::MainRam;
+		return false;
+	}
+
+	if (s_nSuperblockExits == SUPERBLOCK_MAX_EXITS)
+		return false;
+
+	s_superblockExits[s_nSuperblockExits++] = branchpc;
+	return true;
+}
+
+// The taken side of a branch in the middle of a superblock leaves it, so everything has to be
+// treated as live there, the same as at the end of a block (see _recClearInst()).
+static void recSetSuperblockExitLive(EEINST* pinst)
+{
+	for (u8& reg : pinst->regs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->fpuregs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->vfregs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->viregs)
+		reg |= EEINST_LIVE;
+}
+
 static void memory_protect_recompiled_code(u32 startpc, u32 size)
 {
 	u32 inpage_ptr = HWADDR(startpc);
@@ -2296,8 +2584,13 @@ static void recRecompile(const u32 startpc)
 
 	// go until the next branch
 	i = startpc;
+	s_nStartBlock = startpc;
 	s_nEndBlock = 0xffffffff;
 	s_branchTo = -1;
+	s_nBlockSuper = CHECK_EESUPERBLOCKS && s_superblockPCs.find(HWADDR(startpc)) != s_superblockPCs.end();
+	s_nBlockSuperCandidate = false;
+	s_nSuperblockExits = 0;
+	bool scan_cop2 = false;
 
 	// compile breakpoints as individual blocks
 	int n1 = isBreakpointNeeded(i);
@@ -2324,7 +2617,8 @@ static void recRecompile(const u32 startpc)
 				break;
 			}
 
-			if (pblock->GetFnptr() != (uptr)JITCompile && pblock->GetFnptr() != (uptr)JITCompileInBlock)
+			// Superblocks run on over blocks which follow their exits, recClear() copes with that.
+			if (s_nSuperblockExits == 0 && pblock->GetFnptr() != (uptr)JITCompile && pblock->GetFnptr() != (uptr)JITCompileInBlock)
 			{
 				willbranch3 = 1;
 				s_nEndBlock = i;
@@ -2342,6 +2636,17 @@ static void recRecompile(const u32 startpc)
 		//HUH ? PSM ? whut ? THIS IS VIRTUAL ACCESS GOD DAMMIT
 		cpuRegs.code = *(int*)PSM(i);
 
+		if (recIsCOP2Instruction(cpuRegs.code))
+		{
+			// COP2 can't follow an exit, so a superblock ends before it.
+			if (s_nSuperblockExits > 0)
+			{
+				s_nEndBlock = i;
+				break;
+			}
+			scan_cop2 = true;
+		}
+
 		switch (cpuRegs.code >> 26)
 		{
 			case 0: // special
@@ -2363,8 +2668,13 @@ static void recRecompile(const u32 startpc)
 				{
 					// branches
 					s_branchTo = _Imm_ * 4 + i + 4;
-					if (s_branchTo > startpc && s_branchTo < i)
+					if (s_branchTo > startpc && s_branchTo < i && s_nSuperblockExits == 0)
 						s_nEndBlock = s_branchTo;
+					else if (recExtendSuperblock(i, scan_cop2))
+					{
+						i += 8;
+						continue;
+					}
 					else
 						s_nEndBlock = i + 8;
 
@@ -2388,8 +2698,13 @@ static void recRecompile(const u32 startpc)
 			case 22:
 			case 23:
 				s_branchTo = _Imm_ * 4 + i + 4;
-				if (s_branchTo > startpc && s_branchTo < i)
+				if (s_branchTo > startpc && s_branchTo < i && s_nSuperblockExits == 0)
 					s_nEndBlock = s_branchTo;
+				else if (recExtendSuperblock(i, scan_cop2))
+				{
+					i += 8;
+					continue;
+				}
 				else
 					s_nEndBlock = i + 8;
 
@@ -2429,6 +2744,12 @@ static void recRecompile(const u32 startpc)
 
 StartRecomp:
 
+	if (s_nSuperblockExits > 0)
+	{
+		eeRecPerfLog.Write("Superblock @ %08X : size=%d insts, %u exits", startpc, (s_nEndBlock - startpc) / 4, s_nSuperblockExits);
+		s_superblocksCompiled = true;
+	}
+
 	// The idea here is that as long as a loop doesn't write to a register it's already read
 	// (excepting registers initialised with constants or memory loads) or use any instructions
 	// which alter the machine state apart from registers, it will do the same thing on every
@@ -2537,6 +2858,8 @@ StartRecomp:
 		for (i = s_nEndBlock; i > startpc; i -= 4)
 		{
 			cpuRegs.code = *(int*)PSM(i - 4);
+			if (s_nSuperblockExits > 0 && (recIsSuperblockExit(i - 8) || recIsSuperblockExit(i - 4)))
+				recSetSuperblockExitLive(pcur);
 			pcur[-1] = pcur[0];
 			recBackpropBSC(cpuRegs.code, pcur - 1, pcur);
 			pcur--;
@@ -2582,6 +2905,9 @@ StartRecomp:
 
 	if (doRecompilation)
 	{
+		if (s_nBlockSuperCandidate && !has_cop2_instructions)
+			recEmitSuperblockCounter(startpc);
+
 		// Finally: Generate x86 recompiled code!
 		g_pCurInstInfo = s_pInstCache;
 		while (!g_branch && pc < s_nEndBlock)
@@ -2634,7 +2960,12 @@ StartRecomp:
 			if (oldBlock->startpc >= HWADDR(pc))
 				continue;
 			if ((oldBlock->startpc + oldBlock->size * 4) <= HWADDR(startpc))
+			{
+				// A superblock further back could still overlap, see recClear().
+				if (s_superblocksCompiled && oldBlock->startpc >= (HWADDR(startpc) & ~0xfffu))
+					continue;
 				break;
+			}
 
 			if (memcmp(&recRAMCopy[oldBlock->startpc / 4], PSM(oldBlock->startpc),
 					oldBlock->size * 4))
@@ -2716,10 +3047,86 @@ StartRecomp:
 
 	pxAssert((g_cpuHasConstReg & g_cpuFlushedConstReg) == g_cpuHasConstReg);
 
+	// Only game code is worth remembering, the BIOS is done with by the time it's warmed up.
+	// Blocks which cross a page can't be hashed in one go, since the next page may be mapped elsewhere.
+	if (RecWarmStart::IsEnabled() && !g_GameLoading && s_nSuperblockExits == 0 && HWADDR(startpc) < Ps2MemSize::MainRam &&
+		((startpc & 0xfff) + s_pCurBlockEx->size * 4u) <= 0x1000)
+	{
+		RecWarmStart::RecordEEBlock(startpc, s_pCurBlockEx->size,
+			RecWarmStart::HashCode(PSM(startpc), s_pCurBlockEx->size * 4u));
+	}
+
 	s_pCurBlock = NULL;
 	s_pCurBlockEx = NULL;
 }
 
+// Compiles blocks from the warm start profile between frames, a little at a time, so the game
+// doesn't stall on them later. A block is only compiled once the code at its address hashes the
+// same as when it was recorded, anything which isn't loaded yet is retried on later frames.
+static void recWarmStartCompile()
+{
+	// Scanning the profile isn't free, so give up for a while when there's nothing to do.
+	static constexpr uint IDLE_FRAMES = 60;
+	static size_t pos = 0;
+
+	s_warmStartNextFrame = g_FrameCount + 1;
+
+	std::vector<RecWarmStart::EEBlock>& pending = RecWarmStart::GetPendingEEBlocks();
+	if (pending.empty() || g_GameLoading || CHECK_FULLTLB || eeRecNeedsReset)
+		return;
+
+	// Leave room for the blocks the game actually needs, rather than filling the cache and resetting.
+	const u8* limit = recMem->GetPtr() + recMem->GetSize() / 2;
+	if (recPtr >= limit)
+		return;
+
+	const Common::Timer::Value end_time = Common::Timer::GetCurrentValue() + Common::Timer::ConvertMillisecondsToValue(1.0);
+	const u32 saved_code = cpuRegs.code;
+	bool compiled = false;
+
+	for (size_t count = pending.size(); count > 0 && !pending.empty(); count--)
+	{
+		if (Common::Timer::GetCurrentValue() >= end_time)
+			break;
+
+		if (pos >= pending.size())
+			pos = 0;
+
+		const RecWarmStart::EEBlock block = pending[pos];
+		const bool valid = (block.size > 0 && ((block.pc & 0xfff) + block.size * 4u) <= 0x1000);
+		const void* code = (valid && recLUT[block.pc >> 16]) ? PSM(block.pc) : nullptr;
+		if (valid && !code)
+		{
+			pos++;
+			continue;
+		}
+
+		const uptr fnptr = valid ? PC_GETBLOCK(block.pc)->GetFnptr() : 0;
+		const bool needs_compile = (fnptr == (uptr)JITCompile || fnptr == (uptr)JITCompileInBlock);
+		if (needs_compile && RecWarmStart::HashCode(code, block.size * 4u) != block.hash)
+		{
+			pos++;
+			continue;
+		}
+
+		pending[pos] = pending.back();
+		pending.pop_back();
+
+		if (needs_compile)
+		{
+			recRecompile(block.pc);
+			compiled = true;
+			if (recPtr >= limit || eeRecNeedsReset)
+				break;
+		}
+	}
+
+	cpuRegs.code = saved_code;
+
+	if (!compiled)
+		s_warmStartNextFrame = g_FrameCount + IDLE_FRAMES;
+}
+
 void recRegisterExceptionInformation()
 {
 	const void* const rip = xGetPtr();
@@ -141,7 +141,7 @@ static void recBEQ_const()
 		branchTo = pc + 4;
 
 	recompileNextInstruction(true, false);
-	SetBranchImm(branchTo);
+	SetBranchImmOrContinue(branchTo);
 }
 
 static void recBEQ_process(int process)
@@ -151,7 +151,7 @@ static void recBEQ_process(int process)
 	if (_Rs_ == _Rt_)
 	{
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 	}
 	else
 	{
@@ -177,7 +177,7 @@ static void recBEQ_process(int process)
 			recompileNextInstruction(true, false);
 		}
 
-		SetBranchImm(pc);
+		SetBranchImmOrContinue(pc);
 	}
 }
 
@@ -205,7 +205,7 @@ static void recBNE_const()
 		branchTo = pc + 4;
 
 	recompileNextInstruction(true, false);
-	SetBranchImm(branchTo);
+	SetBranchImmOrContinue(branchTo);
 }
 
 static void recBNE_process(int process)
@@ -215,7 +215,7 @@ static void recBNE_process(int process)
 	if (_Rs_ == _Rt_)
 	{
 		recompileNextInstruction(true, false);
-		SetBranchImm(pc);
+		SetBranchImmOrContinue(pc);
 		return;
 	}
 
@@ -241,7 +241,7 @@ static void recBNE_process(int process)
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 void recBNE()
@@ -283,7 +283,7 @@ static void recBEQL_process(int process)
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 void recBEQL()
@@ -317,17 +317,17 @@ static void recBNEL_process(int process)
 {
 	u32 branchTo = ((s32)_Imm_ * 4) + pc;
 
-	recSetBranchEQ(0, process);
+	// Taken side first, so the not-taken side can carry on in a superblock.
+	recSetBranchEQ(1, process);
 
 	SaveBranchState();
-	SetBranchImm(pc + 4);
+	recompileNextInstruction(true, false);
+	SetBranchImm(branchTo);
 
 	x86SetJ32(j32Ptr[0]);
 
-	// recopy the next inst
 	LoadBranchState();
-	recompileNextInstruction(true, false);
-	SetBranchImm(branchTo);
+	SetBranchImmOrContinue(pc);
 }
 
 void recBNEL()
@@ -379,7 +379,7 @@ void recBLTZAL()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -405,7 +405,7 @@ void recBLTZAL()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -428,7 +428,7 @@ void recBGEZAL()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -454,7 +454,7 @@ void recBGEZAL()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -492,7 +492,7 @@ void recBLTZALL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -530,7 +530,7 @@ void recBGEZALL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 
@@ -547,7 +547,7 @@ void recBLEZ()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -580,7 +580,7 @@ void recBLEZ()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 //// BGTZ
@@ -596,7 +596,7 @@ void recBGTZ()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -629,7 +629,7 @@ void recBGTZ()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -645,7 +645,7 @@ void recBLTZ()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -671,7 +671,7 @@ void recBLTZ()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -687,7 +687,7 @@ void recBGEZ()
 			branchTo = pc + 4;
 
 		recompileNextInstruction(true, false);
-		SetBranchImm(branchTo);
+		SetBranchImmOrContinue(branchTo);
 		return;
 	}
 
@@ -714,7 +714,7 @@ void recBGEZ()
 		recompileNextInstruction(true, false);
 	}
 
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -746,7 +746,7 @@ void recBLTZL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 
@@ -779,7 +779,7 @@ void recBGEZL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 
@@ -825,7 +825,7 @@ void recBLEZL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 ////////////////////////////////////////////////////
@@ -865,7 +865,7 @@ void recBGTZL()
 	x86SetJ32(j32Ptr[0]);
 
 	LoadBranchState();
-	SetBranchImm(pc);
+	SetBranchImmOrContinue(pc);
 }
 
 #endif
@@ -17,6 +17,7 @@
 #include "PrecompiledHeader.h"
 
 #include "Common.h"
+#include "Cache.h"
 #include "vtlb.h"
 
 #include "iCore.h"
@@ -137,35 +138,30 @@ namespace vtlb_private
 	// Prepares eax, ecx, and, ebx for Direct or Indirect operations.
 	// Returns the writeback pointer for ebx (return address from indirect handling)
 	//
-	static void DynGen_PrepRegs(int addr_reg, int value_reg, u32 sz, bool xmm, bool write)
+	static void DynGen_PrepValue(int value_reg, u32 sz, bool xmm)
 	{
-		EE::Profiler.EmitMem();
-
-		_freeX86reg(arg1regd);
-		xMOV(arg1regd, xRegister32(addr_reg));
-
-		if (value_reg >= 0)
+		if (sz == 128)
 		{
-			if (sz == 128)
-			{
-				pxAssert(xmm);
-				_freeXMMreg(xRegisterSSE::GetArgRegister(1, 0).GetId());
-				xMOVAPS(xRegisterSSE::GetArgRegister(1, 0), xRegisterSSE::GetInstance(value_reg));
-			}
-			else if (xmm)
-			{
-				// 32bit xmms are passed in GPRs
-				pxAssert(sz == 32);
-				_freeX86reg(arg2regd);
-				xMOVD(arg2regd, xRegisterSSE(value_reg));
-			}
-			else
-			{
-				_freeX86reg(arg2regd);
-				xMOV(arg2reg, xRegister64(value_reg));
-			}
+			pxAssert(xmm);
+			_freeXMMreg(xRegisterSSE::GetArgRegister(1, 0).GetId());
+			xMOVAPS(xRegisterSSE::GetArgRegister(1, 0), xRegisterSSE::GetInstance(value_reg));
+		}
+		else if (xmm)
+		{
+			// 32bit xmms are passed in GPRs
+			pxAssert(sz == 32);
+			_freeX86reg(arg2regd);
+			xMOVD(arg2regd, xRegisterSSE(value_reg));
 		}
+		else
+		{
+			_freeX86reg(arg2regd);
+			xMOV(arg2reg, xRegister64(value_reg));
+		}
+	}
 
+	static void DynGen_PrepLookup(bool write)
+	{
 		VTLBVirtual* vmap = (CHECK_FULLTLB && write) ? vtlbdata.vmap_write : vtlbdata.vmap;
 
 		xMOV(eax, arg1regd);
@@ -174,6 +170,33 @@ namespace vtlb_private
 		xADD(arg1reg, rax);
 	}
 
+	static void DynGen_PrepRegs(int addr_reg, int value_reg, u32 sz, bool xmm, bool write)
+	{
+		EE::Profiler.EmitMem();
+
+		_freeX86reg(arg1regd);
+		xMOV(arg1regd, xRegister32(addr_reg));
+
+		if (value_reg >= 0)
+			DynGen_PrepValue(value_reg, sz, xmm);
+
+		DynGen_PrepLookup(write);
+	}
+
+	// ------------------------------------------------------------------------
+	// Same as DynGen_PrepRegs, for a constant address. The value is moved first, since
+	// it may live in arg1reg.
+	static void DynGen_PrepRegs_Const(u32 addr_const, int value_reg, u32 sz, bool xmm, bool write)
+	{
+		if (value_reg >= 0)
+			DynGen_PrepValue(value_reg, sz, xmm);
+
+		_freeX86reg(arg1regd);
+		xMOV(arg1regd, addr_const);
+
+		DynGen_PrepLookup(write);
+	}
+
 	// ------------------------------------------------------------------------
 	static void DynGen_DirectRead(u32 bits, bool sign)
 	{
@@ -270,6 +293,153 @@ static u8* GetIndirectDispatcherPtr(int mode, int operandsize, int sign = 0)
 	return &m_IndirectDispatchers[(mode * (8 * A)) + (sign * 5 * A) + (operandsize * A)];
 }
 
+// ------------------------------------------------------------------------
+// Sign or zero extends a value returned from a C++ read function in rax, the same way
+// DynGen_DirectRead does.
+static void DynGen_ExtendReadResult(int bits, bool sign)
+{
+	switch (bits)
+	{
+		case 8:
+			if (sign)
+				xMOVSX(rax, al);
+			else
+				xMOVZX(rax, al);
+			break;
+
+		case 16:
+			if (sign)
+				xMOVSX(rax, ax);
+			else
+				xMOVZX(rax, ax);
+			break;
+
+		case 32:
+			if (sign)
+				xCDQE();
+			break;
+	}
+}
+
+static void* GetCacheAccessFunction(int mode, int bits)
+{
+	switch (bits)
+	{
+		case   8: return mode ? (void*)writeCacheHost8 : (void*)readCacheHost8;
+		case  16: return mode ? (void*)writeCacheHost16 : (void*)readCacheHost16;
+		case  32: return mode ? (void*)writeCacheHost32 : (void*)readCacheHost32;
+		case  64: return mode ? (void*)writeCacheHost64 : (void*)readCacheHost64;
+		case 128: return mode ? (void*)writeCacheHost128 : (void*)readCacheHost128;
+		jNO_DEFAULT;
+	}
+
+	return nullptr;
+}
+
+static void* GetMemAccessFunction(int mode, int bits)
+{
+	switch (bits)
+	{
+		case   8: return mode ? (void*)vtlb_memWrite<mem8_t> : (void*)vtlb_memRead<mem8_t>;
+		case  16: return mode ? (void*)vtlb_memWrite<mem16_t> : (void*)vtlb_memRead<mem16_t>;
+		case  32: return mode ? (void*)vtlb_memWrite<mem32_t> : (void*)vtlb_memRead<mem32_t>;
+		case  64: return mode ? (void*)vtlb_memWrite<mem64_t> : (void*)vtlb_memRead<mem64_t>;
+		case 128: return mode ? (void*)vtlb_memWrite128 : (void*)vtlb_memRead128;
+		jNO_DEFAULT;
+	}
+
+	return nullptr;
+}
+
+// ------------------------------------------------------------------------
+// Generates the EE data cache check for a direct access, when cache emulation is enabled.
+// In: arg1reg: host pointer, rax: vtlb entry, arg2reg/xmm arg 1: value (if writing)
+//
+// Hits point arg1reg at the cached copy of the line and fall into the direct access, misses
+// fill the line through readCacheHost/writeCacheHost. Pages which are only partly covered
+// by a cached TLB entry take the full C++ path, which does the exact check.
+template <typename GenDirectFn>
+static void DynGen_CacheTest(const GenDirectFn& gen_direct, int mode, int bits, bool sign)
+{
+	const xRegister32 arg3regd(arg3reg.GetId());
+
+	xTEST(ptr8[reinterpret_cast<u8*>(&cpuRegs.CP0.n.Config) + 2], 0x1);
+	xForwardJZ32 cache_disabled;
+
+	// The low bits of the vtlb entry are the negated page address, so this recovers the vaddr.
+	xMOV(arg3regd, arg1regd);
+	xSUB(arg3regd, eax);
+	xMOV(eax, arg3regd);
+	xSHR(eax, VTLB_PAGE_BITS);
+	xMOVZX(eax, ptr8[xComplexAddress(arg4reg, cachePageModes, rax)]);
+	xCMP(eax, CACHE_PAGE_CACHED);
+	xForwardJB32 uncached;
+	xForwardJA32 partial;
+
+	// Set for the line, tags are (host address | flags).
+	xMOV(eax, arg1regd);
+	xAND(eax, 0x3F * CACHE_LINE_SIZE);
+	xLEA(rax, ptr[rax * 2 + rax]);
+	static_assert(CACHE_SET_SIZE == 3 * CACHE_LINE_SIZE);
+	xLoadFarAddr(arg3reg, getCacheSets());
+	xADD(rax, arg3reg);
+
+	xMOV(arg3reg, arg1reg);
+	xAND(arg3reg, ~static_cast<s32>(CACHE_TAG_FLAGS));
+	xOR(arg3reg, CACHE_TAG_VALID);
+
+	xMOV(arg4reg, ptr64[rax]);
+	xAND(arg4reg, ~static_cast<s32>(CACHE_TAG_FLAGS & ~CACHE_TAG_VALID));
+	xCMP(arg4reg, arg3reg);
+	xForwardJNE8 not_way0;
+	if (mode)
+		xOR(ptr64[rax], CACHE_TAG_DIRTY);
+	xADD(rax, CACHE_SET_DATA_OFFSET);
+	xForwardJump8 way0_hit;
+
+	not_way0.SetTarget();
+	xMOV(arg4reg, ptr64[rax + sizeof(uptr)]);
+	xAND(arg4reg, ~static_cast<s32>(CACHE_TAG_FLAGS & ~CACHE_TAG_VALID));
+	xCMP(arg4reg, arg3reg);
+	xForwardJNE8 miss;
+	if (mode)
+		xOR(ptr64[rax + sizeof(uptr)], CACHE_TAG_DIRTY);
+	xADD(rax, CACHE_SET_DATA_OFFSET + CACHE_LINE_SIZE);
+
+	// Hit, rax is the line.
+	way0_hit.SetTarget();
+	xAND(arg1regd, CACHE_LINE_SIZE - 1);
+	xADD(arg1reg, rax);
+	xForwardJump32 hit;
+
+	miss.SetTarget();
+	if (mode && bits < 128)
+		xFastCall(GetCacheAccessFunction(mode, bits), arg1reg, arg2reg);
+	else
+		xFastCall(GetCacheAccessFunction(mode, bits), arg1reg);
+	if (!mode)
+		DynGen_ExtendReadResult(bits, sign);
+	xForwardJump32 miss_done;
+
+	partial.SetTarget();
+	xMOV(arg1regd, arg3regd);
+	if (mode && bits < 128)
+		xFastCall(GetMemAccessFunction(mode, bits), arg1reg, arg2reg);
+	else
+		xFastCall(GetMemAccessFunction(mode, bits), arg1reg);
+	if (!mode)
+		DynGen_ExtendReadResult(bits, sign);
+	xForwardJump32 partial_done;
+
+	cache_disabled.SetTarget();
+	uncached.SetTarget();
+	hit.SetTarget();
+	gen_direct();
+
+	miss_done.SetTarget();
+	partial_done.SetTarget();
+}
+
 // ------------------------------------------------------------------------
 // Generates a JS instruction that targets the appropriate templated instance of
 // the vtlb Indirect Dispatcher.
@@ -288,6 +458,19 @@ static void DynGen_HandlerTest(const GenDirectFn& gen_direct, int mode, int bits
 		case 128: szidx = 4; break;
 		jNO_DEFAULT;
 	}
+
+	if (CHECK_CACHE)
+	{
+		xForwardJS32 to_handler;
+		DynGen_CacheTest(gen_direct, mode, bits, sign);
+		xForwardJump32 done;
+		to_handler.SetTarget();
+		xFastCall(GetIndirectDispatcherPtr(mode, szidx, sign));
+		recRegisterExceptionInformation();
+		done.SetTarget();
+		return;
+	}
+
 	xForwardJS8 to_handler;
 	gen_direct();
 	xForwardJump8 done;
@@ -414,35 +597,43 @@ void vtlb_dynarec_init()
 // Recompiled input registers:
 //   ecx - source address to read from
 //   Returns read value in eax.
+// Reads from the address prepared by DynGen_PrepRegs, through the handler test.
+static int DynGen_ReadNonQuadSlow(u32 bits, bool sign, bool xmm, vtlb_ReadRegAllocCallback dest_reg_alloc)
+{
+	DynGen_HandlerTest([bits, sign]() { DynGen_DirectRead(bits, sign); }, 0, bits, sign && bits < 64);
+
+	int x86_dest_reg;
+	if (!xmm)
+	{
+		x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeX86reg(eax), eax.GetId());
+		xMOV(xRegister64(x86_dest_reg), rax);
+	}
+	else
+	{
+		// we shouldn't be loading any FPRs which aren't 32bit..
+		// we use MOVD here despite it being floating-point data, because we're going int->float reinterpret.
+		pxAssert(bits == 32);
+		x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
+		xMOVDZX(xRegisterSSE(x86_dest_reg), eax);
+	}
+
+	return x86_dest_reg;
+}
+
 int vtlb_DynGenReadNonQuad(u32 bits, bool sign, bool xmm, int addr_reg, vtlb_ReadRegAllocCallback dest_reg_alloc)
 {
 	pxAssume(bits <= 64);
 
-	int x86_dest_reg;
 	if (!CHECK_FASTMEM || vtlb_IsFaultingPC(pc))
 	{
 		iFlushCall(FLUSH_FULLVTLB);
 
 		DynGen_PrepRegs(addr_reg, -1, bits, xmm, false);
-		DynGen_HandlerTest([bits, sign]() { DynGen_DirectRead(bits, sign); }, 0, bits, sign && bits < 64);
-
-		if (!xmm)
-		{
-			x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeX86reg(eax), eax.GetId());
-			xMOV(xRegister64(x86_dest_reg), rax);
-		}
-		else
-		{
-			// we shouldn't be loading any FPRs which aren't 32bit..
-			// we use MOVD here despite it being floating-point data, because we're going int->float reinterpret.
-			pxAssert(bits == 32);
-			x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
-			xMOVDZX(xRegisterSSE(x86_dest_reg), eax);
-		}
-
-		return x86_dest_reg;
+		return DynGen_ReadNonQuadSlow(bits, sign, xmm, dest_reg_alloc);
 	}
 
+	int x86_dest_reg;
+
 	const u8* codeStart;
 	const xAddressReg x86addr(addr_reg);
 	if (!xmm)
@@ -503,7 +694,15 @@ int vtlb_DynGenReadNonQuad_Const(u32 bits, bool sign, bool xmm, u32 addr_const,
 
 	int x86_dest_reg;
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		// Whether the access goes through the data cache can change without a TLB write.
+		iFlushCall(FLUSH_FULLVTLB);
+
+		DynGen_PrepRegs_Const(addr_const, -1, bits, xmm, false);
+		x86_dest_reg = DynGen_ReadNonQuadSlow(bits, sign, xmm, dest_reg_alloc);
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		auto ppf = vmv.assumePtr(addr_const);
 		if (!xmm)
@@ -603,6 +802,18 @@ int vtlb_DynGenReadNonQuad_Const(u32 bits, bool sign, bool xmm, u32 addr_const,
 	return x86_dest_reg;
 }
 
+// Reads from the address prepared by DynGen_PrepRegs, through the handler test.
+static int DynGen_ReadQuadSlow(u32 bits, vtlb_ReadRegAllocCallback dest_reg_alloc)
+{
+	DynGen_HandlerTest([bits]() {DynGen_DirectRead(bits, false); },  0, bits);
+
+	const int reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0); // Handler returns in xmm0
+	if (reg >= 0)
+		xMOVAPS(xRegisterSSE(reg), xmm0);
+
+	return reg;
+}
+
 int vtlb_DynGenReadQuad(u32 bits, int addr_reg, vtlb_ReadRegAllocCallback dest_reg_alloc)
 {
 	pxAssume(bits == 128);
@@ -612,13 +823,7 @@ int vtlb_DynGenReadQuad(u32 bits, int addr_reg, vtlb_ReadRegAllocCallback dest_r
 		iFlushCall(FLUSH_FULLVTLB);
 
 		DynGen_PrepRegs(arg1regd.GetId(), -1, bits, true, false);
-		DynGen_HandlerTest([bits]() {DynGen_DirectRead(bits, false); },  0, bits);
-
-		const int reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0); // Handler returns in xmm0
-		if (reg >= 0)
-			xMOVAPS(xRegisterSSE(reg), xmm0);
-
-		return reg;
+		return DynGen_ReadQuadSlow(bits, dest_reg_alloc);
 	}
 
 	const int reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0); // Handler returns in xmm0
@@ -650,7 +855,15 @@ int vtlb_DynGenReadQuad_Const(u32 bits, u32 addr_const, vtlb_ReadRegAllocCallbac
 
 	int reg;
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		// Whether the access goes through the data cache can change without a TLB write.
+		iFlushCall(FLUSH_FULLVTLB);
+
+		DynGen_PrepRegs_Const(addr_const, -1, bits, true, false);
+		reg = DynGen_ReadQuadSlow(bits, dest_reg_alloc);
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		void* ppf = reinterpret_cast<void*>(vmv.assumePtr(addr_const));
 		reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
@@ -854,7 +1067,15 @@ void vtlb_DynGenWrite_Const(u32 bits, bool xmm, u32 addr_const, int value_reg)
 #endif
 
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		// Whether the access goes through the data cache can change without a TLB write.
+		iFlushCall(FLUSH_FULLVTLB);
+
+		DynGen_PrepRegs_Const(addr_const, value_reg, bits, xmm, false);
+		DynGen_HandlerTest([bits]() { DynGen_DirectWrite(bits); }, 1, bits);
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		auto ppf = vmv.assumePtr(addr_const);
 		if (!xmm)
@@ -17,6 +17,7 @@
 
 #include "PrecompiledHeader.h"
 #include "microVU.h"
+#include "SubsystemProfiler.h"
 
 #include "common/AlignedMalloc.h"
 #include "common/Perf.h"
@@ -130,9 +131,15 @@ void mVUreset(microVU& mVU, bool resetReserve)
 	HostSys::MemProtect(mVU.dispCache, mVUdispCacheSize, PageAccess_ExecOnly());
 
 	if (mVU.index)
-		Perf::any.map((uptr)&mVU.dispCache, mVUdispCacheSize, "mVU1 Dispatcher");
+	{
+		Perf::vu1.reset();
+		Perf::any.map((uptr)mVU.dispCache, mVUdispCacheSize, "mVU1 Dispatcher");
+	}
 	else
-		Perf::any.map((uptr)&mVU.dispCache, mVUdispCacheSize, "mVU0 Dispatcher");
+	{
+		Perf::vu0.reset();
+		Perf::any.map((uptr)mVU.dispCache, mVUdispCacheSize, "mVU0 Dispatcher");
+	}
 }
 
 // Free Allocated Resources
@@ -193,6 +200,8 @@ __ri microProgram* mVUcreateProg(microVU& mVU, int startPC)
 	prog->idx = mVU.prog.total++;
 	prog->ranges = new std::deque<microRange>();
 	prog->startPC = startPC;
+	if (RecWarmStart::IsEnabled())
+		prog->hash = RecWarmStart::HashCode(mVU.regs().Micro, mVU.microMemSize);
 	if(doWholeProgCompare)
 		mVUcacheProg(mVU, *prog); // Cache Micro Program
 	double cacheSize = (double)((uptr)mVU.prog.x86end - (uptr)mVU.prog.x86start);
@@ -204,6 +213,29 @@ __ri microProgram* mVUcreateProg(microVU& mVU, int startPC)
 	return prog;
 }
 
+// Compiles the blocks the warm start profile has for the current program, while it's being created.
+// Micro memory hashing the same means they're the same blocks the program compiled last time.
+void mVUwarmStartProg(microVU& mVU)
+{
+	static_assert(sizeof(microRegInfo) == RecWarmStart::VU_STATE_SIZE);
+
+	const std::vector<RecWarmStart::VUBlock> blocks(RecWarmStart::GetVUBlocks(mVU.index, mVU.prog.cur->hash));
+	if (blocks.empty())
+		return;
+
+	// Stay well clear of the cache limit, mVUcleanUp() would throw everything away.
+	const u8* limit = mVU.prog.x86start + (mVU.prog.x86end - mVU.prog.x86start) / 2;
+	for (const RecWarmStart::VUBlock& block : blocks)
+	{
+		if (xGetPtr() >= limit)
+			break;
+
+		microRegInfo pState;
+		std::memcpy(&pState, block.state.data(), sizeof(pState));
+		mVUblockFetch(mVU, block.start_pc & (mVU.microMemSize - 8), (uptr)&pState);
+	}
+}
+
 // Caches Micro Program
 __ri void mVUcacheProg(microVU& mVU, microProgram& prog)
 {
@@ -333,6 +365,8 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 		mVU.prog.cleared = 0;
 		mVU.prog.isSame  = 1;
 		mVU.prog.cur     = mVUcreateProg(mVU, mVU.regs().start_pc/8);
+		if (mVU.prog.cur->hash)
+			mVUwarmStartProg(mVU);
 		void* entryPoint = mVUblockFetch(mVU,  startPC, pState);
 		quick.block      = mVU.prog.cur->block[startPC/8];
 		quick.prog       = mVU.prog.cur;
@@ -415,6 +449,8 @@ void recMicroVU0::Execute(u32 cycles)
 
 	if (!(VU0.VI[REG_VPU_STAT].UL & 1))
 		return;
+
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::VU0);
 	VU0.VI[REG_TPC].UL <<= 3;
 
 	((mVUrecCall)microVU0.startFunct)(VU0.VI[REG_TPC].UL, cycles);
@@ -442,6 +478,8 @@ void recMicroVU1::Execute(u32 cycles)
 		if (!(VU0.VI[REG_VPU_STAT].UL & 0x100))
 			return;
 	}
+
+	SubsystemProfiler::ScopedTimer timer(SubsystemProfiler::Subsystem::VU1);
 	VU1.VI[REG_TPC].UL <<= 3;
 	((mVUrecCall)microVU1.startFunct)(VU1.VI[REG_TPC].UL, cycles);
 	VU1.VI[REG_TPC].UL >>= 3;
@@ -35,6 +35,7 @@ using namespace x86Emitter;
 #include "microVU_Misc.h"
 #include "microVU_IR.h"
 #include "microVU_Profiler.h"
+#include "RecWarmStart.h"
 #include "common/Perf.h"
 
 struct microBlockLink
@@ -192,6 +193,7 @@ struct microProgram
 	std::deque<microRange>* ranges;          // The ranges of the microProgram that have already been recompiled
 	u32 startPC; // Start PC of this program
 	int idx;     // Program index
+	u64 hash;    // Hash of micro memory when the program was created (0 = warm start disabled)
 };
 
 typedef std::deque<microProgram*> microProgramList;
@@ -300,6 +302,7 @@ mVUop(mVUopL);
 // Private Functions
 extern void mVUcacheProg(microVU& mVU, microProgram& prog);
 extern void mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern void mVUwarmStartProg(microVU& mVU);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* mVUexecuteVU1(u32 startPC, u32 cycles);
@@ -703,6 +703,9 @@ void* mVUcompile(microVU& mVU, u32 startPC, uptr pState)
 	u8* thisPtr = x86Ptr;
 	const u32 endCount = (((microRegInfo*)pState)->blockType) ? 1 : (mVU.microMemSize / 8);
 
+	if (mVUcurProg.hash && RecWarmStart::IsEnabled())
+		RecWarmStart::RecordVUBlock(mVU.index, mVUcurProg.hash, startPC, (const void*)pState);
+
 	// First Pass
 	iPC = startPC / 4;
 	mVUsetupRange(mVU, startPC, 1); // Setup Program Bounds/Range
@@ -997,7 +1000,7 @@ void* mVUcompile(microVU& mVU, u32 startPC, uptr pState)
 
 perf_and_return:
 
-	Perf::vu.map((uptr)thisPtr, x86Ptr - thisPtr, startPC);
+	(mVU.index ? Perf::vu1 : Perf::vu0).map((uptr)thisPtr, x86Ptr - thisPtr, startPC);
 
 	return thisPtr;
 }
@@ -361,7 +361,7 @@ _vifT __fi nVifBlock* dVifCompile(nVifBlock& block, bool isFill)
 
 	VifUnpackSSE_Dynarec(v, block).CompileRoutine();
 
-	Perf::vif.map((uptr)v.recWritePtr, xGetPtr() - v.recWritePtr, block.upkType /* FIXME ideally a key*/);
+	Perf::vif.map((uptr)v.recWritePtr, xGetPtr() - v.recWritePtr, idx ? "VIF1" : "VIF0", (static_cast<u64>(block.key0) << 32) | block.key1);
 	v.recWritePtr = xGetPtr();
 
 	return &block;
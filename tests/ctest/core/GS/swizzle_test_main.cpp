@@ -27,6 +27,7 @@ enum class TestISA
 	isa_sse4,
 	isa_avx,
 	isa_avx2,
+	isa_avx512,
 	isa_native,
 };
 
@@ -37,6 +38,8 @@ static bool CheckCapabilities(TestISA required_caps)
 		return false;
 	if (required_caps == TestISA::isa_avx2 && !x86caps.hasAVX2)
 		return false;
+	if (required_caps == TestISA::isa_avx512 && !x86caps.hasAVX512)
+		return false;
 
 	return true;
 }